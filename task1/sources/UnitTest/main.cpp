@@ -14,8 +14,21 @@
  */
 int main(int argc, char **argv)
 {
+    // Memory manager is used by the pools of list units
+    Mem::MemMgr::init();
+
     // Run the example testing
     RUN_TEST( Task::uTest);
+    RUN_TEST( Task::uTestUnrolled);
+    RUN_TEST( Task::uTestCompact);
+    RUN_TEST( Task::uTestIndexed);
+    RUN_TEST( Task::uTestLru);
+    RUN_TEST( Task::uTestQueue);
+    RUN_TEST( Task::uTestPerf);
+    RUN_TEST( Task::uTestLruPerf);
+    RUN_TEST( Task::uTestQueuePerf);
+
+    Mem::MemMgr::deinit();
 
     cout.flush();
     cerr.flush();
@@ -0,0 +1,11 @@
+/**
+ * @file: mem_pool.cpp 
+ * Implementation of memory pool
+ */
+/*
+ * Copyright (C) 2012  Boris Shurygin
+ */
+#include "utils_iface.h"
+
+using namespace Mem;
+
@@ -18,7 +18,7 @@ namespace TestSingle
         /** private constructors, assignment and destructor */
         A(){};
         A( const A&){};
-        A& operator =( const A&){};
+        A& operator =( const A&){ return *this; };
         ~A(){};
         /** Needed for singleton creation */
         friend class Single< A>;
@@ -95,6 +95,13 @@ bool Utils::uTest()
     RUN_TEST( TestSingle::uTestSingle);
     /** Tets list classes */
     RUN_TEST( uTestList);
+    /** Test memory management */
+    RUN_TEST( uTestMem);
+    /** Test pool allocator */
+    RUN_TEST( uTestStdListAlloc);
+    RUN_TEST( uTestMemPoolListAlloc);
+    RUN_TEST( uTestMemPoolMapAlloc);
+
     /** Test logs */
     RUN_TEST_OUT_FILE_CHECK( uTestLogs, "log_utest.txt");
     return true;
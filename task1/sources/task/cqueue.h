@@ -0,0 +1,317 @@
+/**
+ * @file: task/cqueue.h
+ * Concurrent queue with lock-free multi-producer push_back
+ */
+#pragma once
+
+#ifndef TASK_CQUEUE_H
+#define TASK_CQUEUE_H
+
+#include <atomic>
+#include <mutex>
+
+namespace Task
+{
+    //
+    // Consumer modes of the concurrent queue
+    //
+    enum QueueMode
+    {
+        // Any number of producers, one consumer thread
+        QUEUE_MPSC,
+        // Any number of producers and consumers, consumers are serialized by a lock
+        QUEUE_MPMC
+    };
+
+    //
+    // Concurrent FIFO queue
+    // @param T type of the stored values
+    // @param mode QUEUE_MPSC or QUEUE_MPMC
+    //
+    // push_back is lock-free for any number of producer threads: a producer takes
+    // a node from the queue's node pool, swaps it into the tail with one atomic
+    // exchange and links the previous tail to it (Vyukov's MPSC queue). The consumer
+    // owns the head. In QUEUE_MPMC mode the consumers take a lock around pop_front
+    // while the producers stay lock-free.
+    //
+    // Note: pop_front can return false while a producer is between the tail exchange
+    // and the linking store, so "false" means "nothing ready yet", not "empty forever".
+    //
+    // Nodes are never returned to the system before the queue is destroyed. Popped nodes
+    // go to a lock-free free list and are reused by the producers. The free list is
+    // indexed, and its head keeps an update tag next to the index, so stale heads fail
+    // the compare-and-swap (ABA problem).
+    //
+    template <class T, QueueMode mode = QUEUE_MPSC> class CQueue
+    {
+    public:
+        CQueue(); //< Constructor
+        ~CQueue();//< Destructor, destroys the values left in the queue
+
+        void push_back (const T& val);                           // Insert value to back
+        void push_back (T&& val);                                // Insert value to back moving it
+        template <class... Args> void emplace_back (Args&&... args); // Construct value at back
+
+        bool pop_front( T& val); // Move the front value to val and remove it. Returns false if nothing was ready
+        bool empty() const;      // Check if there is no ready value. Only exact for the consumer thread,
+                                 // takes the consumer lock in QUEUE_MPMC mode
+
+    private:
+        //
+        // Queue node. The value is constructed in the node on push and is moved out
+        // and destroyed when the node becomes the queue's head on pop
+        //
+        struct Node
+        {
+            std::atomic<Node *> next;      // Link in the queue
+            std::atomic<UInt32> free_next; // Link in the free list
+            UInt32 index;                  // Own index in the pool
+            typename std::aligned_storage<sizeof( T), alignof( T)>::type storage;
+
+            T *value() { return reinterpret_cast<T *>( &storage); }
+        };
+
+        // The pool memory is made of chunks that double in size, chunk k holds FIRST_CHUNK_NODES << k nodes
+        static const UInt32 FIRST_CHUNK_NODES = 256;
+        static const UInt32 MAX_CHUNKS = 24;
+        static const UInt32 NO_NODE = ( UInt32)( -1);
+
+        // ---- The internal implementation routines ----
+        static inline UInt64 make_top( UInt32 index, UInt32 tag); // Pack free list head
+        static inline UInt32 top_index( UInt64 top);
+        static inline UInt32 top_tag( UInt64 top);
+
+        inline Node *node_at( UInt32 index) const; // Find node in chunks by its index
+        Node *allocate_node();                     // Pop node from free list, adds a chunk if it is empty
+        void free_node( Node *n);                  // Push node to free list
+        void push_node( Node *n);                  // Link node at tail
+        void add_chunk();                          // Allocate chunk and give its nodes to free list
+
+        // ---- Default copy constructor and assignment turned off ----
+        CQueue( const CQueue& q);
+        CQueue& operator = ( const CQueue& q);
+
+        // ---- The data involved in the implementation ----
+        Node *head;                         // Consumer side: the node before the front value
+        mutable std::mutex consumer_lock;   // Serializes consumers in QUEUE_MPMC mode
+        alignas( 64) std::atomic<Node *> tail; // Producer side, on its own cache line
+        alignas( 64) std::atomic<UInt64> free_top; // Free list head: node index and update tag
+        std::atomic<UInt32> num_chunks;
+        std::atomic<Node *> chunks[ MAX_CHUNKS];
+        std::mutex grow_lock;               // Serializes chunk allocation, taken only when free list is empty
+    };
+
+// ---- CQueue implementation ----
+
+    template <class T, QueueMode mode>
+    CQueue<T, mode>::CQueue():
+        num_chunks( 0)
+    {
+        free_top.store( make_top( NO_NODE, 0));
+        for ( UInt32 i = 0; i < MAX_CHUNKS; i++)
+        {
+            chunks[ i].store( NULL);
+        }
+
+        // The stub node that plays the head role of an empty queue
+        head = allocate_node();
+        head->next.store( NULL);
+        tail.store( head);
+    }
+
+    template <class T, QueueMode mode>
+    CQueue<T, mode>::~CQueue()
+    {
+        Node *n = head->next.load( std::memory_order_acquire);
+
+        while ( isNotNullP( n))
+        {
+            n->value()->~T();
+            n = n->next.load( std::memory_order_acquire);
+        }
+
+        for ( UInt32 k = 0; k < num_chunks.load(); k++)
+        {
+            ::operator delete( chunks[ k].load());
+        }
+    }
+
+    template <class T, QueueMode mode>
+    UInt64 CQueue<T, mode>::make_top( UInt32 index, UInt32 tag)
+    {
+        return ( ( UInt64)tag << 32) | index;
+    }
+
+    template <class T, QueueMode mode>
+    UInt32 CQueue<T, mode>::top_index( UInt64 top)
+    {
+        return ( UInt32)top;
+    }
+
+    template <class T, QueueMode mode>
+    UInt32 CQueue<T, mode>::top_tag( UInt64 top)
+    {
+        return ( UInt32)( top >> 32);
+    }
+
+    template <class T, QueueMode mode>
+    typename CQueue<T, mode>::Node *
+    CQueue<T, mode>::node_at( UInt32 index) const
+    {
+        // Chunk k starts at index FIRST_CHUNK_NODES * (2^k - 1)
+        UInt32 scaled = index / FIRST_CHUNK_NODES + 1;
+        UInt32 k = 0;
+#ifdef CC_GNU
+        k = 31 - __builtin_clz( scaled);
+#else
+        while ( scaled >> ( k + 1))
+            k++;
+#endif
+        UInt32 offset = index - FIRST_CHUNK_NODES * ( ( 1u << k) - 1);
+        return chunks[ k].load( std::memory_order_acquire) + offset;
+    }
+
+    template <class T, QueueMode mode>
+    void CQueue<T, mode>::add_chunk()
+    {
+        std::lock_guard<std::mutex> guard( grow_lock);
+
+        // Some other producer might have refilled the list while we waited
+        if ( top_index( free_top.load( std::memory_order_acquire)) != NO_NODE)
+            return;
+
+        UInt32 k = num_chunks.load( std::memory_order_relaxed);
+        if ( k == MAX_CHUNKS)
+            throw std::bad_alloc();
+
+        UInt32 num = FIRST_CHUNK_NODES << k;
+        UInt32 first_index = FIRST_CHUNK_NODES * ( ( 1u << k) - 1);
+        Node *chunk = static_cast<Node *>( ::operator new( sizeof( Node) * num));
+
+        // Link chunk nodes into a chain, then push the whole chain with one CAS
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            new ( &chunk[ i].next) std::atomic<Node *>( NULL);
+            new ( &chunk[ i].free_next) std::atomic<UInt32>( first_index + i + 1);
+            chunk[ i].index = first_index + i;
+        }
+        chunks[ k].store( chunk, std::memory_order_release);
+        num_chunks.store( k + 1, std::memory_order_release);
+
+        UInt64 top = free_top.load( std::memory_order_acquire);
+        do
+        {
+            chunk[ num - 1].free_next.store( top_index( top), std::memory_order_relaxed);
+        } while ( !free_top.compare_exchange_weak( top, make_top( first_index, top_tag( top) + 1),
+                                                   std::memory_order_acq_rel,
+                                                   std::memory_order_acquire));
+    }
+
+    template <class T, QueueMode mode>
+    typename CQueue<T, mode>::Node *
+    CQueue<T, mode>::allocate_node()
+    {
+        UInt64 top = free_top.load( std::memory_order_acquire);
+
+        FOREVER
+        {
+            if ( top_index( top) == NO_NODE)
+            {
+                add_chunk();
+                top = free_top.load( std::memory_order_acquire);
+                continue;
+            }
+            Node *n = node_at( top_index( top));
+            UInt32 next = n->free_next.load( std::memory_order_relaxed);
+
+            if ( free_top.compare_exchange_weak( top, make_top( next, top_tag( top) + 1),
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire))
+            {
+                return n;
+            }
+        }
+    }
+
+    template <class T, QueueMode mode>
+    void CQueue<T, mode>::free_node( Node *n)
+    {
+        UInt64 top = free_top.load( std::memory_order_acquire);
+        do
+        {
+            n->free_next.store( top_index( top), std::memory_order_relaxed);
+        } while ( !free_top.compare_exchange_weak( top, make_top( n->index, top_tag( top) + 1),
+                                                   std::memory_order_acq_rel,
+                                                   std::memory_order_acquire));
+    }
+
+    template <class T, QueueMode mode>
+    void CQueue<T, mode>::push_node( Node *n)
+    {
+        n->next.store( NULL, std::memory_order_relaxed);
+        Node *prev = tail.exchange( n, std::memory_order_acq_rel);
+        prev->next.store( n, std::memory_order_release);
+    }
+
+    template <class T, QueueMode mode>
+    void CQueue<T, mode>::push_back( const T& val)
+    {
+        emplace_back( val);
+    }
+
+    template <class T, QueueMode mode>
+    void CQueue<T, mode>::push_back( T&& val)
+    {
+        emplace_back( std::move( val));
+    }
+
+    template <class T, QueueMode mode>
+    template <class... Args>
+    void CQueue<T, mode>::emplace_back( Args&&... args)
+    {
+        Node *n = allocate_node();
+        try
+        {
+            new ( &n->storage) T( std::forward<Args>( args)...);
+        } catch ( ...)
+        {
+            free_node( n);
+            throw;
+        }
+        push_node( n);
+    }
+
+    template <class T, QueueMode mode>
+    bool CQueue<T, mode>::pop_front( T& val)
+    {
+        std::unique_lock<std::mutex> guard( consumer_lock, std::defer_lock);
+        if ( mode == QUEUE_MPMC)
+            guard.lock();
+
+        Node *next = head->next.load( std::memory_order_acquire);
+        if ( isNullP( next))
+            return false;
+
+        // The next node becomes the stub, its value is taken out
+        val = std::move( *next->value());
+        next->value()->~T();
+
+        Node *old_head = head;
+        head = next;
+        free_node( old_head);
+        return true;
+    }
+
+    template <class T, QueueMode mode>
+    bool CQueue<T, mode>::empty() const
+    {
+        // Other consumers move the head under the lock in QUEUE_MPMC mode
+        std::unique_lock<std::mutex> guard( consumer_lock, std::defer_lock);
+        if ( mode == QUEUE_MPMC)
+            guard.lock();
+
+        return isNullP( head->next.load( std::memory_order_acquire));
+    }
+};
+
+#endif /* TASK_CQUEUE_H */
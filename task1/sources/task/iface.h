@@ -2,10 +2,14 @@
  * @file: task/iface.h
  * Interface of a programming task
  */
-//#include "iface.h"
+#pragma once
+
+#include "../Utils/utils_iface.h"
+#include <type_traits>
+#include <cstring>
 
 /* namespaces import */
-//using namespace Utils;
+using namespace Utils;
 
 //Debug assert with diagnostic info
 #if !defined(DLIST_ASSERTXD)
@@ -17,6 +21,12 @@
 #    define DLIST_ASSERTD(cond) ASSERT_XD(cond, "DList", "")
 #endif
 
+// Allocation policies for list units
+#include "list_alloc.h"
+
+// Snapshot file format
+#include "list_file.h"
+
 /**
  * Namespace for the programming task
  */
@@ -24,8 +34,23 @@ namespace Task
 {
     //
     // Doubly connected list
+    // @param T type of the stored values
+    // @param AllocPolicy policy that provides memory for the list units,
+    //        UnitPool (chunked pool, default) or UnitHeap (plain operator new)
+    //
+    // reverse() itself only flips the direction of the unit links that leads from the
+    // first unit to the last one. Iterators, for_each() and the other walks follow
+    // the direction as is. Calls that give out a unit or change the links (first(), last(),
+    // insert(), emplace(), erase(), iterator::unit()) relink all units to the list order
+    // first, so reverse() followed by any of them costs O(n) once. Reversing the list back
+    // before that costs nothing. merge() and splicing between lists of different directions
+    // relink the units to one direction as well.
+    //
+    // Const access never relinks: const_iterator::unit() gives the unit as it is linked,
+    // and after reverse() its next()/prev() run against the list order until a non-const
+    // call above relinks the units. Step a const_iterator to walk a const list instead.
     //
-    template <class T> class DList
+    template <class T, template <class U> class AllocPolicy = UnitPool> class DList
     {
     public:
         //
@@ -42,44 +67,194 @@ namespace Task
             T& val();     // Get the reference to the unit's value
         private:
         // ---- Implementation routines ----
-        Unit();//constructor
-        void glue(Unit *u); //
+        template <class... Args> Unit( Args&&... args);//constructor, builds the value from args in place
         // ---- Data involved in the implementation ----
         T unit_value;
         Unit *unit_prev;
         Unit *unit_next;
         };
 
+        //
+        // Bidirectional iterator over the list values, V is T or const T.
+        // The end iterator can be decremented to the last unit. Iterators follow
+        // the list direction and stay valid over reverse()
+        //
+        template <class V> class Iter
+        {
+            friend class DList;
+            template <class W> friend class Iter;
+
+        public:
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef V* pointer;
+            typedef V& reference;
+
+            Iter(): cur( NULL), list( NULL){}
+            Iter( const Iter<T>& it): cur( it.cur), list( it.list){} // Also converts iterator to const_iterator
+
+            V& operator *() const { return cur->unit_value; }
+            V* operator ->() const { return &cur->unit_value; }
+            Iter& operator ++();
+            Iter& operator --();
+            Iter operator ++( int) { Iter it( *this); ++*this; return it; }
+            Iter operator --( int) { Iter it( *this); --*this; return it; }
+            bool operator ==( const Iter& it) const { return areEqP( cur, it.cur); }
+            bool operator !=( const Iter& it) const { return areNotEqP( cur, it.cur); }
+
+            Unit *unit() const; // Get the unit, null for the end iterator. See the class comment on next()/prev()
+        private:
+            // Only iterators over mutable values may relink the units of their list
+            typedef typename std::conditional<std::is_const<V>::value, const DList, DList>::type Owner;
+
+            Iter( Unit* u, Owner* l): cur( u), list( l){}
+
+            static void orient_units( DList *l) { if ( isNotNullP( l)) l->orient( LIST_DIR_DEFAULT); }
+            static void orient_units( const DList *) {}
+
+            Unit *cur;
+            Owner *list;
+        };
+
+        typedef Iter<T> iterator;
+        typedef Iter<const T> const_iterator;
+
+        typedef AllocPolicy<Unit> Allocator; // Unit memory provider
+
         // ---- Public interface of DList ----
         DList(); //< Constructor
+        explicit DList( const Allocator& alloc); //< Constructor that shares the unit memory with alloc
+        DList( DList&& list); //< Move constructor, takes the units of the given list
         ~DList();//< Destructor
 
+        DList& operator = ( DList&& list); // Move assignment, takes the units of the given list
+
         void push_front (const T& val);// Insert one unit with given value at front
+        void push_front (T&& val);     // Insert one unit at front moving the value into it
         void pop_front();// Remove one unit at front of the list
         void push_back (const T& val);        // Insert one unit with given value to back
+        void push_back (T&& val);             // Insert one unit to back moving the value into it
         void pop_back();                      // Remove one unit from the back of the list
         Unit* insert (Unit* u, const T& val); // Insert one unit before the given one
+        Unit* insert (Unit* u, T&& val);      // Insert one unit before the given one moving the value into it
+
+        // Construct the value in place from the given constructor arguments
+        template <class... Args> void emplace_front (Args&&... args); // Insert at front
+        template <class... Args> void emplace_back (Args&&... args);  // Insert to back
+        template <class... Args> Unit* emplace (Unit* u, Args&&... args); // Insert before the given unit
 
         Unit* first(); // Get first unit
         Unit* last();  // Get last unit
 
         Unit* erase (Unit* u); // Remove given unit from list, return next unit or null
-        void clear();          // Remove all units
+        Unit* erase (Unit* first, Unit* last); // Remove units [first, last), null last means the end. Returns last
+        void clear();          // Remove all units in one pass, pool chunks are released at once if not shared
         bool empty();          // Check if list is empty. Returns true if empty, false otherwise
         unsigned size();       // Get the number of units in the list
-        void reverse();        // Reverse the order of units in the list
+        void reverse();        // Reverse the order of units in the list, constant time
+
+        iterator begin();             // Iterator at the first value
+        iterator end();               // Iterator past the last value
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        // Algorithms that walk the units in one pass without building iterators
+        template <class F> F for_each( F f);              // Call f( val) for every value, return f
+        template <class Pred> iterator find_if( Pred p);  // Find the first value that satisfies p, end() if none
+        template <class Pred> unsigned count_if( Pred p); // Count the values that satisfy p
+        template <class Pred> unsigned remove_if( Pred p);// Erase the values that satisfy p, return their number
+        unsigned unique();                                // Erase values equal to the previous one, return their number
+        template <class Pred> unsigned unique( Pred eq);  // Same with the given equality predicate
+
+        // Binary snapshot. Trivially copyable values are saved as raw bytes and loaded from
+        // the memory mapped file, values of other types are written by ListSerializer<T>
+        bool save( const char *path); // Write the values to the file, returns false on I/O error
+        bool load( const char *path); // Replace the values with the ones from the file. Returns false and
+                                      // keeps the list unchanged if the file can't be read or doesn't match T
+
+        // Move units from another list. Units are always relinked without allocation: lists
+        // with different unit memories join them first, see UnitPool
+        void splice( Unit* pos, DList& list);  // Move all units of list before pos (to back if pos is null)
+        void splice( Unit* pos, DList& list,   // Move units [first, last) of list before pos,
+                     Unit* first, Unit* last); // null last means the end of list
+        void append( DList&& list);            // Move all units of list to back
+
+        // Stable in-place merge sort that only relinks units, O(n log n) without allocation
+        void sort();                                      // Sort by operator <
+        template <class Compare> void sort( Compare cmp); // Sort by the given "less" predicate
+
+        // Merge sorted list into this sorted list, units of equal values from this list go first
+        void merge( DList& list);
+        template <class Compare> void merge( DList& list, Compare cmp);
+
+        const Allocator& allocator() const; // Get the unit memory provider
 private:
         // ---- The internal implementation routines ----
+        template <class... Args> Unit* create_unit( Args&&... args); // Allocate and construct a detached unit
+        void destroy_unit( Unit* u);      // Destruct the unit and release its memory
+        void link_before( Unit* u, Unit* pos); // Link detached unit before pos (at back if pos is null)
+        void unlink( Unit* u);                 // Detach unit from its neighbours
+        void relink( Unit* pos, DList& list,   // Relink the run [first, last] of list units of length num
+                     Unit* first, Unit* last, unsigned num); // before pos
+        void cut( Unit* first, Unit* last, unsigned num); // Detach the run [first, last] of num units
+        Unit* destroy_chain( Unit* first, void* rest); // Destroy detached units chained in the list direction,
+                                                       // link them through the first words, return the last one
+        void release_chain( Unit* first);      // Destroy detached units, free them with one call
+        template <class Pred> unsigned remove_runs( Pred p); // Cut out and release runs of units that satisfy p( unit)
+        template <class Compare> static Unit*       // Merge two null-terminated chains linked by
+        merge_chains( Unit* a, Unit* b, Compare& cmp); // unit_next, return the head of the result
+        void restore_prev_links();             // Recompute prev links and tail from the next links
+        template <class Compare> void sort_links( Compare& cmp); // Sort the units in the order of the links
+        void orient( ListDir d);               // Relink units so that direction d leads from the first unit to the last
+        template <class Visit> Unit* visit( Visit v); // Call v( unit) in list order until it returns true,
+                                                      // return that unit
+        bool save_values( std::ostream& os, std::true_type); // Write values after the file header, as raw bytes
+        bool save_values( std::ostream& os, std::false_type);
+        bool load_values( const char *path, DList& loaded, std::true_type); // Read snapshot into loaded, mapped
+        bool load_values( const char *path, DList& loaded, std::false_type);
+        static bool check_header( const ListFileHeader& header, bool raw); // Check that the file matches T
+        Unit*& end_in_dir( ListDir d);         // The outermost unit in direction d
+        static Unit*& peer( Unit* u, ListDir d); // The neighbour link of the unit in direction d
+
+        // ---- Default copy constructor and assignment turned off ----
+        DList( const DList& list);
+        DList& operator = ( const DList& list);
 
         // ---- The data involved in the implementation ----
         Unit *head;
         Unit *tail;
-        int size_of_list;
+        ListDir dir; // Direction of the unit links that leads from the first unit to the last one
+        unsigned size_of_list;
+        Allocator alloc;
     };
 
-//    bool uTest( UnitTest *utest_p);
+    bool uTest( UnitTest *utest_p);         // DList unit testing
+    bool uTestUnrolled( UnitTest *utest_p); // UDList unit testing
+    bool uTestCompact( UnitTest *utest_p);  // IDList unit testing
+    bool uTestIndexed( UnitTest *utest_p);  // ODList unit testing
+    bool uTestLru( UnitTest *utest_p);      // LruCache unit testing
+    bool uTestQueue( UnitTest *utest_p);    // CQueue unit testing
+    bool uTestQueuePerf( UnitTest *utest_p);// CQueue throughput measurement
+    bool uTestPerf( UnitTest *utest_p);     // DList performance measurement against std::list
+    bool uTestLruPerf( UnitTest *utest_p);  // LruCache measurement under Zipf-distributed keys
 };
 
 // Since we have defined list as a template - we should implement the solution in a header
 // But to keep interface clean we've separated the implementation into list_impl.h header
 #include "list_impl.h"
+
+// Unrolled variant of the list
+#include "ulist.h"
+
+// Compact index-linked variant of the list
+#include "ilist.h"
+
+// List with positional access
+#include "olist.h"
+
+// LRU cache on top of DList
+#include "lru_cache.h"
+
+// Concurrent queue
+#include "cqueue.h"
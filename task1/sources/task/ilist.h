@@ -0,0 +1,441 @@
+/**
+ * @file: task/ilist.h
+ * Compact doubly connected list with 32-bit links inside of one contiguous arena
+ */
+#pragma once
+
+#ifndef TASK_ILIST_H
+#define TASK_ILIST_H
+
+namespace Task
+{
+    //
+    // Index-linked doubly connected list
+    // @param T type of the stored values
+    //
+    // All units live in one growable array (the arena). Instead of two pointers a unit
+    // keeps two 32-bit offsets to its neighbours, counted in units relative to itself,
+    // which halves the link overhead of DList on 64-bit hosts. Relative offsets stay
+    // valid when the arena is moved, so Unit::next() and Unit::prev() don't need the list.
+    //
+    // When the arena grows the units are moved to the new array in the list order,
+    // so that walking the list after that touches memory sequentially.
+    //
+    // Note: as with std::vector, growing the arena moves the units. Unit pointers are
+    // invalidated by inserts that exceed the capacity; use reserve() to avoid that.
+    //
+    template <class T> class IDList
+    {
+    public:
+        //
+        // List unit
+        //
+        class Unit
+        {
+            friend class IDList;
+
+        public:
+            Unit *next(); // Get the next unit in list
+            Unit *prev(); // Get the previous unit in list
+            T& val();     // Get the reference to the unit's value
+        private:
+            template <class... Args> Unit( Args&&... args);//constructor, builds the value from args in place
+
+            Int32 unit_prev; // Offset to the previous unit, 0 if there is none
+            Int32 unit_next; // Offset to the next unit, 0 if there is none
+            T unit_value;
+        };
+
+        // ---- Public interface of IDList ----
+        IDList(); //< Constructor
+        ~IDList();//< Destructor
+
+        void push_front (const T& val);// Insert one unit with given value at front
+        void push_front (T&& val);     // Insert one unit at front moving the value into it
+        void pop_front();// Remove one unit at front of the list
+        void push_back (const T& val);        // Insert one unit with given value to back
+        void push_back (T&& val);             // Insert one unit to back moving the value into it
+        void pop_back();                      // Remove one unit from the back of the list
+        Unit* insert (Unit* u, const T& val); // Insert one unit before the given one
+        Unit* insert (Unit* u, T&& val);      // Insert one unit before the given one moving the value into it
+
+        // Construct the value in place from the given constructor arguments
+        template <class... Args> void emplace_front (Args&&... args); // Insert at front
+        template <class... Args> void emplace_back (Args&&... args);  // Insert to back
+        template <class... Args> Unit* emplace (Unit* u, Args&&... args); // Insert before the given unit
+
+        Unit* first(); // Get first unit
+        Unit* last();  // Get last unit
+
+        Unit* erase (Unit* u); // Remove given unit from list, return next unit or null
+        void clear();          // Remove all units
+        bool empty();          // Check if list is empty. Returns true if empty, false otherwise
+        unsigned size();       // Get the number of units in the list
+        void reverse();        // Reverse the order of units in the list
+
+        void reserve( UInt32 num); // Make room for num units, units are moved if the arena grows
+        UInt32 capacity();         // Get the number of units that fit into the arena
+    private:
+        static const UInt32 NO_UNIT = ( UInt32)( -1);
+        static const UInt32 MIN_CAPACITY = 16;
+        static const UInt32 MAX_CAPACITY = 0x7fffffff; // Offsets must fit Int32
+
+        // ---- The internal implementation routines ----
+        inline Unit *unit_at( UInt32 i);       // Get unit by its arena index
+        inline UInt32 index_of( Unit *u);      // Get arena index of the unit
+        inline UInt32 &free_link( UInt32 i);   // Free list link kept in a free slot
+        static inline void link( Unit *u, Unit *next); // Make next follow u, any of them may be null
+
+        UInt32 take_slot( UInt32 *keep);                // Get a free slot, keep is updated if the arena moves
+        template <class... Args> Unit* create_unit_before( UInt32 pos, Args&&... args); // Construct and link before pos
+        void grow( UInt32 new_capacity, UInt32 *keep); // Move the units to a bigger arena in the list order
+
+        // ---- Default copy constructor and assignment turned off ----
+        IDList( const IDList& list);
+        IDList& operator = ( const IDList& list);
+
+        // ---- The data involved in the implementation ----
+        Unit *arena;
+        UInt32 arena_capacity;
+        UInt32 arena_top;  // Slots above it were never used
+        UInt32 free_head;  // Freed slots list
+        UInt32 head;
+        UInt32 tail;
+        unsigned size_of_list;
+    };
+
+// ---- IDList::Unit implementation ----
+
+    template <class T>
+    template <class... Args>
+    IDList<T>::Unit::Unit( Args&&... args):
+        unit_prev( 0),
+        unit_next( 0),
+        unit_value( std::forward<Args>( args)...)
+    {
+    }
+
+    template <class T>
+    typename IDList<T>::Unit *
+    IDList<T>::Unit::next()
+    {
+        return unit_next != 0 ? this + unit_next : NULL;
+    }
+
+    template <class T>
+    typename IDList<T>::Unit *
+    IDList<T>::Unit::prev()
+    {
+        return unit_prev != 0 ? this + unit_prev : NULL;
+    }
+
+    template <class T>
+    T& IDList<T>::Unit::val()
+    {
+        return unit_value;
+    }
+
+// ---- IDList implementation ----
+
+    template <class T>
+    IDList<T>::IDList():
+        arena( NULL),
+        arena_capacity( 0),
+        arena_top( 0),
+        free_head( NO_UNIT),
+        head( NO_UNIT),
+        tail( NO_UNIT),
+        size_of_list( 0)
+    {
+    }
+
+    template <class T>
+    IDList<T>::~IDList()
+    {
+        clear();
+        ::operator delete( arena);
+    }
+
+    template <class T>
+    typename IDList<T>::Unit *
+    IDList<T>::unit_at( UInt32 i)
+    {
+        return i != NO_UNIT ? arena + i : NULL;
+    }
+
+    template <class T>
+    UInt32 IDList<T>::index_of( Unit *u)
+    {
+        return isNotNullP( u) ? ( UInt32)( u - arena) : NO_UNIT;
+    }
+
+    template <class T>
+    UInt32 & IDList<T>::free_link( UInt32 i)
+    {
+        return *reinterpret_cast<UInt32 *>( arena + i);
+    }
+
+    template <class T>
+    void IDList<T>::link( Unit *u, Unit *next)
+    {
+        if ( isNotNullP( u))
+            u->unit_next = isNotNullP( next) ? ( Int32)( next - u) : 0;
+        if ( isNotNullP( next))
+            next->unit_prev = isNotNullP( u) ? ( Int32)( u - next) : 0;
+    }
+
+    template <class T>
+    void IDList<T>::grow( UInt32 new_capacity, UInt32 *keep)
+    {
+        DLIST_ASSERTXD( new_capacity <= MAX_CAPACITY, "Too many units for 32-bit links");
+
+        Unit *new_arena = static_cast<Unit *>( ::operator new( sizeof( Unit) * ( size_t)new_capacity));
+        UInt32 k = 0;
+        UInt32 kept = NO_UNIT;
+
+        // Move units in the list order, so that they become sequential in memory
+        for ( Unit *u = unit_at( head); isNotNullP( u); k++)
+        {
+            Unit *next = u->next();
+            Unit *moved = new ( new_arena + k) Unit( std::move( u->unit_value));
+
+            if ( isNotNullP( keep) && *keep == index_of( u))
+                kept = k;
+
+            moved->unit_prev = k > 0 ? -1 : 0;
+            moved->unit_next = isNotNullP( next) ? 1 : 0;
+            u->~Unit();
+            u = next;
+        }
+        ::operator delete( arena);
+
+        if ( isNotNullP( keep))
+            *keep = kept;
+        arena = new_arena;
+        arena_capacity = new_capacity;
+        arena_top = k;
+        free_head = NO_UNIT;
+        head = k > 0 ? 0 : NO_UNIT;
+        tail = k > 0 ? k - 1 : NO_UNIT;
+    }
+
+    template <class T>
+    void IDList<T>::reserve( UInt32 num)
+    {
+        if ( num > arena_capacity)
+            grow( num, NULL);
+    }
+
+    template <class T>
+    UInt32 IDList<T>::capacity()
+    {
+        return arena_capacity;
+    }
+
+    template <class T>
+    UInt32 IDList<T>::take_slot( UInt32 *keep)
+    {
+        if ( free_head != NO_UNIT)
+        {
+            UInt32 i = free_head;
+            free_head = free_link( i);
+            return i;
+        }
+        if ( arena_top == arena_capacity)
+        {
+            UInt32 new_capacity = arena_capacity < MIN_CAPACITY ? MIN_CAPACITY
+                                  : ( arena_capacity > MAX_CAPACITY / 2 ? MAX_CAPACITY : arena_capacity * 2);
+            if ( new_capacity == arena_capacity)
+                throw std::bad_alloc();
+            grow( new_capacity, keep);
+        }
+        return arena_top++;
+    }
+
+    template <class T>
+    template <class... Args>
+    typename IDList<T>::Unit *
+    IDList<T>::create_unit_before( UInt32 pos, Args&&... args)
+    {
+        UInt32 i = take_slot( &pos);
+        Unit *u = NULL;
+        try
+        {
+            u = new ( arena + i) Unit( std::forward<Args>( args)...);
+        } catch ( ...)
+        {
+            free_link( i) = free_head;
+            free_head = i;
+            throw;
+        }
+        Unit *next = unit_at( pos);
+        Unit *prev = isNotNullP( next) ? next->prev() : unit_at( tail);
+
+        link( prev, u);
+        link( u, next);
+
+        if ( isNullP( prev))
+            head = i;
+        if ( isNullP( next))
+            tail = i;
+
+        size_of_list++;
+        return u;
+    }
+
+    template <class T>
+    void IDList<T>::push_front( const T& val)
+    {
+        create_unit_before( head, val);
+    }
+
+    template <class T>
+    void IDList<T>::push_front( T&& val)
+    {
+        create_unit_before( head, std::move( val));
+    }
+
+    template <class T>
+    template <class... Args>
+    void IDList<T>::emplace_front( Args&&... args)
+    {
+        create_unit_before( head, std::forward<Args>( args)...);
+    }
+
+    template <class T>
+    void IDList<T>::pop_front()
+    {
+        if ( size_of_list > 0)
+            erase( first());
+    }
+
+    template <class T>
+    void IDList<T>::push_back( const T& val)
+    {
+        create_unit_before( NO_UNIT, val);
+    }
+
+    template <class T>
+    void IDList<T>::push_back( T&& val)
+    {
+        create_unit_before( NO_UNIT, std::move( val));
+    }
+
+    template <class T>
+    template <class... Args>
+    void IDList<T>::emplace_back( Args&&... args)
+    {
+        create_unit_before( NO_UNIT, std::forward<Args>( args)...);
+    }
+
+    template <class T>
+    void IDList<T>::pop_back()
+    {
+        if ( size_of_list > 0)
+            erase( last());
+    }
+
+    template <class T>
+    typename IDList<T>::Unit *
+    IDList<T>::insert( Unit* u, const T& val)
+    {
+        return create_unit_before( index_of( u), val);
+    }
+
+    template <class T>
+    typename IDList<T>::Unit *
+    IDList<T>::insert( Unit* u, T&& val)
+    {
+        return create_unit_before( index_of( u), std::move( val));
+    }
+
+    template <class T>
+    template <class... Args>
+    typename IDList<T>::Unit *
+    IDList<T>::emplace( Unit* u, Args&&... args)
+    {
+        return create_unit_before( index_of( u), std::forward<Args>( args)...);
+    }
+
+    template <class T>
+    typename IDList<T>::Unit *
+    IDList<T>::first()
+    {
+        return unit_at( head);
+    }
+
+    template <class T>
+    typename IDList<T>::Unit *
+    IDList<T>::last()
+    {
+        return unit_at( tail);
+    }
+
+    template <class T>
+    typename IDList<T>::Unit *
+    IDList<T>::erase( Unit* u)
+    {
+        DLIST_ASSERTXD( isNotNullP( u), "Erasing null unit");
+
+        Unit *prev = u->prev();
+        Unit *next = u->next();
+
+        link( prev, next);
+        if ( isNullP( prev))
+            head = index_of( next);
+        if ( isNullP( next))
+            tail = index_of( prev);
+
+        UInt32 i = index_of( u);
+        u->~Unit();
+        free_link( i) = free_head;
+        free_head = i;
+        size_of_list--;
+        return next;
+    }
+
+    template <class T>
+    void IDList<T>::clear()
+    {
+        if ( !std::is_trivially_destructible<T>::value)
+        {
+            for ( Unit *u = first(); isNotNullP( u); )
+            {
+                Unit *next = u->next();
+                u->~Unit();
+                u = next;
+            }
+        }
+        arena_top = 0;
+        free_head = NO_UNIT;
+        head = NO_UNIT;
+        tail = NO_UNIT;
+        size_of_list = 0;
+    }
+
+    template <class T>
+    bool IDList<T>::empty()
+    {
+        return size_of_list == 0;
+    }
+
+    template <class T>
+    unsigned IDList<T>::size()
+    {
+        return size_of_list;
+    }
+
+    template <class T>
+    void IDList<T>::reverse()
+    {
+        for ( Unit *u = first(); isNotNullP( u); )
+        {
+            Unit *next = u->next();
+            std::swap( u->unit_prev, u->unit_next);
+            u = next;
+        }
+        std::swap( head, tail);
+    }
+};
+
+#endif /* TASK_ILIST_H */
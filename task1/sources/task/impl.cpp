@@ -1,5 +1,7 @@
 #include "iface.h"
 #include "list_impl.h"
+#include <memory>
+#include <thread>
 
 // Implementation of the task's unit testing
 namespace Task
@@ -7,6 +9,19 @@ namespace Task
     typedef DList<int> List;
     typedef DList<int>::Unit Unit;
 
+    // Value that counts its copies
+    struct CopyCounter
+    {
+        static int copies;
+        std::string payload;
+
+        CopyCounter( const char *str, int n): payload( n, str[ 0]){}
+        CopyCounter( const std::string& str): payload( str){}
+        CopyCounter( const CopyCounter& c): payload( c.payload){ copies++; }
+        CopyCounter( CopyCounter&& c): payload( std::move( c.payload)){}
+    };
+    int CopyCounter::copies = 0;
+
     bool uTest( UnitTest *utest_p)
     {
         DList<int> list;
@@ -63,7 +78,914 @@ namespace Task
         UTEST_CHECK( utest_p, list.first()->next()->next()->val() == 30);
         
         UTEST_CHECK( utest_p, list.last()->val() == 40);
-    
+
+        //--- Test end operations of a reversed list before the units are relinked
+        List r;
+        for ( int i = 0; i < 5; i++)
+        {
+            r.push_back( i);  // r: 0 1 2 3 4
+        }
+        r.reverse();          // r: 4 3 2 1 0
+        r.push_front( 5);     // r: 5 4 3 2 1 0
+        r.emplace_back( -1);  // r: 5 4 3 2 1 0 -1
+        r.pop_front();        // r: 4 3 2 1 0 -1
+        r.reverse();
+        r.reverse();          // reversing back doesn't touch units
+
+        int expected = 4;
+        bool ordered = true;
+        for ( List::Unit *e = r.first(); isNotNullP( e); e = e->next())
+        {
+            ordered = ordered && e->val() == expected--;
+        }
+        UTEST_CHECK( utest_p, ordered && expected == -2);
+        UTEST_CHECK( utest_p, r.size() == 6);
+
+        r.reverse();          // r: -1 0 1 2 3 4
+        r.pop_back();         // r: -1 0 1 2 3
+        UTEST_CHECK( utest_p, r.first()->val() == -1);
+        UTEST_CHECK( utest_p, r.first()->next()->val() == 0);
+        UTEST_CHECK( utest_p, r.last()->val() == 3);
+        UTEST_CHECK( utest_p, r.last()->prev()->val() == 2);
+
+        r.reverse();          // r: 3 2 1 0 -1
+        r.sort();
+        UTEST_CHECK( utest_p, r.first()->val() == -1 && r.last()->val() == 3);
+        UTEST_CHECK( utest_p, r.first()->next()->val() == 0 && r.last()->prev()->val() == 2);
+
+        //--- Test inner operations of a reversed list
+        List fwd;
+        List rev;
+        for ( int i = 0; i < 4; i++)
+        {
+            fwd.push_back( i);     // fwd: 0 1 2 3
+            rev.push_front( i + 4);
+        }
+        rev.reverse();             // rev: 4 5 6 7
+        Unit *five = rev.first()->next();
+        rev.insert( five, 10);     // rev: 4 10 5 6 7
+        UTEST_CHECK( utest_p, five->prev()->val() == 10 && rev.erase( five)->val() == 6); // rev: 4 10 6 7
+        UTEST_CHECK( utest_p, rev.erase( rev.first()->next(), rev.last())->val() == 7);  // rev: 4 7
+
+        fwd.splice( fwd.last(), rev, rev.first(), rev.last()); // fwd: 0 1 2 4 3, rev: 7
+        fwd.splice( fwd.first(), rev);                          // fwd: 7 0 1 2 4 3
+        int spliced[] = { 7, 0, 1, 2, 4, 3};
+        UTEST_CHECK( utest_p, std::equal( fwd.begin(), fwd.end(), spliced) && fwd.size() == 6 && rev.empty());
+        UTEST_CHECK( utest_p, fwd.last()->prev()->val() == 4 && fwd.first()->prev() == 0);
+
+        List small;
+        small.push_back( 100);
+        fwd.reverse();        // fwd: 3 4 2 1 0 7
+        small.splice( 0, fwd); // small takes the direction of the bigger list: 100 3 4 2 1 0 7
+        int joined[] = { 100, 3, 4, 2, 1, 0, 7};
+        UTEST_CHECK( utest_p, std::equal( small.begin(), small.end(), joined) && small.size() == 7 && fwd.empty());
+        UTEST_CHECK( utest_p, small.first()->next()->val() == 3 && small.last()->prev()->val() == 0);
+
+        // A unit taken from an iterator of a reversed list walks in the list order
+        small.reverse();      // small: 7 0 1 2 4 3 100
+        List::iterator seven = small.begin();
+        UTEST_CHECK( utest_p, seven.unit()->next()->val() == 0 && *++seven == 0);
+
+        // Stable sort of a reversed list keeps equal values in the list order
+        typedef DList<std::pair<int, int> > PairList;
+        PairList keyed;
+        for ( int i = 0; i < 10; i++)
+        {
+            keyed.push_front( std::make_pair( i % 3, i)); // keys of 9 8 ... 0
+        }
+        keyed.reverse();                                  // keys of 0 1 ... 9
+        keyed.sort( []( const std::pair<int, int>& a, const std::pair<int, int>& b){ return a.first < b.first; });
+        bool stable = true;
+        for ( PairList::iterator it = keyed.begin(), next = std::next( it); next != keyed.end(); ++it, ++next)
+        {
+            stable = stable && ( it->first < next->first || ( it->first == next->first && it->second < next->second));
+        }
+        UTEST_CHECK( utest_p, stable && keyed.first()->val().second == 0 && keyed.last()->val().second == 8);
+
+        //--- Test iterators and algorithms
+        List it_list;
+        for ( int i = 0; i < 10; i++)
+        {
+            it_list.push_back( i); // it_list: 0 1 ... 9
+        }
+        sum = 0;
+        for ( int v : it_list)
+        {
+            sum += v;
+        }
+        UTEST_CHECK( utest_p, sum == 45);
+        UTEST_CHECK( utest_p, *std::find( it_list.begin(), it_list.end(), 7) == 7);
+        UTEST_CHECK( utest_p, std::count_if( it_list.begin(), it_list.end(), []( int v){ return v % 2 == 0; }) == 5);
+        UTEST_CHECK( utest_p, *--it_list.end() == 9);
+        UTEST_CHECK( utest_p, std::distance( it_list.begin(), it_list.end()) == 10);
+
+        const List& const_list = it_list;
+        List::const_iterator cit = const_list.begin();
+        ++cit;
+        UTEST_CHECK( utest_p, *cit++ == 1 && *cit == 2);
+        UTEST_CHECK( utest_p, cit != const_list.end() && cit.unit()->val() == 2);
+
+        it_list.reverse(); // iterators follow the direction: 9 8 ... 0
+        UTEST_CHECK( utest_p, *it_list.begin() == 9 && *std::prev( it_list.end()) == 0);
+        int backwards[] = { 9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+        UTEST_CHECK( utest_p, std::equal( it_list.begin(), it_list.end(), backwards));
+        UTEST_CHECK( utest_p, *const_list.begin() == 9 && isNullP( const_list.begin().unit()->next())); // const access doesn't relink
+
+        int first_seen = -1;
+        it_list.for_each( [&first_seen]( int& v){ if ( first_seen < 0) first_seen = v; v = -v; });
+        UTEST_CHECK( utest_p, first_seen == 9 && *it_list.begin() == -9);
+        UTEST_CHECK( utest_p, it_list.find_if( []( int v){ return v == -3; }).unit() == std::next( it_list.begin(), 6).unit());
+        UTEST_CHECK( utest_p, it_list.find_if( []( int v){ return v > 0; }) == it_list.end());
+        UTEST_CHECK( utest_p, it_list.count_if( []( int v){ return v < -4; }) == 5);
+
+        it_list.reverse(); // -0 -1 ... -9
+        UTEST_CHECK( utest_p, it_list.remove_if( []( int v){ return v % 2 != 0; }) == 5);
+        expected = 0;
+        ordered = true;
+        for ( List::iterator it = it_list.begin(); it != it_list.end(); ++it)
+        {
+            ordered = ordered && *it == -expected;
+            expected += 2;
+        }
+        UTEST_CHECK( utest_p, ordered && it_list.size() == 5);
+
+        //--- Test range erase and unique
+        List runs;
+        for ( int i = 0; i < 20; i++)
+        {
+            runs.push_back( i / 4); // runs: 0 0 0 0 1 1 1 1 ... 4 4 4 4
+        }
+        UTEST_CHECK( utest_p, runs.unique() == 15);
+        UTEST_CHECK( utest_p, runs.size() == 5 && runs.first()->val() == 0 && runs.last()->val() == 4);
+        UTEST_CHECK( utest_p, runs.unique() == 0);
+
+        Unit *second = runs.first()->next();
+        UTEST_CHECK( utest_p, runs.erase( second, second->next()->next())->val() == 3); // runs: 0 3 4
+        UTEST_CHECK( utest_p, runs.size() == 3 && runs.first()->next()->val() == 3);
+        UTEST_CHECK( utest_p, runs.erase( runs.last(), 0) == 0);                        // runs: 0 3
+        UTEST_CHECK( utest_p, runs.last()->val() == 3 && runs.last()->prev() == runs.first());
+        UTEST_CHECK( utest_p, runs.erase( runs.first(), runs.first()) == runs.first());
+
+        runs.push_back( 4);
+        runs.push_back( 5);
+        runs.reverse(); // runs: 5 4 3 0, unique by a predicate sees the list order
+        UTEST_CHECK( utest_p, runs.unique( []( int a, int b){ return a == b + 1; }) == 1);
+        UTEST_CHECK( utest_p, runs.size() == 3 && runs.first()->next()->val() == 3);
+        UTEST_CHECK( utest_p, runs.remove_if( []( int v){ return v >= 0; }) == 3 && runs.empty());
+
+        runs.push_back( 1);
+        runs.erase( runs.first(), 0);
+        UTEST_CHECK( utest_p, runs.empty() && runs.last() == 0);
+
+        // Erased runs go back to the pool as one chain, new units are taken from it first
+        for ( int i = 0; i < 10; i++)
+        {
+            runs.push_back( i);
+        }
+        Unit *run_first = runs.first()->next();
+        runs.erase( run_first, runs.last());
+        runs.push_front( -1);
+        UTEST_CHECK( utest_p, runs.first() == run_first && runs.size() == 3);
+        UTEST_CHECK( utest_p, runs.remove_if( []( int v){ return v < 0; }) == 1 && runs.first()->val() == 0);
+
+        //--- Test snapshot save and load
+        const char *snapshot_path = "dlist_utest.bin";
+        List saved;
+        for ( int i = 0; i < 1000; i++)
+        {
+            saved.push_back( i * 3);
+        }
+        saved.reverse(); // saved in the list order: 2997 ... 3 0
+        UTEST_CHECK( utest_p, saved.save( snapshot_path));
+
+        List loaded;
+        loaded.push_back( -1);
+        UTEST_CHECK( utest_p, loaded.load( snapshot_path));
+        UTEST_CHECK( utest_p, loaded.size() == 1000);
+        UTEST_CHECK( utest_p, std::equal( loaded.begin(), loaded.end(), saved.begin()));
+        UTEST_CHECK( utest_p, loaded.first()->val() == 2997 && loaded.last()->val() == 0);
+
+        // Values of another type don't match the file, the list stays unchanged
+        DList<short> shorts;
+        shorts.push_back( 1);
+        UTEST_CHECK( utest_p, !shorts.load( snapshot_path));
+        UTEST_CHECK( utest_p, !shorts.load( "no_such_dir/no_such_file.bin"));
+        UTEST_CHECK( utest_p, shorts.size() == 1 && shorts.first()->val() == 1);
+
+        DList<std::string> saved_strings;
+        saved_strings.push_back( "");
+        saved_strings.push_back( "snapshot");
+        UTEST_CHECK( utest_p, saved_strings.save( snapshot_path));
+        DList<std::string> loaded_strings;
+        UTEST_CHECK( utest_p, loaded_strings.load( snapshot_path));
+        UTEST_CHECK( utest_p, loaded_strings.size() == 2 && loaded_strings.last()->val() == "snapshot");
+        {
+            // A broken string length fails the load instead of taking that much memory
+            std::fstream broken( snapshot_path, std::ios::binary | std::ios::in | std::ios::out);
+            UInt64 huge_len = ( UInt64)1 << 40;
+            broken.seekp( sizeof( ListFileHeader) + sizeof( UInt64)); // past the empty string
+            broken.write( reinterpret_cast<const char *>( &huge_len), sizeof( huge_len));
+        }
+        UTEST_CHECK( utest_p, !loaded_strings.load( snapshot_path) && loaded_strings.size() == 2);
+        UTEST_CHECK( utest_p, !loaded.load( snapshot_path) && loaded.size() == 1000);
+        std::remove( snapshot_path);
+
+        //--- Test allocation policies
+        DList<int, UnitHeap> heap_list;
+        heap_list.push_back( 1);
+        heap_list.push_front( 0);
+        heap_list.pop_back();
+
+        UTEST_CHECK( utest_p, heap_list.size() == 1);
+        UTEST_CHECK( utest_p, heap_list.first()->val() == 0);
+        for ( int i = 1; i < 10; i++)
+        {
+            heap_list.push_back( i);
+        }
+        UTEST_CHECK( utest_p, heap_list.remove_if( []( int v){ return v % 3 != 0; }) == 6 && heap_list.size() == 4);
+        heap_list.erase( heap_list.first()->next(), heap_list.last());
+        UTEST_CHECK( utest_p, heap_list.size() == 2 && heap_list.last()->val() == 9);
+
+        // Lists constructed with the same allocator take units from one pool
+        List shared_list( list.allocator());
+
+        UTEST_CHECK( utest_p, shared_list.allocator().shares( list.allocator()));
+        UTEST_CHECK( utest_p, !List().allocator().shares( list.allocator()));
+
+        for ( int i = 0; i < 1000; i++)
+        {
+            shared_list.push_back( i);
+        }
+        UTEST_CHECK( utest_p, shared_list.size() == 1000);
+        UTEST_CHECK( utest_p, shared_list.last()->val() == 999);
+
+        //--- Test bulk teardown: the values are destroyed with and without a shared pool
+        std::shared_ptr<int> token( new int( 0));
+        {
+            DList<std::shared_ptr<int> > own;
+            for ( int i = 0; i < 1000; i++)
+            {
+                own.push_back( token);
+            }
+            UTEST_CHECK( utest_p, token.use_count() == 1001);
+            own.clear(); // the only user of the pool, chunks are released at once
+            UTEST_CHECK( utest_p, token.use_count() == 1);
+            UTEST_CHECK( utest_p, own.empty() && own.first() == 0);
+
+            own.push_back( token);
+            DList<std::shared_ptr<int> > peer( own.allocator());
+            peer.push_back( token);
+            own.push_front( token);
+            own.clear(); // the pool is shared, units are freed one by one
+            UTEST_CHECK( utest_p, token.use_count() == 2);
+            UTEST_CHECK( utest_p, peer.first()->val() == token);
+        }
+        UTEST_CHECK( utest_p, token.use_count() == 1);
+
+        //--- Test splice, append and move
+        List a( list.allocator());
+        List b( list.allocator());
+        for ( int i = 0; i < 4; i++)
+        {
+            a.push_back( i);     // a: 0 1 2 3
+            b.push_back( i + 4); // b: 4 5 6 7
+        }
+        Unit *a_first = a.first();
+
+        a.splice( a.first()->next(), b, b.first()->next(), b.last()); // a: 0 5 6 1 2 3, b: 4 7
+
+        UTEST_CHECK( utest_p, a.size() == 6);
+        UTEST_CHECK( utest_p, b.size() == 2);
+        UTEST_CHECK( utest_p, a.first() == a_first);
+        UTEST_CHECK( utest_p, a.first()->next()->val() == 5);
+        UTEST_CHECK( utest_p, a.first()->next()->next()->next()->val() == 1);
+        UTEST_CHECK( utest_p, b.first()->next() == b.last());
+
+        a.splice( a.first(), b); // a: 4 7 0 5 6 1 2 3, b is empty
+
+        UTEST_CHECK( utest_p, b.empty());
+        UTEST_CHECK( utest_p, b.first() == 0);
+        UTEST_CHECK( utest_p, a.size() == 8);
+        UTEST_CHECK( utest_p, a.first()->val() == 4);
+        UTEST_CHECK( utest_p, a.first()->next()->next() == a_first);
+
+        // Moved list keeps the units
+        List moved( std::move( a));
+
+        UTEST_CHECK( utest_p, a.empty());
+        UTEST_CHECK( utest_p, moved.size() == 8);
+        UTEST_CHECK( utest_p, moved.first()->next()->next() == a_first);
+
+        b = std::move( moved);
+        UTEST_CHECK( utest_p, moved.empty());
+        UTEST_CHECK( utest_p, b.size() == 8);
+
+        // Lists with different pools join them, the units are relinked
+        List other;
+        List other_peer( other.allocator());
+        other.push_back( 100);
+        other_peer.push_back( 200);
+        UTEST_CHECK( utest_p, !other.allocator().shares( b.allocator()));
+        other.append( std::move( b));
+
+        UTEST_CHECK( utest_p, b.empty());
+        UTEST_CHECK( utest_p, other.allocator().shares( b.allocator()));
+        UTEST_CHECK( utest_p, other.allocator().shares( list.allocator()));
+        UTEST_CHECK( utest_p, other.allocator().shares( other_peer.allocator()));
+        UTEST_CHECK( utest_p, other.size() == 9);
+        UTEST_CHECK( utest_p, other.last()->val() == 3);
+        UTEST_CHECK( utest_p, other.first()->next()->val() == 4);
+        UTEST_CHECK( utest_p, other.first()->next()->next()->next() == a_first);
+
+        // Units of the joined pools are freed and allocated by any of the lists
+        other_peer.splice( 0, other, other.first()->next(), other.first()->next()->next()->next());
+        UTEST_CHECK( utest_p, other_peer.size() == 3 && other.size() == 7);
+        UTEST_CHECK( utest_p, other_peer.last()->val() == 7);
+        other_peer.clear();
+        other.pop_front();
+        for ( int i = 0; i < 1000; i++)
+        {
+            other_peer.push_back( i);
+            b.push_back( i);
+        }
+        b.clear();
+        other_peer.clear();
+        UTEST_CHECK( utest_p, other.size() == 6 && other.first() == a_first);
+
+        // Empty list takes over the pool of the spliced one
+        List taker;
+        taker.append( std::move( other));
+
+        UTEST_CHECK( utest_p, taker.allocator().shares( other.allocator()));
+        UTEST_CHECK( utest_p, taker.size() == 6 && taker.first() == a_first);
+
+        //--- Test emplace and move-only values
+        DList<CopyCounter> strings;
+        CopyCounter moved_val( "m", 100);
+
+        strings.emplace_back( "b", 100);
+        strings.emplace_front( std::string( 100, 'a'));
+        strings.emplace( strings.last(), "c", 1);
+        strings.push_back( std::move( moved_val));
+        strings.insert( strings.first(), CopyCounter( "x", 1));
+
+        UTEST_CHECK( utest_p, CopyCounter::copies == 0);
+        UTEST_CHECK( utest_p, strings.size() == 5);
+        UTEST_CHECK( utest_p, strings.first()->next()->val().payload.size() == 100);
+        UTEST_CHECK( utest_p, strings.last()->val().payload[ 0] == 'm');
+
+        const CopyCounter copied( "z", 1);
+        strings.push_back( copied);
+        UTEST_CHECK( utest_p, CopyCounter::copies == 1);
+
+        DList<std::unique_ptr<int>, UnitHeap> ptrs;
+        DList<std::unique_ptr<int>, UnitHeap> ptrs2;
+        ptrs.push_back( std::unique_ptr<int>( new int( 1)));
+        ptrs.emplace_front( new int( 0));
+        ptrs2.emplace_back( new int( 2));
+        ptrs.append( std::move( ptrs2));
+
+        UTEST_CHECK( utest_p, ptrs.size() == 3);
+        UTEST_CHECK( utest_p, *ptrs.first()->val() == 0);
+        UTEST_CHECK( utest_p, *ptrs.last()->val() == 2);
+
+        UDList<std::unique_ptr<int>, 64> uptrs;
+        for ( int i = 0; i < 20; i++)
+        {
+            uptrs.insert( uptrs.first(), std::unique_ptr<int>( new int( i)));
+        }
+        UTEST_CHECK( utest_p, uptrs.size() == 20);
+        UTEST_CHECK( utest_p, *uptrs.first()->val() == 19);
+        UTEST_CHECK( utest_p, *uptrs.last()->val() == 0);
+
+        //--- Test sort and merge
+        typedef std::pair<int, int> KeyVal; // key and the original position
+        DList<KeyVal> pairs;
+        for ( int i = 0; i < 1000; i++)
+        {
+            pairs.emplace_back( ( i * 7919) % 37, i);
+        }
+        Unit *any_unit = NULL;
+        pairs.sort( []( const KeyVal& a, const KeyVal& b){ return a.first < b.first; });
+
+        bool sorted = true;
+        for ( DList<KeyVal>::Unit *e = pairs.first(); e->next() != 0; e = e->next())
+        {
+            const KeyVal& a = e->val();
+            const KeyVal& b = e->next()->val();
+            sorted = sorted && ( a.first < b.first || ( a.first == b.first && a.second < b.second));
+            sorted = sorted && e->next()->prev() == e;
+        }
+        UTEST_CHECK( utest_p, sorted);
+        UTEST_CHECK( utest_p, pairs.size() == 1000);
+        UTEST_CHECK( utest_p, pairs.last()->next() == 0);
+
+        List odd;
+        List even;
+        for ( int i = 0; i < 10; i++)
+        {
+            even.push_front( 2 * i);
+            odd.push_front( 2 * i + 1);
+        }
+        any_unit = odd.first();
+        even.sort();
+        odd.sort();
+        even.merge( odd);
+
+        UTEST_CHECK( utest_p, odd.empty());
+        UTEST_CHECK( utest_p, even.size() == 20);
+        sorted = true;
+        expected = 0;
+        for ( Unit* e = even.first (); e!= 0; e = e->next() )
+        {
+            sorted = sorted && e->val() == expected++;
+        }
+        UTEST_CHECK( utest_p, sorted);
+        UTEST_CHECK( utest_p, even.last()->val() == 19);
+        UTEST_CHECK( utest_p, any_unit->val() == 19 && any_unit == even.last());
+
+        return utest_p->result();
+    }
+};
+
+// Testing of the unrolled list
+namespace Task
+{
+    typedef UDList<int, 64> UList; // Small nodes to get many of them in the test
+
+    bool uTestUnrolled( UnitTest *utest_p)
+    {
+        UList list;
+        list.push_back( 5);
+        list.push_back( 10);
+        UList::Unit *u = list.first();
+
+        UTEST_CHECK( utest_p, u);
+        UTEST_CHECK( utest_p, list.size() == 2);
+        UTEST_CHECK( utest_p, u->next() == list.last());
+        UTEST_CHECK( utest_p, list.last()->prev() == u);
+
+        UList::Unit *last = list.erase( u);
+
+        UTEST_CHECK( utest_p, last == list.first());
+        UTEST_CHECK( utest_p, last->val() == 10);
+        UTEST_CHECK( utest_p, last->next() == 0);
+        UTEST_CHECK( utest_p, last->prev() == 0);
+
+        list.clear();
+        UTEST_CHECK( utest_p, list.empty());
+        UTEST_CHECK( utest_p, list.first() == 0);
+
+        //--- Fill several nodes from both sides: list 0 1 ... 99
+        for ( int i = 50; i < 100; i++)
+        {
+            list.push_back( i);
+        }
+        for ( int i = 49; i >= 0; i--)
+        {
+            list.push_front( i);
+        }
+        UTEST_CHECK( utest_p, list.size() == 100);
+        UTEST_CHECK( utest_p, UList::NODE_CAPACITY < 100);
+
+        int sum = 0;
+        int expected = 0;
+        bool ordered = true;
+        for ( UList::Unit* e = list.first (); e!= 0; e = e->next() )
+        {
+            ordered = ordered && e->val() == expected++;
+            sum += e->val();
+        }
+        UTEST_CHECK( utest_p, ordered);
+        UTEST_CHECK( utest_p, sum == 4950);
+
+        //--- Insert into full nodes, which splits them: insert -1 before every even value
+        for ( UList::Unit* e = list.first (); e!= 0; e = e->next() )
+        {
+            if ( e->val() % 2 == 0)
+                e = list.insert( e, -1)->next();
+        }
+        UTEST_CHECK( utest_p, list.size() == 150);
+
+        //--- Erase the inserted values back
+        int num_erased = 0;
+        for ( UList::Unit* e = list.first (); e!= 0; )
+        {
+            if ( e->val() == -1)
+            {
+                e = list.erase( e);
+                num_erased++;
+            } else
+            {
+                e = e->next();
+            }
+        }
+        UTEST_CHECK( utest_p, num_erased == 50);
+        UTEST_CHECK( utest_p, list.size() == 100);
+
+        //--- Reverse and walk backwards
+        list.reverse();
+        expected = 0;
+        ordered = true;
+        for ( UList::Unit* e = list.last (); e!= 0; e = e->prev() )
+        {
+            ordered = ordered && e->val() == expected++;
+        }
+        UTEST_CHECK( utest_p, ordered);
+        UTEST_CHECK( utest_p, expected == 100);
+        UTEST_CHECK( utest_p, list.first()->val() == 99);
+
+        while ( !list.empty())
+        {
+            list.pop_back();
+        }
+        UTEST_CHECK( utest_p, list.last() == 0);
+
+        return utest_p->result();
+    }
+};
+
+// Testing of the index-linked list
+namespace Task
+{
+    typedef IDList<int> IList;
+
+    bool uTestCompact( UnitTest *utest_p)
+    {
+        IList list;
+        list.push_back( 5);
+        list.push_back( 10);
+        IList::Unit *u = list.first();
+
+        UTEST_CHECK( utest_p, u);
+        UTEST_CHECK( utest_p, list.size() == 2);
+        UTEST_CHECK( utest_p, u->next() == list.last());
+        UTEST_CHECK( utest_p, list.last()->prev() == u);
+
+        IList::Unit *last = list.erase( u);
+
+        UTEST_CHECK( utest_p, last == list.first());
+        UTEST_CHECK( utest_p, last->val() == 10);
+        UTEST_CHECK( utest_p, last->next() == 0);
+        UTEST_CHECK( utest_p, last->prev() == 0);
+
+        list.clear();
+        UTEST_CHECK( utest_p, list.empty());
+        UTEST_CHECK( utest_p, list.first() == 0);
+
+        //--- Fill from both sides, the arena grows several times: list 0 1 ... 99
+        for ( int i = 50; i < 100; i++)
+        {
+            list.push_back( i);
+        }
+        for ( int i = 49; i >= 0; i--)
+        {
+            list.push_front( i);
+        }
+        UTEST_CHECK( utest_p, list.size() == 100);
+        UTEST_CHECK( utest_p, list.capacity() >= 100);
+
+        int sum = 0;
+        int expected = 0;
+        bool ordered = true;
+        for ( IList::Unit* e = list.first (); e!= 0; e = e->next() )
+        {
+            ordered = ordered && e->val() == expected++;
+            sum += e->val();
+        }
+        UTEST_CHECK( utest_p, ordered);
+        UTEST_CHECK( utest_p, sum == 4950);
+
+        //--- Insert before every even value, the arena grows in the middle of the walk
+        for ( IList::Unit* e = list.first (); e!= 0; e = e->next() )
+        {
+            if ( e->val() % 2 == 0)
+                e = list.insert( e, -1)->next();
+        }
+        UTEST_CHECK( utest_p, list.size() == 150);
+        UTEST_CHECK( utest_p, list.first()->val() == -1 && list.last()->val() == 99);
+
+        //--- Erase the inserted values back, freed slots are reused by the next inserts
+        int num_erased = 0;
+        for ( IList::Unit* e = list.first (); e!= 0; )
+        {
+            if ( e->val() == -1)
+            {
+                e = list.erase( e);
+                num_erased++;
+            } else
+            {
+                e = e->next();
+            }
+        }
+        UTEST_CHECK( utest_p, num_erased == 50);
+        UTEST_CHECK( utest_p, list.size() == 100);
+
+        UInt32 cap = list.capacity();
+        for ( int i = 0; i < 50; i++)
+        {
+            list.emplace_back( 100 + i);
+        }
+        UTEST_CHECK( utest_p, list.capacity() == cap);
+        for ( int i = 0; i < 50; i++)
+        {
+            list.pop_back();
+        }
+
+        //--- Reverse and walk backwards
+        list.reverse();
+        expected = 0;
+        ordered = true;
+        for ( IList::Unit* e = list.last (); e!= 0; e = e->prev() )
+        {
+            ordered = ordered && e->val() == expected++;
+        }
+        UTEST_CHECK( utest_p, ordered);
+        UTEST_CHECK( utest_p, expected == 100);
+        UTEST_CHECK( utest_p, list.first()->val() == 99);
+
+        //--- Reserved arena keeps the units in place
+        IList reserved;
+        reserved.reserve( 1000);
+        reserved.push_back( 0);
+        IList::Unit *front = reserved.first();
+        for ( int i = 1; i < 1000; i++)
+        {
+            reserved.push_back( i);
+        }
+        UTEST_CHECK( utest_p, reserved.first() == front);
+
+        //--- Values with resources are moved correctly when the arena grows
+        IDList<std::unique_ptr<int> > owners;
+        for ( int i = 0; i < 100; i++)
+        {
+            owners.emplace_back( new int( i));
+        }
+        sum = 0;
+        for ( IDList<std::unique_ptr<int> >::Unit *e = owners.first(); e != 0; e = e->next())
+        {
+            sum += *e->val();
+        }
+        UTEST_CHECK( utest_p, sum == 4950);
+
+        while ( !list.empty())
+        {
+            list.pop_front();
+        }
+        UTEST_CHECK( utest_p, list.last() == 0);
+
+        return utest_p->result();
+    }
+};
+
+// Testing of the list with positional access
+namespace Task
+{
+    typedef ODList<int> OList;
+
+    bool uTestIndexed( UnitTest *utest_p)
+    {
+        OList list;
+        UTEST_CHECK( utest_p, list.at( 0) == 0);
+
+        list.push_back( 5);
+        list.push_back( 10);
+        UTEST_CHECK( utest_p, list.size() == 2);
+        UTEST_CHECK( utest_p, list.at( 0) == list.first());
+        UTEST_CHECK( utest_p, list.at( 1) == list.last());
+        UTEST_CHECK( utest_p, list.at( 2) == 0);
+        UTEST_CHECK( utest_p, list.index_of( list.last()) == 1);
+
+        list.insert_at( 1, 7);  // list: 5 7 10
+        list.insert_at( 3, 12); // list: 5 7 10 12
+        list.insert_at( 0, 3);  // list: 3 5 7 10 12
+        UTEST_CHECK( utest_p, list.at( 2)->val() == 7);
+        UTEST_CHECK( utest_p, list.first()->next()->val() == 5);
+        UTEST_CHECK( utest_p, list.last()->prev()->val() == 10);
+
+        list.clear();
+        UTEST_CHECK( utest_p, list.empty());
+        UTEST_CHECK( utest_p, list.first() == 0);
+
+        //--- Build 0 ... 999 inserting at the middle positions, check against a plain vector
+        std::vector<int> ref;
+        for ( int i = 0; i < 1000; i++)
+        {
+            unsigned k = ( unsigned)( ( i * 7919) % ( ref.size() + 1));
+            list.insert_at( k, i);
+            ref.insert( ref.begin() + k, i);
+        }
+        UTEST_CHECK( utest_p, list.size() == 1000);
+
+        bool same = true;
+        unsigned k = 0;
+        for ( OList::Unit *e = list.first(); isNotNullP( e); e = e->next(), k++)
+        {
+            same = same && e->val() == ref[ k] && list.index_of( e) == k && list.at( k) == e;
+        }
+        UTEST_CHECK( utest_p, same);
+
+        //--- Erase every third unit and positions stay consistent
+        k = 0;
+        for ( OList::Unit *e = list.first(); isNotNullP( e); k++)
+        {
+            if ( k % 3 == 0)
+                e = list.erase( e);
+            else
+                e = e->next();
+        }
+        for ( int i = 999; i >= 0; i -= 3)
+        {
+            ref.erase( ref.begin() + i - i % 3);
+        }
+        UTEST_CHECK( utest_p, list.size() == ref.size());
+
+        same = true;
+        for ( k = 0; k < ref.size(); k++)
+        {
+            OList::Unit *e = list.at( k);
+            same = same && isNotNullP( e) && e->val() == ref[ k] && list.index_of( e) == k;
+        }
+        UTEST_CHECK( utest_p, same);
+
+        while ( !list.empty())
+        {
+            list.pop_front();
+            list.pop_back();
+        }
+        UTEST_CHECK( utest_p, list.size() == 0 && list.last() == 0);
+
+        return utest_p->result();
+    }
+};
+
+// Testing of the LRU cache
+namespace Task
+{
+    // Hash that puts all keys into few table slots to test long probe chains
+    struct CollidingHash
+    {
+        size_t operator()( int key) const { return ( size_t)( key % 4); }
+    };
+
+    bool uTestLru( UnitTest *utest_p)
+    {
+        LruCache<int, std::string> cache( 3);
+
+        UTEST_CHECK( utest_p, cache.get( 1) == 0);
+        cache.put( 1, "one");
+        cache.put( 2, "two");
+        cache.put( 3, "three");
+        UTEST_CHECK( utest_p, cache.size() == 3);
+        UTEST_CHECK( utest_p, *cache.get( 1) == "one"); // 1 is the most recently used now
+
+        cache.put( 4, "four"); // evicts 2
+        UTEST_CHECK( utest_p, cache.size() == 3 && cache.evictions() == 1);
+        UTEST_CHECK( utest_p, cache.get( 2) == 0);
+        UTEST_CHECK( utest_p, cache.get( 1) && cache.get( 3) && cache.get( 4));
+        UTEST_CHECK( utest_p, cache.hits() == 4 && cache.misses() == 2);
+
+        cache.put( 3, "THREE"); // replaces the value
+        UTEST_CHECK( utest_p, cache.size() == 3 && *cache.get( 3) == "THREE");
+        UTEST_CHECK( utest_p, cache.erase( 3) && !cache.erase( 3));
+        UTEST_CHECK( utest_p, cache.size() == 2 && cache.get( 3) == 0);
+
+        cache.clear();
+        UTEST_CHECK( utest_p, cache.size() == 0 && cache.get( 1) == 0);
+
+        //--- Byte limit: entries are evicted until the sum of sizes fits
+        LruCache<int, int> sized( 100, 10);
+        sized.put( 1, 1, 4);
+        sized.put( 2, 2, 4);
+        sized.put( 3, 3, 4); // 12 bytes, evicts 1
+        UTEST_CHECK( utest_p, sized.size() == 2 && sized.bytes() == 8 && !sized.get( 1));
+        sized.put( 4, 4, 20); // too big for the limit alone, stays as the only entry
+        UTEST_CHECK( utest_p, sized.size() == 1 && *sized.get( 4) == 4);
+
+        //--- Colliding keys and removals from the middle of probe chains, checked against std::map
+        LruCache<int, int, CollidingHash> chains( 1000);
+        std::map<int, int> ref;
+        for ( int i = 0; i < 200; i++)
+        {
+            chains.put( i, i * i);
+            ref[ i] = i * i;
+        }
+        for ( int i = 0; i < 200; i += 3)
+        {
+            chains.erase( i);
+            ref.erase( i);
+        }
+        bool same = chains.size() == ref.size();
+        for ( int i = 0; i < 200; i++)
+        {
+            int *v = chains.get( i);
+            same = same && ( ref.count( i) ? ( isNotNullP( v) && *v == i * i) : isNullP( v));
+        }
+        UTEST_CHECK( utest_p, same);
+
+        return utest_p->result();
+    }
+};
+
+// Testing of the concurrent queue
+namespace Task
+{
+    // Push values [from, from + num) to the queue
+    template <class Q> static void producer( Q *queue, int from, int num)
+    {
+        for ( int i = from; i < from + num; i++)
+        {
+            queue->push_back( i);
+        }
+    }
+
+    // Pop values until num of them are taken from the queue, sum them. The queue is polled
+    // with empty() too, as it is read while the other consumers move the head
+    template <class Q> static void consumer( Q *queue, std::atomic<int> *left, std::atomic<Int64> *sum)
+    {
+        int val = 0;
+        Int64 local_sum = 0;
+
+        while ( left->load() > 0)
+        {
+            if ( !queue->empty() && queue->pop_front( val))
+            {
+                local_sum += val;
+                left->fetch_sub( 1);
+            }
+        }
+        sum->fetch_add( local_sum);
+    }
+
+    bool uTestQueue( UnitTest *utest_p)
+    {
+        //--- Single thread FIFO order
+        CQueue<std::string> strings;
+        std::string val;
+
+        UTEST_CHECK( utest_p, strings.empty());
+        UTEST_CHECK( utest_p, !strings.pop_front( val));
+
+        strings.push_back( "a");
+        strings.emplace_back( 2, 'b');
+        strings.push_back( std::string( "c"));
+
+        UTEST_CHECK( utest_p, !strings.empty());
+        UTEST_CHECK( utest_p, strings.pop_front( val) && val == "a");
+        UTEST_CHECK( utest_p, strings.pop_front( val) && val == "bb");
+
+        // Enough values to make the pool grow a few times, one left for the destructor
+        for ( int i = 0; i < 10000; i++)
+        {
+            strings.push_back( std::to_string( i));
+        }
+        bool ordered = strings.pop_front( val) && val == "c";
+        for ( int i = 0; i < 9999; i++)
+        {
+            ordered = ordered && strings.pop_front( val) && val == std::to_string( i);
+        }
+        UTEST_CHECK( utest_p, ordered);
+
+        //--- Multiple producers, single consumer
+        const int NUM_PRODUCERS = 4;
+        const int NUM_PER_PRODUCER = 20000;
+        const int NUM = NUM_PRODUCERS * NUM_PER_PRODUCER;
+        const Int64 REF_SUM = ( Int64)NUM * ( NUM - 1) / 2;
+
+        CQueue<int> mpsc;
+        std::atomic<int> left( NUM);
+        std::atomic<Int64> sum( 0);
+        std::vector<std::thread> threads;
+
+        for ( int i = 0; i < NUM_PRODUCERS; i++)
+        {
+            threads.push_back( std::thread( producer<CQueue<int> >, &mpsc, i * NUM_PER_PRODUCER, NUM_PER_PRODUCER));
+        }
+        consumer( &mpsc, &left, &sum);
+        for ( size_t i = 0; i < threads.size(); i++)
+        {
+            threads[ i].join();
+        }
+        UTEST_CHECK( utest_p, sum.load() == REF_SUM);
+        UTEST_CHECK( utest_p, mpsc.empty());
+
+        //--- Multiple producers and consumers
+        CQueue<int, QUEUE_MPMC> mpmc;
+        left.store( NUM);
+        sum.store( 0);
+        threads.clear();
+
+        for ( int i = 0; i < NUM_PRODUCERS; i++)
+        {
+            threads.push_back( std::thread( producer<CQueue<int, QUEUE_MPMC> >, &mpmc, i * NUM_PER_PRODUCER, NUM_PER_PRODUCER));
+            threads.push_back( std::thread( consumer<CQueue<int, QUEUE_MPMC> >, &mpmc, &left, &sum));
+        }
+        for ( size_t i = 0; i < threads.size(); i++)
+        {
+            threads[ i].join();
+        }
+        UTEST_CHECK( utest_p, sum.load() == REF_SUM);
+        UTEST_CHECK( utest_p, mpmc.empty());
 
         return utest_p->result();
     }
@@ -0,0 +1,304 @@
+/**
+ * @file: task/list_alloc.h
+ * Allocation policies for the units of Task::DList
+ */
+#pragma once
+
+#ifndef TASK_LIST_ALLOC_H
+#define TASK_LIST_ALLOC_H
+
+namespace Task
+{
+    //
+    // Unit allocation policy that takes unit memory from a Mem::TypedPool.
+    //
+    // The pool allocates units in chunks, so building a long list doesn't call
+    // malloc for every element. The pool is created on the first allocation and
+    // is shared between the copies of the policy object: lists constructed with
+    // the same allocator take units from one pool and thus can exchange units.
+    // Lists with different pools are joined when units pass between them: one pool
+    // takes over the chunks of the other, which is left as a forward to it, so the
+    // policy objects still referencing it move to the joined pool on the next use.
+    // Joining takes time proportional to the number of chunks and is done once per
+    // pair of pools. The pool is deleted together with the last reference to it.
+    //
+    // deallocate_chain() takes a run of units at once: it is put in front of the list
+    // of free units with one store, and allocate() takes units from that list first.
+    // Units freed this way stay in the pool for reuse until the pool is released.
+    //
+    template <class Unit> class UnitPool
+    {
+    public:
+        typedef Mem::TypedPool<Unit> Pool;
+
+        UnitPool();                                  // Create policy, the pool is created lazily
+        UnitPool( const UnitPool& peer);             // Share the pool of the peer
+        UnitPool& operator = ( const UnitPool& peer);// Release own pool and share the pool of the peer
+        ~UnitPool();                                 // Release the pool reference
+
+        inline void *allocate();             // Get memory for one unit
+        inline void deallocate( void *ptr);  // Return memory of one unit to the pool
+        void deallocate_chain( void *first,  // Return the units linked through their first words
+                               void *last);  // from first to last, constant time
+        bool shares( const UnitPool& peer) const; // Check that units can be passed to the peer
+        void join( UnitPool& peer);          // Make the peer share the pool, the units of both are kept
+        bool exclusive() const;              // Check that all allocated units belong to the owner of this object
+        void deallocate_all();               // Release all units in whole chunks, only if exclusive()
+        void swap( UnitPool& peer);          // Exchange the pools
+    private:
+        // Pool with the reference counter
+        struct Shared
+        {
+            Pool pool;
+            UInt32 refs;
+            Shared *joined; // Pool that took over the chunks, it is referenced by this one
+            void *free_units; // Freed units linked through their first words
+            void *free_last;  // Last of the free units, valid if there are any
+        };
+
+        Shared *attach() const; // Create the pool if needed and add a reference to it
+        void detach();          // Remove reference, delete the pool if it was the last one
+        Shared *pool() const;   // Current pool, follows the forwards of the joined pools
+        static void release( Shared *s); // Remove reference, delete the forwards not needed any more
+
+        mutable Shared *shared;
+    };
+
+    //
+    // Unit allocation policy that uses plain operator new/delete for every unit
+    //
+    template <class Unit> class UnitHeap
+    {
+    public:
+        inline void *allocate();            // Get memory for one unit
+        inline void deallocate( void *ptr); // Free memory of one unit
+        void deallocate_chain( void *first, // Free the units linked through their first words
+                               void *last); // from first to last one by one
+        bool shares( const UnitHeap& peer) const; // Heap units can always be passed between lists
+        void join( UnitHeap& peer);         // Nothing to join
+        bool exclusive() const;             // Heap units are always freed one by one
+        void deallocate_all();              // Never called, as the heap is never exclusive
+        void swap( UnitHeap& peer);         // Nothing to exchange
+    };
+
+// ---- UnitPool implementation ----
+
+    template <class Unit> UnitPool<Unit>::UnitPool(): shared( NULL)
+    {
+    }
+
+    template <class Unit> UnitPool<Unit>::UnitPool( const UnitPool& peer): shared( peer.attach())
+    {
+    }
+
+    template <class Unit> UnitPool<Unit>&
+    UnitPool<Unit>::operator = ( const UnitPool& peer)
+    {
+        if ( areNotEqP( this, &peer))
+        {
+            Shared *s = peer.attach();
+            detach();
+            shared = s;
+        }
+        return *this;
+    }
+
+    template <class Unit> UnitPool<Unit>::~UnitPool()
+    {
+        detach();
+    }
+
+    template <class Unit> typename UnitPool<Unit>::Shared *
+    UnitPool<Unit>::pool() const
+    {
+        if ( isNullP( shared))
+        {
+            shared = new Shared;
+            shared->refs = 1;
+            shared->joined = NULL;
+            shared->free_units = NULL;
+        }
+        while ( isNotNullP( shared->joined))
+        {
+            Shared *s = shared;
+
+            shared = s->joined;
+            shared->refs++;
+            release( s);
+        }
+        return shared;
+    }
+
+    template <class Unit> void
+    UnitPool<Unit>::release( Shared *s)
+    {
+        while ( isNotNullP( s) && --s->refs == 0)
+        {
+            Shared *joined = s->joined;
+
+            // No list is left, so all the units are free and the chunks go at once
+            if ( isNotNullP( s->free_units))
+                s->pool.deallocateAll();
+            delete s;
+            s = joined;
+        }
+    }
+
+    template <class Unit> typename UnitPool<Unit>::Shared *
+    UnitPool<Unit>::attach() const
+    {
+        Shared *s = pool();
+
+        s->refs++;
+        return s;
+    }
+
+    template <class Unit> void
+    UnitPool<Unit>::detach()
+    {
+        release( shared);
+        shared = NULL;
+    }
+
+    template <class Unit> void *
+    UnitPool<Unit>::allocate()
+    {
+        Shared *s = ( isNotNullP( shared) && isNullP( shared->joined)) ? shared : pool();
+        void *ptr = s->free_units;
+
+        if ( isNotNullP( ptr))
+        {
+            s->free_units = *static_cast<void **>( ptr);
+            return ptr;
+        }
+        return s->pool.allocate( sizeof( Unit));
+    }
+
+    template <class Unit> void
+    UnitPool<Unit>::deallocate( void *ptr)
+    {
+        DLIST_ASSERTXD( isNotNullP( shared), "Deallocation of a unit that wasn't allocated in the pool");
+        pool()->pool.deallocate( ptr);
+    }
+
+    template <class Unit> void
+    UnitPool<Unit>::deallocate_chain( void *first, void *last)
+    {
+        DLIST_ASSERTXD( isNotNullP( shared), "Deallocation of units that weren't allocated in the pool");
+        Shared *s = pool();
+
+        if ( isNullP( s->free_units))
+            s->free_last = last;
+        *static_cast<void **>( last) = s->free_units;
+        s->free_units = first;
+    }
+
+    template <class Unit> bool
+    UnitPool<Unit>::shares( const UnitPool& peer) const
+    {
+        return isNotNullP( shared) && isNotNullP( peer.shared) && areEqP( pool(), peer.pool());
+    }
+
+    // The peer's pool is absorbed by this one and becomes a forward to it
+    template <class Unit> void
+    UnitPool<Unit>::join( UnitPool& peer)
+    {
+        if ( isNullP( peer.shared))
+            return;
+
+        Shared *s = pool();
+        Shared *p = peer.pool();
+
+        if ( areEqP( s, p))
+            return;
+        s->pool.absorb( p->pool);
+        if ( isNotNullP( p->free_units))
+        {
+            deallocate_chain( p->free_units, p->free_last);
+            p->free_units = NULL;
+        }
+        p->joined = s;
+        s->refs++;
+        peer.pool();
+    }
+
+    template <class Unit> void
+    UnitPool<Unit>::swap( UnitPool& peer)
+    {
+        std::swap( shared, peer.shared);
+    }
+
+    // No other policy object references the pool, so there are no units of other lists in it
+    template <class Unit> bool
+    UnitPool<Unit>::exclusive() const
+    {
+        return isNotNullP( shared) && pool()->refs == 1;
+    }
+
+    template <class Unit> void
+    UnitPool<Unit>::deallocate_all()
+    {
+        DLIST_ASSERTXD( exclusive(), "Bulk release of a pool that is shared with other lists");
+        pool()->free_units = NULL;
+        pool()->pool.deallocateAll();
+    }
+
+// ---- UnitHeap implementation ----
+
+    template <class Unit> void *
+    UnitHeap<Unit>::allocate()
+    {
+        return ::operator new( sizeof( Unit));
+    }
+
+    template <class Unit> void
+    UnitHeap<Unit>::deallocate( void *ptr)
+    {
+        ::operator delete( ptr);
+    }
+
+    template <class Unit> void
+    UnitHeap<Unit>::deallocate_chain( void *first, void *last)
+    {
+        for ( void *ptr = first; ; )
+        {
+            void *next = *static_cast<void **>( ptr);
+            bool is_last = areEqP( ptr, last);
+
+            ::operator delete( ptr);
+            if ( is_last)
+                break;
+            ptr = next;
+        }
+    }
+
+    template <class Unit> bool
+    UnitHeap<Unit>::shares( const UnitHeap&) const
+    {
+        return true;
+    }
+
+    template <class Unit> void
+    UnitHeap<Unit>::join( UnitHeap&)
+    {
+    }
+
+    template <class Unit> void
+    UnitHeap<Unit>::swap( UnitHeap&)
+    {
+    }
+
+    template <class Unit> bool
+    UnitHeap<Unit>::exclusive() const
+    {
+        return false;
+    }
+
+    template <class Unit> void
+    UnitHeap<Unit>::deallocate_all()
+    {
+        DLIST_ASSERTXD( 0, "Bulk release of heap units");
+    }
+};
+
+#endif /* TASK_LIST_ALLOC_H */
@@ -0,0 +1,122 @@
+/**
+ * @file: task/list_file.cpp
+ * Read-only file mapping used to load list snapshots
+ */
+#include "iface.h"
+
+#ifdef OS_WIN
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace Task
+{
+    MappedFile::MappedFile():
+        mem( NULL),
+        mem_size( 0)
+#ifdef OS_WIN
+        , file_handle( NULL),
+        mapping_handle( NULL)
+#endif
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+#ifdef OS_WIN
+    bool MappedFile::open( const char *path)
+    {
+        close();
+
+        HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                   OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if ( file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER file_size;
+        if ( !GetFileSizeEx( file, &file_size) || file_size.QuadPart == 0)
+        {
+            CloseHandle( file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if ( isNullP( mapping))
+        {
+            CloseHandle( file);
+            return false;
+        }
+
+        void *ptr = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0);
+        if ( isNullP( ptr))
+        {
+            CloseHandle( mapping);
+            CloseHandle( file);
+            return false;
+        }
+        file_handle = file;
+        mapping_handle = mapping;
+        mem = static_cast<const UInt8 *>( ptr);
+        mem_size = ( size_t)file_size.QuadPart;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if ( isNotNullP( mem))
+        {
+            UnmapViewOfFile( mem);
+            CloseHandle( mapping_handle);
+            CloseHandle( file_handle);
+        }
+        mem = NULL;
+        mem_size = 0;
+        file_handle = NULL;
+        mapping_handle = NULL;
+    }
+#else
+    bool MappedFile::open( const char *path)
+    {
+        close();
+
+        int fd = ::open( path, O_RDONLY);
+        if ( fd < 0)
+            return false;
+
+        struct stat st;
+        if ( fstat( fd, &st) != 0 || st.st_size == 0)
+        {
+            ::close( fd);
+            return false;
+        }
+
+        void *ptr = mmap( NULL, ( size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close( fd); // the mapping keeps the file referenced
+
+        if ( ptr == MAP_FAILED)
+            return false;
+
+        // The list is built in one sequential pass over the values
+        madvise( ptr, ( size_t)st.st_size, MADV_SEQUENTIAL);
+
+        mem = static_cast<const UInt8 *>( ptr);
+        mem_size = ( size_t)st.st_size;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if ( isNotNullP( mem))
+            munmap( const_cast<UInt8 *>( mem), mem_size);
+        mem = NULL;
+        mem_size = 0;
+    }
+#endif
+};
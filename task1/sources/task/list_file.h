@@ -0,0 +1,113 @@
+/**
+ * @file: task/list_file.h
+ * Binary file format of list snapshots and read-only file mapping
+ */
+#pragma once
+
+#ifndef TASK_LIST_FILE_H
+#define TASK_LIST_FILE_H
+
+namespace Task
+{
+    //
+    // Header of a list snapshot file. The values follow the header, either as raw
+    // bytes of sizeof( T) each (LIST_FILE_RAW) or in the format of ListSerializer<T>
+    //
+    struct ListFileHeader
+    {
+        UInt32 magic;      // LIST_FILE_MAGIC
+        UInt32 version;    // LIST_FILE_VERSION
+        UInt32 value_size; // sizeof( T) of the saved list
+        UInt32 flags;      // LIST_FILE_RAW if the values are raw bytes
+        UInt64 num;        // Number of values
+    };
+
+    const UInt32 LIST_FILE_MAGIC = 0x54534c44; // "DLST"
+    const UInt32 LIST_FILE_VERSION = 1;
+    const UInt32 LIST_FILE_RAW = 1;
+
+    //
+    // Binary serialization of list values that are not trivially copyable.
+    // Trivially copyable values are saved as raw bytes and don't use it.
+    // Specialize it to save lists of other types
+    //
+    template <class T> struct ListSerializer
+    {
+        static void write( std::ostream& os, const T& val)
+        {
+            static_assert( std::is_trivially_copyable<T>::value, "ListSerializer is not specialized for the type");
+            os.write( reinterpret_cast<const char *>( &val), sizeof( T));
+        }
+        static bool read( std::istream& is, T& val)
+        {
+            static_assert( std::is_trivially_copyable<T>::value, "ListSerializer is not specialized for the type");
+            return bool( is.read( reinterpret_cast<char *>( &val), sizeof( T)));
+        }
+    };
+
+    //
+    // Strings are saved as the length followed by the characters. The length comes from
+    // the file, so the characters are read in pieces of at most READ_PIECE bytes: a bad
+    // length fails on the end of the stream without taking more memory than the file has
+    //
+    template <> struct ListSerializer<std::string>
+    {
+        static void write( std::ostream& os, const std::string& val)
+        {
+            UInt64 len = val.size();
+            os.write( reinterpret_cast<const char *>( &len), sizeof( len));
+            os.write( val.data(), val.size());
+        }
+        static bool read( std::istream& is, std::string& val)
+        {
+            UInt64 len = 0;
+            if ( !is.read( reinterpret_cast<char *>( &len), sizeof( len))
+                 || len > val.max_size())
+                return false;
+
+            val.clear();
+            while ( len > 0)
+            {
+                size_t piece = ( len < READ_PIECE) ? ( size_t)len : READ_PIECE;
+                size_t done = val.size();
+
+                val.resize( done + piece);
+                if ( !is.read( &val[ done], ( std::streamsize)piece))
+                    return false;
+                len -= piece;
+            }
+            return true;
+        }
+    private:
+        static const size_t READ_PIECE = 64 * 1024;
+    };
+
+    //
+    // Read-only memory mapping of a whole file
+    //
+    class MappedFile
+    {
+    public:
+        MappedFile();  //< Constructor
+        ~MappedFile(); //< Destructor, unmaps the file
+
+        bool open( const char *path); // Map the file, returns false if it can't be mapped
+        void close();                 // Unmap the file
+
+        const UInt8 *data() const { return mem; } // Mapped memory, null if not mapped
+        size_t size() const { return mem_size; }  // File size
+    private:
+        // ---- Default copy constructor and assignment turned off ----
+        MappedFile( const MappedFile& f);
+        MappedFile& operator = ( const MappedFile& f);
+
+        const UInt8 *mem;
+        size_t mem_size;
+#ifdef OS_WIN
+        void *file_handle;
+        void *mapping_handle;
+#endif
+    };
+};
+
+#endif /* TASK_LIST_FILE_H */
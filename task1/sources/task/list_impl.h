@@ -2,243 +2,1018 @@
  * @file: task/list_impl.h
  * Solution implementation of the programming task 1
  */
+#pragma once
 
 namespace Task
 {
 // ---- DList::Unit class implementation ----
 
     // This is how template class members are defined outside of the template class
-    template <class T> // template keyword and template parameter
-    typename DList<T>::Unit *   // the return value. Note that we have to use the template parameter T to specify return type.
-                                // "typename" is needed here because DList<T>::Unit is a
-                                // dependent name and we should hint the compiler that it is a type
-    DList<T>::Unit::next()
+    template <class T, template <class U> class AllocPolicy> // template keyword and template parameters
+    typename DList<T, AllocPolicy>::Unit *   // the return value. Note that we have to use the template parameters to specify return type.
+                                             // "typename" is needed here because DList<T, AllocPolicy>::Unit is a
+                                             // dependent name and we should hint the compiler that it is a type
+    DList<T, AllocPolicy>::Unit::next()
     {
-        if(this)
+        return unit_next;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::Unit::prev()
+    {
+        return unit_prev;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    T& DList<T, AllocPolicy>::Unit::val()
+    {
+        return unit_value;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args> // constructor is a template member of a template class, so it has two template headers
+    DList<T, AllocPolicy>::Unit::Unit( Args&&... args):
+        unit_value( std::forward<Args>( args)...),
+        unit_prev( NULL),
+        unit_next( NULL)
+    {
+    }
+
+// ---- DList template class implementation ----
+
+    template <class T, template <class U> class AllocPolicy>
+    DList<T, AllocPolicy>::DList():
+        head( NULL),
+        tail( NULL),
+        dir( LIST_DIR_DEFAULT),
+        size_of_list( 0)
+    {
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    DList<T, AllocPolicy>::DList( const Allocator& a):
+        head( NULL),
+        tail( NULL),
+        dir( LIST_DIR_DEFAULT),
+        size_of_list( 0),
+        alloc( a)
+    {
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    DList<T, AllocPolicy>::DList( DList&& list):
+        head( list.head),
+        tail( list.tail),
+        dir( list.dir),
+        size_of_list( list.size_of_list)
+    {
+        alloc.swap( list.alloc);
+        list.head = NULL;
+        list.tail = NULL;
+        list.dir = LIST_DIR_DEFAULT;
+        list.size_of_list = 0;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    DList<T, AllocPolicy>&
+    DList<T, AllocPolicy>::operator = ( DList&& list)
+    {
+        if ( areNotEqP( this, &list))
         {
-            return unit_next;
+            clear();
+            alloc.swap( list.alloc);
+            std::swap( head, list.head);
+            std::swap( tail, list.tail);
+            std::swap( dir, list.dir);
+            std::swap( size_of_list, list.size_of_list);
         }
+        return *this;
+    }
 
+    template <class T, template <class U> class AllocPolicy>
+    DList<T, AllocPolicy>::~DList()
+    {
+        clear();
     }
 
-    template <class T> typename DList<T>::Unit *
-    DList<T>::Unit::prev()
+    // Allocate memory with the allocation policy and construct the unit there
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::create_unit( Args&&... args)
     {
-        if (this)
+        void *mem = alloc.allocate();
+        try
         {
-            return unit_prev;
+            return new ( mem) Unit( std::forward<Args>( args)...);
+        } catch ( ...)
+        {
+            alloc.deallocate( mem);
+            throw;
         }
-
     }
-    template <class T>  T&
-    DList<T>::Unit::val(){
-	    if(this){
-		    return unit_value;
-	    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::destroy_unit( Unit* u)
+    {
+        u->~Unit();
+        alloc.deallocate( u);
     }
 
-    template <class T> void
-	    DList<T>::Unit::addPrev(Unit *prev) {
-	    unit_prev = prev;
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *&
+    DList<T, AllocPolicy>::peer( Unit* u, ListDir d)
+    {
+        return ( d == LIST_DIR_DEFAULT) ? u->unit_next : u->unit_prev;
     }
-    template <class T> void
-    DList<T>::Unit::addNext(Unit *next) {
-	    unit_next = next;
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *&
+    DList<T, AllocPolicy>::end_in_dir( ListDir d)
+    {
+        return ( d == LIST_DIR_DEFAULT) ? tail : head;
     }
 
+    // Link before pos in the current direction
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::link_before( Unit* u, Unit* pos)
+    {
+        ListDir rdir = ListRDir( dir);
+        Unit *prev = isNotNullP( pos) ? peer( pos, rdir) : end_in_dir( dir);
+
+        peer( u, rdir) = prev;
+        peer( u, dir) = pos;
+
+        if ( isNotNullP( prev))
+            peer( prev, dir) = u;
+        else
+            end_in_dir( rdir) = u;
+
+        if ( isNotNullP( pos))
+            peer( pos, rdir) = u;
+        else
+            end_in_dir( dir) = u;
 
-    template <class T>
-    DList<T>::Unit::Unit(const T value)
-    {unit_value = value;
-    unit_prev = NULL;
-    unit_next = NULL;
+        size_of_list++;
     }
 
+    // Swap the links of every unit, the order of the list stays the same
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::orient( ListDir d)
+    {
+        if ( dir == d)
+            return;
 
-    // ---- DList template class implementation ----
+        Unit *u = head;
 
+        while ( isNotNullP( u))
+        {
+            Unit *next = u->unit_next;
+            u->unit_next = u->unit_prev; // swap prev and next
+            u->unit_prev = next;
+            u = next;
+        }
+        std::swap( head, tail);
+        dir = d;
+    }
 
-    template <class T> DList<T>::DList()
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::unlink( Unit* u)
     {
-		head = NULL;
-		tail = NULL;
-	    size_of_list = 0;
+        DLIST_ASSERTXD( size_of_list > 0, "Unlinking a unit from an empty list");
+
+        if ( isNotNullP( u->unit_prev))
+            u->unit_prev->unit_next = u->unit_next;
+        else
+            head = u->unit_next;
+
+        if ( isNotNullP( u->unit_next))
+            u->unit_next->unit_prev = u->unit_prev;
+        else
+            tail = u->unit_prev;
+
+        u->unit_prev = NULL;
+        u->unit_next = NULL;
+        size_of_list--;
     }
 
-        template <class T> DList<T>::~DList()
+    // Cut the run [first, last] in the list order out of the list, the run keeps its inner links
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::cut( Unit* first, Unit* last, unsigned num)
     {
-		    while (size_of_list > 0)
-                pop_front();
+        ListDir rdir = ListRDir( dir);
+        Unit *before = peer( first, rdir);
+        Unit *after = peer( last, dir);
+
+        if ( isNotNullP( before))
+            peer( before, dir) = after;
+        else
+            end_in_dir( rdir) = after;
+
+        if ( isNotNullP( after))
+            peer( after, rdir) = before;
+        else
+            end_in_dir( dir) = before;
+
+        size_of_list -= num;
     }
 
-    template <class T> void DList<T>::push_front (const T& val)
+    // Cut the run out of list and link it before pos, no units are allocated or freed
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::relink( Unit* pos, DList& list, Unit* first, Unit* last, unsigned num)
     {
-        if(head == NULL)
+        list.cut( first, last, num);
+
+        // A run from a list of the other direction gets the links of its units swapped
+        if ( list.dir != dir)
         {
-            head = new Unit(val);
-            tail = head;
-            size_of_list = 1;
+            for ( Unit *u = first; ; u = peer( u, dir))
+            {
+                std::swap( u->unit_next, u->unit_prev);
+                if ( areEqP( u, last))
+                    break;
+            }
         }
+
+        ListDir rdir = ListRDir( dir);
+        Unit *prev = isNotNullP( pos) ? peer( pos, rdir) : end_in_dir( dir);
+
+        peer( first, rdir) = prev;
+        peer( last, dir) = pos;
+
+        if ( isNotNullP( prev))
+            peer( prev, dir) = first;
+        else
+            end_in_dir( rdir) = first;
+
+        if ( isNotNullP( pos))
+            peer( pos, rdir) = last;
         else
+            end_in_dir( dir) = last;
+
+        size_of_list += num;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::splice( Unit* pos, DList& list)
+    {
+        if ( areEqP( this, &list) || isNullP( list.head))
+            return;
+
+        // Lists of different directions: the smaller one is relinked to the direction of the other
+        if ( list.dir != dir)
+        {
+            if ( size_of_list < list.size_of_list)
+            {
+                orient( list.dir);
+            } else
+            {
+                list.orient( dir);
+            }
+        }
+
+        // An empty list can take over the unit memory of the other one,
+        // otherwise the memories are joined so the units can be relinked
+        if ( isNullP( head) && !alloc.shares( list.alloc))
+        {
+            alloc = list.alloc;
+        } else
+        {
+            alloc.join( list.alloc);
+        }
+        relink( pos, list, list.end_in_dir( ListRDir( dir)), list.end_in_dir( dir), list.size_of_list);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::splice( Unit* pos, DList& list, Unit* first, Unit* last)
+    {
+        if ( areEqP( first, last))
+            return;
+
+        if ( isNullP( last) && areEqP( first, list.end_in_dir( ListRDir( list.dir))) && areNotEqP( this, &list))
         {
-            size_of_list++;
-            head->addPrev(new Unit(val));//new element is previous for current first
-            head->prev()->addNext(head);
-            head = head->prev();//new front element
-            head->addPrev(NULL);
+            splice( pos, list);
+            return;
+        }
+        alloc.join( list.alloc);
+
+        // Partial range: the moved units have to be counted to keep sizes right. A run
+        // from a list of the other direction gets relinked while it is moved
+        unsigned num = 1;
+        Unit *run_last = first;
 
+        while ( areNotEqP( peer( run_last, list.dir), last))
+        {
+            DLIST_ASSERTXD( areNotEqP( run_last, pos), "Splice position is inside of the moved range");
+            run_last = peer( run_last, list.dir);
+            num++;
         }
+        if ( areNotEqP( pos, first) && areNotEqP( pos, last))
+            relink( pos, list, first, run_last, num);
     }
-     template <class T> void DList<T>::pop_front()
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::append( DList&& list)
     {
-	    if (size_of_list) {
-		    if (head->unit_next()){
-		        head = head->unit_next();
-			    head->addPrev(NULL);
-		    }
-		    else
+        splice( NULL, list);
+    }
+
+    // Merge chains linked by unit_next only. Units of chain a are taken first on equal values
+    template <class T, template <class U> class AllocPolicy>
+    template <class Compare>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::merge_chains( Unit* a, Unit* b, Compare& cmp)
+    {
+        Unit *res = NULL;
+        Unit **link = &res;
+
+        while ( isNotNullP( a) && isNotNullP( b))
+        {
+            if ( cmp( b->unit_value, a->unit_value))
+            {
+                *link = b;
+                b = b->unit_next;
+            } else
             {
-                head = NULL;
-                tail = NULL;
+                *link = a;
+                a = a->unit_next;
             }
-	    }
+            link = &( *link)->unit_next;
+        }
+        *link = isNotNullP( a) ? a : b;
+        return res;
     }
-    template <class T> void DList<T>::push_back(const T &val)
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::restore_prev_links()
     {
+        Unit *prev = NULL;
 
-	    if (tail) {
-		    tail->addNext(new Unit(val));//new Unit
-		    tail->unit_next()->addPrev(tail);//prev of new Unit == last
-		    tail = tail->unit_next();//new last
-		    tail->addNext(NULL);
-	    } else
-	    {
-		    tail = new Unit(val);
-		    head = tail;
-	    }
-        size_of_list++;
+        for ( Unit *u = head; isNotNullP( u); u = u->unit_next)
+        {
+            u->unit_prev = prev;
+            prev = u;
+        }
+        tail = prev;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::sort()
+    {
+        sort( std::less<T>());
+    }
+
+    // A reversed list has the links from the last unit to the first one, so the links are
+    // sorted in the descending order. That keeps equal values in the list order as well
+    template <class T, template <class U> class AllocPolicy>
+    template <class Compare>
+    void DList<T, AllocPolicy>::sort( Compare cmp)
+    {
+        if ( size_of_list < 2)
+            return;
+
+        if ( dir == LIST_DIR_DEFAULT)
+        {
+            sort_links( cmp);
+        } else
+        {
+            auto greater = [&cmp]( const T& a, const T& b) -> bool { return cmp( b, a); };
+            sort_links( greater);
+        }
     }
 
-    template <class T> void DList<T>::pop_back()
+    //
+    // Bottom-up merge sort. Bin i holds a sorted chain of 2^i units, every new unit
+    // is carried up through the occupied bins like in binary increment. Higher bins
+    // hold earlier units, so they are passed first to keep the sort stable.
+    //
+    template <class T, template <class U> class AllocPolicy>
+    template <class Compare>
+    void DList<T, AllocPolicy>::sort_links( Compare& cmp)
     {
-	    if (size_of_list){
-	        size_of_list--;
+        const int MAX_BINS = 64;
+        Unit *bins[ MAX_BINS] = { NULL };
+        int num_bins = 0;
 
-		    if (tail->unit_prev()) {
-			    tail = tail->unit_prev();
-			    tail->addNext(NULL);
-		    }
-	        else
+        Unit *u = head;
+        while ( isNotNullP( u))
+        {
+            Unit *carry = u;
+            u = u->unit_next;
+            carry->unit_next = NULL;
+
+            int i = 0;
+            for ( ; i < num_bins && isNotNullP( bins[ i]); i++)
             {
-                tail = NULL;
-                head = NULL;
-	        }
-	    }
+                carry = merge_chains( bins[ i], carry, cmp);
+                bins[ i] = NULL;
+            }
+            bins[ i] = carry;
+            if ( i == num_bins)
+                num_bins++;
+        }
+
+        Unit *res = NULL;
+        for ( int i = 0; i < num_bins; i++)
+        {
+            if ( isNotNullP( bins[ i]))
+                res = merge_chains( bins[ i], res, cmp);
+        }
+        head = res;
+        restore_prev_links();
     }
 
-    template <class T>
-    typename    DList<T>::Unit* DList<T>:: insert (Unit* u, const T& val)
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::merge( DList& list)
     {
-	    DList<T>:: Unit* previous = u->unit_prev();//remember previous
-	    u->addPrev(new Unit(val)) ;//add new previous
-	    u->unit_prev()->addPrev(previous);
-	    u->unit_prev->addNext(u);
-	    size_of_list++;
-	    return u->unit_prev();
+        merge( list, std::less<T>());
     }
-        template <class T>
-    typename DList<T>::Unit* DList<T>::  first()
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class Compare>
+    void DList<T, AllocPolicy>::merge( DList& list, Compare cmp)
+    {
+        if ( areEqP( this, &list) || isNullP( list.head))
+            return;
+
+        // Merging walks all units anyway, so both lists are relinked to the default direction
+        orient( LIST_DIR_DEFAULT);
+        list.orient( LIST_DIR_DEFAULT);
+        Unit *own_tail = tail;
+
+        // Move units to the back first, they are relinked as the unit memories get joined
+        splice( NULL, list);
+
+        if ( isNullP( own_tail))
+            return;
+
+        Unit *second = own_tail->unit_next;
+        own_tail->unit_next = NULL;
+        head = merge_chains( head, second, cmp);
+        restore_prev_links();
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::push_front( const T& val)
+    {
+        link_before( create_unit( val), end_in_dir( ListRDir( dir)));
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::push_front( T&& val)
     {
-	    return head;
+        link_before( create_unit( std::move( val)), end_in_dir( ListRDir( dir)));
     }
 
-    template <class T>
-    typename DList<T>:: Unit* DList<T>:: last()
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    void DList<T, AllocPolicy>::emplace_front( Args&&... args)
     {
-	    return tail;
+        link_before( create_unit( std::forward<Args>( args)...), end_in_dir( ListRDir( dir)));
     }
 
-     template <class T>
-    typename DList<T>:: Unit* DList<T>::erase(Unit *u)
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::pop_front()
     {
-        if(size_of_list)
+        if ( isNotNullP( head))
         {
-            if (u->unit_prev())
-            {
-                if (u->unit_next())
-                {
-                    u->unit_prev()->addNext(u->unit_next);
-                    u->unit_next()->addPrev(u->unit_prev);
-                    size_of_list--;
-                    return u->unit_prev;
-                }
-                else
-                {
-                    tail = u->unit_prev();
-                    size_of_list--;
-                    return tail;
-                }
+            Unit *u = end_in_dir( ListRDir( dir));
+            unlink( u);
+            destroy_unit( u);
+        }
+    }
 
-            }
-            else
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::push_back( const T& val)
+    {
+        link_before( create_unit( val), NULL);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::push_back( T&& val)
+    {
+        link_before( create_unit( std::move( val)), NULL);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    void DList<T, AllocPolicy>::emplace_back( Args&&... args)
+    {
+        link_before( create_unit( std::forward<Args>( args)...), NULL);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::pop_back()
+    {
+        if ( isNotNullP( tail))
+        {
+            Unit *u = end_in_dir( dir);
+            unlink( u);
+            destroy_unit( u);
+        }
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::insert( Unit* u, const T& val)
+    {
+        orient( LIST_DIR_DEFAULT);
+        Unit *new_unit = create_unit( val);
+        link_before( new_unit, u);
+        return new_unit;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::insert( Unit* u, T&& val)
+    {
+        orient( LIST_DIR_DEFAULT);
+        Unit *new_unit = create_unit( std::move( val));
+        link_before( new_unit, u);
+        return new_unit;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::emplace( Unit* u, Args&&... args)
+    {
+        orient( LIST_DIR_DEFAULT);
+        Unit *new_unit = create_unit( std::forward<Args>( args)...);
+        link_before( new_unit, u);
+        return new_unit;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::first()
+    {
+        orient( LIST_DIR_DEFAULT);
+        return head;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::last()
+    {
+        orient( LIST_DIR_DEFAULT);
+        return tail;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::erase( Unit* u)
+    {
+        DLIST_ASSERTXD( isNotNullP( u), "Erasing null unit");
+        orient( LIST_DIR_DEFAULT);
+        Unit *next = u->unit_next;
+
+        unlink( u);
+        destroy_unit( u);
+        return next;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::erase( Unit* first, Unit* last)
+    {
+        if ( areEqP( first, last))
+            return last;
+
+        orient( LIST_DIR_DEFAULT);
+        if ( areEqP( first, head) && isNullP( last))
+        {
+            clear();
+            return NULL;
+        }
+
+        unsigned num = 1;
+        Unit *run_last = first;
+
+        while ( areNotEqP( peer( run_last, dir), last))
+        {
+            DLIST_ASSERTXD( isNotNullP( peer( run_last, dir)), "Erased range end is not in the list");
+            run_last = peer( run_last, dir);
+            num++;
+        }
+        cut( first, run_last, num);
+        peer( run_last, dir) = NULL;
+        release_chain( first);
+        return last;
+    }
+
+    // The destroyed units are linked through their first words, the last one to rest
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::destroy_chain( Unit* first, void* rest)
+    {
+        Unit *last = first;
+
+        for ( Unit *u = first; isNotNullP( u); )
+        {
+            Unit *next = peer( u, dir);
+            u->~Unit();
+            *reinterpret_cast<void **>( u) = isNotNullP( next) ? next : rest;
+            last = u;
+            u = next;
+        }
+        return last;
+    }
+
+    // The units are given back to the allocation policy as one chain
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::release_chain( Unit* first)
+    {
+        alloc.deallocate_chain( first, destroy_chain( first, NULL));
+    }
+
+    //
+    // Teardown doesn't unlink units one by one. If the list is the only user of its unit
+    // memory, the values are destroyed in one pass (skipped for trivially destructible T)
+    // and the memory is released in whole chunks. Otherwise the units are destroyed and
+    // given back to the unit memory as one chain
+    //
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::clear()
+    {
+        if ( isNullP( head))
+            return;
+
+        if ( alloc.exclusive())
+        {
+            if ( !std::is_trivially_destructible<T>::value)
             {
-               if (u->unit_next())
+                for ( Unit *u = head; isNotNullP( u); )
                 {
-                    head = u->unit_next();
-                    size_of_list--;
-                    return NULL;
+                    Unit *next = u->unit_next;
+                    u->~Unit();
+                    u = next;
                 }
-                head = NULL;
-                tail = NULL;
-                size_of_list--;
-                return head;
+            }
+            alloc.deallocate_all();
+        } else
+        {
+            release_chain( end_in_dir( ListRDir( dir)));
+        }
+        head = NULL;
+        tail = NULL;
+        dir = LIST_DIR_DEFAULT;
+        size_of_list = 0;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    bool DList<T, AllocPolicy>::empty()
+    {
+        return size_of_list == 0;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    unsigned DList<T, AllocPolicy>::size()
+    {
+        return size_of_list;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void DList<T, AllocPolicy>::reverse()
+    {
+        dir = ListRDir( dir);
+    }
+
+// ---- DList iterators ----
+
+    // The unit is given out, so an iterator carries out a pending reversal for its
+    // next()/prev(). That keeps the list order, the iterators stay valid. A const_iterator
+    // leaves the links as they are
+    template <class T, template <class U> class AllocPolicy>
+    template <class V>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::Iter<V>::unit() const
+    {
+        orient_units( list);
+        return cur;
+    }
 
+    template <class T, template <class U> class AllocPolicy>
+    template <class V>
+    typename DList<T, AllocPolicy>::template Iter<V> &
+    DList<T, AllocPolicy>::Iter<V>::operator ++()
+    {
+        cur = peer( cur, list->dir);
+        return *this;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class V>
+    typename DList<T, AllocPolicy>::template Iter<V> &
+    DList<T, AllocPolicy>::Iter<V>::operator --()
+    {
+        if ( isNotNullP( cur))
+            cur = peer( cur, ListRDir( list->dir));
+        else
+            cur = ( list->dir == LIST_DIR_DEFAULT) ? list->tail : list->head; // last unit
+        return *this;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::iterator
+    DList<T, AllocPolicy>::begin()
+    {
+        return iterator( end_in_dir( ListRDir( dir)), this);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::iterator
+    DList<T, AllocPolicy>::end()
+    {
+        return iterator( NULL, this);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::const_iterator
+    DList<T, AllocPolicy>::begin() const
+    {
+        return const_iterator( ( dir == LIST_DIR_DEFAULT) ? head : tail, this);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename DList<T, AllocPolicy>::const_iterator
+    DList<T, AllocPolicy>::end() const
+    {
+        return const_iterator( NULL, this);
+    }
+
+    //
+    // The next unit is read before v is called, so v may destroy the unit it gets
+    //
+    template <class T, template <class U> class AllocPolicy>
+    template <class Visit>
+    typename DList<T, AllocPolicy>::Unit *
+    DList<T, AllocPolicy>::visit( Visit v)
+    {
+        ListDir d = dir;
+        Unit *u = end_in_dir( ListRDir( d));
+
+        while ( isNotNullP( u))
+        {
+            Unit *next = peer( u, d);
+            if ( v( u))
+                return u;
+            u = next;
+        }
+        return NULL;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class F>
+    F DList<T, AllocPolicy>::for_each( F f)
+    {
+        visit( [&f]( Unit* u) -> bool { f( u->unit_value); return false; });
+        return f;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class Pred>
+    typename DList<T, AllocPolicy>::iterator
+    DList<T, AllocPolicy>::find_if( Pred p)
+    {
+        return iterator( visit( [&p]( Unit* u) -> bool { return p( u->unit_value); }), this);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class Pred>
+    unsigned DList<T, AllocPolicy>::count_if( Pred p)
+    {
+        unsigned num = 0;
+
+        visit( [&p, &num]( Unit* u) -> bool
+        {
+            if ( p( u->unit_value))
+                num++;
+            return false;
+        });
+        return num;
+    }
+
+    //
+    // Consecutive units to remove are gathered into runs, and every run is cut out with one
+    // relinking of its ends and destroyed right away, while its units are still in cache.
+    // The destroyed runs are chained together and freed with one call at the end.
+    // If every unit goes, the list is cleared, which releases pool chunks at once
+    //
+    template <class T, template <class U> class AllocPolicy>
+    template <class Pred>
+    unsigned DList<T, AllocPolicy>::remove_runs( Pred p)
+    {
+        unsigned total = size_of_list;
+        unsigned num = 0;
+        unsigned run_num = 0;
+        Unit *run_first = NULL;
+        Unit *run_last = NULL;
+        Unit *freed_first = NULL;
+        Unit *freed_last = NULL;
+
+        auto end_run = [&]()
+        {
+            cut( run_first, run_last, run_num);
+            peer( run_last, dir) = NULL;
+            Unit *last = destroy_chain( run_first, freed_first);
+            if ( isNullP( freed_last))
+                freed_last = last;
+            freed_first = run_first;
+            num += run_num;
+            run_num = 0;
+            run_first = NULL;
+        };
+
+        visit( [&]( Unit* u) -> bool
+        {
+            if ( p( u))
+            {
+                if ( isNullP( run_first))
+                    run_first = u;
+                run_last = u;
+                run_num++;
+            } else if ( isNotNullP( run_first))
+            {
+                end_run();
             }
+            return false;
+        });
+
+        if ( run_num == total)
+        {
+            clear();
+            return total;
         }
+        if ( isNotNullP( run_first))
+            end_run();
+        if ( isNotNullP( freed_first))
+            alloc.deallocate_chain( freed_first, freed_last);
+
+        return num;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class Pred>
+    unsigned DList<T, AllocPolicy>::remove_if( Pred p)
+    {
+        return remove_runs( [&p]( Unit* u) -> bool { return p( u->unit_value); });
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    unsigned DList<T, AllocPolicy>::unique()
+    {
+        return unique( std::equal_to<T>());
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class Pred>
+    unsigned DList<T, AllocPolicy>::unique( Pred eq)
+    {
+        Unit *kept = NULL;
+
+        return remove_runs( [&kept, &eq]( Unit* u) -> bool
+        {
+            if ( isNotNullP( kept) && eq( kept->unit_value, u->unit_value))
+                return true;
+            kept = u;
+            return false;
+        });
     }
 
-     template <class T>
-    void DList<T>::clear()
+// ---- DList snapshot ----
+
+    template <class T, template <class U> class AllocPolicy>
+    bool DList<T, AllocPolicy>::check_header( const ListFileHeader& header, bool raw)
     {
-	   while(size_of_list)
-       {
-           pop_front();
-       }
+        return header.magic == LIST_FILE_MAGIC
+               && header.version == LIST_FILE_VERSION
+               && header.value_size == sizeof( T)
+               && ( ( header.flags & LIST_FILE_RAW) != 0) == raw;
     }
 
+    template <class T, template <class U> class AllocPolicy>
+    bool DList<T, AllocPolicy>::save( const char *path)
+    {
+        typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> Raw;
+        std::ofstream os( path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ListFileHeader header;
 
-	template <class T>
-	bool DList<T>::empty()
-	{
-		return (!size_of_list);
-	}
+        header.magic = LIST_FILE_MAGIC;
+        header.version = LIST_FILE_VERSION;
+        header.value_size = sizeof( T);
+        header.flags = Raw::value ? LIST_FILE_RAW : 0;
+        header.num = size_of_list;
 
-	template <class T>
-	unsigned DList<T>::size()
-	{
-		return size_of_list;
-	}
+        if ( !os.write( reinterpret_cast<const char *>( &header), sizeof( header)))
+            return false;
+
+        return save_values( os, Raw()) && bool( os.flush());
+    }
 
-	 template <class T>
-    void DList<T>::reverse()
+    // Raw values are gathered in a buffer to write the file in big blocks
+    template <class T, template <class U> class AllocPolicy>
+    bool DList<T, AllocPolicy>::save_values( std::ostream& os, std::true_type)
     {
-	    DList<T>:: Unit* current = head;
-	    for (int i = 0; i < size_of_list; i++)
+        const size_t BUFFER_VALUES = 1 + ( 1 << 16) / sizeof( T);
+        std::vector<char> buffer( BUFFER_VALUES * sizeof( T));
+        size_t num = 0;
+
+        for_each( [&]( const T& val)
+        {
+            memcpy( &buffer[ num * sizeof( T)], &val, sizeof( T));
+            if ( ++num == BUFFER_VALUES)
             {
-			    DList<T>::Unit* prev = current->unit_next(), next = current->unit_prev();// remember prev and next
-			    current->addNext(next);//swap prev and next
-			    current->addPrev(prev);
-			    current = current->prev;
-		    }
+                os.write( &buffer[ 0], num * sizeof( T));
+                num = 0;
+            }
+        });
+        os.write( &buffer[ 0], num * sizeof( T));
+        return bool( os);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    bool DList<T, AllocPolicy>::save_values( std::ostream& os, std::false_type)
+    {
+        for_each( [&os]( const T& val)
+        {
+            ListSerializer<T>::write( os, val);
+        });
+        return bool( os);
+    }
+
+    // The units are constructed right from the mapped file memory, no read calls or parsing
+    template <class T, template <class U> class AllocPolicy>
+    bool DList<T, AllocPolicy>::load_values( const char *path, DList& loaded, std::true_type)
+    {
+        MappedFile file;
+        ListFileHeader header;
+
+        if ( !file.open( path) || file.size() < sizeof( header))
+            return false;
+
+        memcpy( &header, file.data(), sizeof( header));
+        if ( !check_header( header, true)
+             || header.num > ( file.size() - sizeof( header)) / sizeof( T))
+        {
+            return false;
+        }
+
+        const UInt8 *ptr = file.data() + sizeof( header);
+        typename std::aligned_storage<sizeof( T), alignof( T)>::type val;
 
-	    Unit* new_head = tail;//
-	    Unit* new_tail = head;//swaping first_ and next
-	    head = new_head;
-	    tail = new_tail;
+        for ( UInt64 i = 0; i < header.num; i++, ptr += sizeof( T))
+        {
+            memcpy( &val, ptr, sizeof( T)); // the file memory isn't aligned for T in general
+            loaded.link_before( loaded.create_unit( *reinterpret_cast<const T *>( &val)), NULL);
+        }
+        return true;
+    }
 
+    template <class T, template <class U> class AllocPolicy>
+    bool DList<T, AllocPolicy>::load_values( const char *path, DList& loaded, std::false_type)
+    {
+        std::ifstream is( path, std::ios::in | std::ios::binary);
+        ListFileHeader header;
+
+        if ( !is.read( reinterpret_cast<char *>( &header), sizeof( header))
+             || !check_header( header, false))
+        {
+            return false;
+        }
+        for ( UInt64 i = 0; i < header.num; i++)
+        {
+            T val;
+            if ( !ListSerializer<T>::read( is, val))
+                return false;
+            loaded.emplace_back( std::move( val));
+        }
+        return true;
     }
 
+    template <class T, template <class U> class AllocPolicy>
+    bool DList<T, AllocPolicy>::load( const char *path)
+    {
+        typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> Raw;
+
+        // Build the new list aside, it takes units from the same memory to be spliced in at once
+        DList loaded( alloc);
+
+        if ( !load_values( path, loaded, Raw()))
+            return false;
 
+        clear();
+        splice( NULL, loaded);
+        return true;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    const typename DList<T, AllocPolicy>::Allocator &
+    DList<T, AllocPolicy>::allocator() const
+    {
+        return alloc;
+    }
 
 // ---- End of DList template class implementation ----
 };
@@ -0,0 +1,283 @@
+/**
+ * @file: task/lru_cache.h
+ * Least recently used cache built on DList and an open addressing hash index
+ */
+#pragma once
+
+#ifndef TASK_LRU_CACHE_H
+#define TASK_LRU_CACHE_H
+
+#include <functional>
+
+namespace Task
+{
+    //
+    // LRU cache
+    // @param K key type
+    // @param V value type
+    // @param Hash hash function of the keys
+    // @param Eq key equality
+    //
+    // Entries are kept in a DList from the most recently used one to the least recently
+    // used one, so a hit moves the entry to the front and the eviction takes the last
+    // entry, both in O(1). Keys are found by an open addressing hash table with linear
+    // probing that keeps unit pointers and key hashes. Removal shifts the following
+    // entries of the probe chain back, so the table never has tombstones.
+    //
+    // The capacity is a number of entries and optionally a number of bytes, where the size
+    // of an entry is given to put(). Entries are evicted until both limits are met.
+    //
+    template <class K, class V, class Hash = std::hash<K>, class Eq = std::equal_to<K> > class LruCache
+    {
+    public:
+        //
+        // Cache entry
+        //
+        struct Entry
+        {
+            K key;
+            V value;
+            size_t bytes;
+
+            Entry( const K& k, V&& v, size_t b): key( k), value( std::move( v)), bytes( b){}
+        };
+
+        LruCache( size_t max_entries, size_t max_bytes = 0); //< Constructor, 0 bytes means no limit on bytes
+
+        V* get( const K& key);                        // Find value and mark it as used, null if there is none
+        void put( const K& key, const V& val,         // Insert or replace value, it becomes the most recently
+                  size_t bytes = sizeof( K) + sizeof( V)); // used one. Evicts entries that don't fit
+        void put( const K& key, V&& val, size_t bytes = sizeof( K) + sizeof( V));
+        bool erase( const K& key);                    // Remove value, returns false if there was none
+        void clear();                                 // Remove all values, the counters are kept
+
+        size_t size() const { return num_entries; }   // Number of cached values
+        size_t bytes() const { return num_bytes; }    // Sum of the cached value sizes
+        UInt64 hits() const { return num_hits; }      // Number of get() calls that found the value
+        UInt64 misses() const { return num_misses; }  // Number of get() calls that didn't
+        UInt64 evictions() const { return num_evictions; } // Number of values removed to make room
+
+    private:
+        typedef DList<Entry> List;
+        typedef typename List::Unit Unit;
+
+        // Hash table slot, empty if unit is null
+        struct Slot
+        {
+            Unit *unit;
+            size_t hash;
+        };
+
+        static const size_t MIN_TABLE_SIZE = 16;
+
+        // ---- The internal implementation routines ----
+        size_t hash_of( const K& key) const; // Key hash with the bits mixed for the table index
+        size_t find_slot( const K& key, size_t hash) const; // Slot with the key, or the empty slot where it goes
+        void remove_slot( size_t i);     // Free slot and shift the rest of its probe chain back
+        void grow_table();               // Double the table and rehash
+        void evict();                    // Remove entries from the back until the limits are met
+        void remove_unit( Unit* u);      // Remove entry from the table and the list
+
+        // ---- Default copy constructor and assignment turned off ----
+        LruCache( const LruCache& c);
+        LruCache& operator = ( const LruCache& c);
+
+        // ---- The data involved in the implementation ----
+        List entries;
+        std::vector<Slot> table;
+        size_t mask;
+        Hash hasher;
+        Eq equal;
+        size_t max_entries;
+        size_t max_bytes;
+        size_t num_entries;
+        size_t num_bytes;
+        UInt64 num_hits;
+        UInt64 num_misses;
+        UInt64 num_evictions;
+    };
+
+// ---- LruCache implementation ----
+
+    template <class K, class V, class Hash, class Eq>
+    LruCache<K, V, Hash, Eq>::LruCache( size_t max_num, size_t max_size):
+        max_entries( max_num),
+        max_bytes( max_size),
+        num_entries( 0),
+        num_bytes( 0),
+        num_hits( 0),
+        num_misses( 0),
+        num_evictions( 0)
+    {
+        DLIST_ASSERTXD( max_entries > 0, "Cache can't hold any entry");
+
+        // Keep the load factor under 1/2 for the entry limit, the table grows if bytes are the limit
+        size_t table_size = MIN_TABLE_SIZE;
+        while ( table_size < 2 * max_entries && table_size < ( ( size_t)1 << 20))
+        {
+            table_size *= 2;
+        }
+        Slot empty = { NULL, 0 };
+        table.assign( table_size, empty);
+        mask = table_size - 1;
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    size_t LruCache<K, V, Hash, Eq>::hash_of( const K& key) const
+    {
+        // std::hash of integers is identity, dense keys would make long runs of filled slots
+        UInt64 h = ( UInt64)hasher( key) * 0x9e3779b97f4a7c15ull;
+        return ( size_t)( h ^ ( h >> 32));
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    size_t LruCache<K, V, Hash, Eq>::find_slot( const K& key, size_t hash) const
+    {
+        size_t i = hash & mask;
+
+        while ( isNotNullP( table[ i].unit)
+                && ( table[ i].hash != hash || !equal( table[ i].unit->val().key, key)))
+        {
+            i = ( i + 1) & mask;
+        }
+        return i;
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    void LruCache<K, V, Hash, Eq>::remove_slot( size_t i)
+    {
+        // Move back every following entry of the chain that may be placed at i
+        for ( size_t j = ( i + 1) & mask; isNotNullP( table[ j].unit); j = ( j + 1) & mask)
+        {
+            size_t home = table[ j].hash & mask;
+
+            // The entry at j can't move to i if its home is cyclically in (i, j]
+            bool stays = ( i <= j) ? ( i < home && home <= j) : ( i < home || home <= j);
+            if ( !stays)
+            {
+                table[ i] = table[ j];
+                i = j;
+            }
+        }
+        table[ i].unit = NULL;
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    void LruCache<K, V, Hash, Eq>::grow_table()
+    {
+        std::vector<Slot> old_table;
+        Slot empty = { NULL, 0 };
+
+        old_table.swap( table);
+        table.assign( old_table.size() * 2, empty);
+        mask = table.size() - 1;
+
+        for ( size_t i = 0; i < old_table.size(); i++)
+        {
+            if ( isNotNullP( old_table[ i].unit))
+                table[ find_slot( old_table[ i].unit->val().key, old_table[ i].hash)] = old_table[ i];
+        }
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    V* LruCache<K, V, Hash, Eq>::get( const K& key)
+    {
+        Slot& slot = table[ find_slot( key, hash_of( key))];
+
+        if ( isNullP( slot.unit))
+        {
+            num_misses++;
+            return NULL;
+        }
+        num_hits++;
+
+        // Move the entry to the front, this only relinks the unit
+        if ( areNotEqP( slot.unit, entries.first()))
+            entries.splice( entries.first(), entries, slot.unit, slot.unit->next());
+        return &slot.unit->val().value;
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    void LruCache<K, V, Hash, Eq>::put( const K& key, const V& val, size_t bytes)
+    {
+        put( key, V( val), bytes);
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    void LruCache<K, V, Hash, Eq>::put( const K& key, V&& val, size_t bytes)
+    {
+        size_t hash = hash_of( key);
+        size_t i = find_slot( key, hash);
+
+        if ( isNotNullP( table[ i].unit))
+        {
+            Unit *u = table[ i].unit;
+
+            num_bytes -= u->val().bytes;
+            u->val().value = std::move( val);
+            u->val().bytes = bytes;
+            num_bytes += bytes;
+            if ( areNotEqP( u, entries.first()))
+                entries.splice( entries.first(), entries, u, u->next());
+        } else
+        {
+            entries.emplace_front( key, std::move( val), bytes);
+            table[ i].unit = entries.first();
+            table[ i].hash = hash;
+            num_entries++;
+            num_bytes += bytes;
+
+            if ( 2 * num_entries > table.size())
+                grow_table();
+        }
+        evict();
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    void LruCache<K, V, Hash, Eq>::remove_unit( Unit* u)
+    {
+        const K& key = u->val().key;
+
+        remove_slot( find_slot( key, hash_of( key)));
+        num_entries--;
+        num_bytes -= u->val().bytes;
+        entries.erase( u);
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    void LruCache<K, V, Hash, Eq>::evict()
+    {
+        // The newest entry stays even if it is bigger than the byte limit alone
+        while ( num_entries > 1
+                && ( num_entries > max_entries || ( max_bytes != 0 && num_bytes > max_bytes)))
+        {
+            remove_unit( entries.last());
+            num_evictions++;
+        }
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    bool LruCache<K, V, Hash, Eq>::erase( const K& key)
+    {
+        Unit *u = table[ find_slot( key, hash_of( key))].unit;
+
+        if ( isNullP( u))
+            return false;
+        remove_unit( u);
+        return true;
+    }
+
+    template <class K, class V, class Hash, class Eq>
+    void LruCache<K, V, Hash, Eq>::clear()
+    {
+        for ( size_t i = 0; i < table.size(); i++)
+        {
+            table[ i].unit = NULL;
+        }
+        entries.clear();
+        num_entries = 0;
+        num_bytes = 0;
+    }
+};
+
+#endif /* TASK_LRU_CACHE_H */
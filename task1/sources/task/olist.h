@@ -0,0 +1,522 @@
+/**
+ * @file: task/olist.h
+ * Doubly connected list with positional access in O(log n)
+ */
+#pragma once
+
+#ifndef TASK_OLIST_H
+#define TASK_OLIST_H
+
+namespace Task
+{
+    //
+    // Doubly connected list with an order-statistics index
+    // @param T type of the stored values
+    // @param AllocPolicy policy that provides memory for the list units, same as for DList
+    //
+    // Besides the list links every unit is a node of a treap (randomized balanced
+    // binary tree) ordered by the list positions. A node keeps the number of units in
+    // its subtree, which gives at(k), insert_at(k, v) and index_of(u) in O(log n)
+    // expected time. Insert and erase update the tree in O(log n) too, while walking
+    // with next()/prev() doesn't touch it.
+    //
+    // This is a separate container, DList doesn't pay anything for the index.
+    //
+    template <class T, template <class U> class AllocPolicy = UnitPool> class ODList
+    {
+    public:
+        //
+        // List unit
+        //
+        class Unit
+        {
+            friend class ODList;
+
+        public:
+            Unit *next(); // Get the next unit in list
+            Unit *prev(); // Get the previous unit in list
+            T& val();     // Get the reference to the unit's value
+        private:
+            template <class... Args> Unit( Args&&... args);//constructor, builds the value from args in place
+
+            T unit_value;
+            Unit *unit_prev;
+            Unit *unit_next;
+
+            // Tree part
+            Unit *parent;
+            Unit *left;
+            Unit *right;
+            UInt32 weight;   // Number of units in the subtree
+            UInt32 priority; // Random, a parent has a smaller priority than its children
+        };
+
+        typedef AllocPolicy<Unit> Allocator; // Unit memory provider
+
+        // ---- Public interface of ODList ----
+        ODList(); //< Constructor
+        ~ODList();//< Destructor
+
+        void push_front (const T& val);// Insert one unit with given value at front
+        void push_front (T&& val);     // Insert one unit at front moving the value into it
+        void pop_front();// Remove one unit at front of the list
+        void push_back (const T& val);        // Insert one unit with given value to back
+        void push_back (T&& val);             // Insert one unit to back moving the value into it
+        void pop_back();                      // Remove one unit from the back of the list
+        Unit* insert (Unit* u, const T& val); // Insert one unit before the given one
+        Unit* insert (Unit* u, T&& val);      // Insert one unit before the given one moving the value into it
+
+        // Construct the value in place from the given constructor arguments
+        template <class... Args> void emplace_front (Args&&... args); // Insert at front
+        template <class... Args> void emplace_back (Args&&... args);  // Insert to back
+        template <class... Args> Unit* emplace (Unit* u, Args&&... args); // Insert before the given unit
+
+        Unit* first(); // Get first unit
+        Unit* last();  // Get last unit
+
+        Unit* erase (Unit* u); // Remove given unit from list, return next unit or null
+        void clear();          // Remove all units
+        bool empty();          // Check if list is empty. Returns true if empty, false otherwise
+        unsigned size();       // Get the number of units in the list
+
+        // Positional access, O(log n)
+        Unit* at( unsigned k);                     // Get the unit at position k, null if k >= size()
+        Unit* insert_at( unsigned k, const T& val);// Insert unit so that it gets position k, k <= size()
+        Unit* insert_at( unsigned k, T&& val);     // Same, moving the value into the unit
+        unsigned index_of( Unit* u);               // Get position of the unit in the list
+
+    private:
+        // ---- The internal implementation routines ----
+        template <class... Args> Unit* create_unit( Args&&... args); // Allocate and construct a detached unit
+        void destroy_unit( Unit* u);           // Destruct the unit and release its memory
+        void link_before( Unit* u, Unit* pos); // Link detached unit before pos (at back if pos is null)
+        void unlink( Unit* u);                 // Detach unit from the list and the tree
+
+        static inline UInt32 weight_of( Unit* u); // Subtree size, 0 for null
+        static inline void update_weight( Unit* u);
+        void replace_child( Unit* p, Unit* old_child, Unit* new_child); // Replace child in p, or the root if p is null
+        void rotate_up( Unit* u);              // Rotate u above its parent
+        UInt32 next_priority();                // Pseudo-random priority for a new unit
+
+        // ---- Default copy constructor and assignment turned off ----
+        ODList( const ODList& list);
+        ODList& operator = ( const ODList& list);
+
+        // ---- The data involved in the implementation ----
+        Unit *head;
+        Unit *tail;
+        Unit *root;
+        UInt32 random_state;
+        Allocator alloc;
+    };
+
+// ---- ODList::Unit implementation ----
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    ODList<T, AllocPolicy>::Unit::Unit( Args&&... args):
+        unit_value( std::forward<Args>( args)...),
+        unit_prev( NULL),
+        unit_next( NULL),
+        parent( NULL),
+        left( NULL),
+        right( NULL),
+        weight( 1),
+        priority( 0)
+    {
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::Unit::next()
+    {
+        return unit_next;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::Unit::prev()
+    {
+        return unit_prev;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    T& ODList<T, AllocPolicy>::Unit::val()
+    {
+        return unit_value;
+    }
+
+// ---- ODList implementation ----
+
+    template <class T, template <class U> class AllocPolicy>
+    ODList<T, AllocPolicy>::ODList():
+        head( NULL),
+        tail( NULL),
+        root( NULL),
+        random_state( 2463534242u)
+    {
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    ODList<T, AllocPolicy>::~ODList()
+    {
+        clear();
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::create_unit( Args&&... args)
+    {
+        void *mem = alloc.allocate();
+        try
+        {
+            return new ( mem) Unit( std::forward<Args>( args)...);
+        } catch ( ...)
+        {
+            alloc.deallocate( mem);
+            throw;
+        }
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::destroy_unit( Unit* u)
+    {
+        u->~Unit();
+        alloc.deallocate( u);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    UInt32 ODList<T, AllocPolicy>::weight_of( Unit* u)
+    {
+        return isNotNullP( u) ? u->weight : 0;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::update_weight( Unit* u)
+    {
+        u->weight = 1 + weight_of( u->left) + weight_of( u->right);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    UInt32 ODList<T, AllocPolicy>::next_priority()
+    {
+        // xorshift
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 17;
+        random_state ^= random_state << 5;
+        return random_state;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::replace_child( Unit* p, Unit* old_child, Unit* new_child)
+    {
+        if ( isNullP( p))
+            root = new_child;
+        else if ( areEqP( p->left, old_child))
+            p->left = new_child;
+        else
+            p->right = new_child;
+
+        if ( isNotNullP( new_child))
+            new_child->parent = p;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::rotate_up( Unit* u)
+    {
+        Unit *p = u->parent;
+
+        replace_child( p->parent, p, u);
+        if ( areEqP( p->left, u))
+        {
+            p->left = u->right;
+            if ( isNotNullP( p->left))
+                p->left->parent = p;
+            u->right = p;
+        } else
+        {
+            p->right = u->left;
+            if ( isNotNullP( p->right))
+                p->right->parent = p;
+            u->left = p;
+        }
+        p->parent = u;
+        update_weight( p);
+        update_weight( u);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::link_before( Unit* u, Unit* pos)
+    {
+        Unit *prev = isNotNullP( pos) ? pos->unit_prev : tail;
+
+        u->unit_prev = prev;
+        u->unit_next = pos;
+        if ( isNotNullP( prev))
+            prev->unit_next = u;
+        else
+            head = u;
+        if ( isNotNullP( pos))
+            pos->unit_prev = u;
+        else
+            tail = u;
+
+        // In-order predecessor of pos is either its left subtree's rightmost node, which is
+        // prev, or pos has no left child. Either way there is a free leaf place next to it
+        if ( isNotNullP( pos) && isNullP( pos->left))
+        {
+            pos->left = u;
+            u->parent = pos;
+        } else if ( isNotNullP( prev))
+        {
+            prev->right = u;
+            u->parent = prev;
+        } else
+        {
+            root = u;
+        }
+        for ( Unit *p = u->parent; isNotNullP( p); p = p->parent)
+        {
+            p->weight++;
+        }
+
+        u->priority = next_priority();
+        while ( isNotNullP( u->parent) && u->priority < u->parent->priority)
+        {
+            rotate_up( u);
+        }
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::unlink( Unit* u)
+    {
+        // Rotate the unit down until it has at most one child, then cut it out
+        while ( isNotNullP( u->left) && isNotNullP( u->right))
+        {
+            rotate_up( u->left->priority < u->right->priority ? u->left : u->right);
+        }
+        Unit *child = isNotNullP( u->left) ? u->left : u->right;
+        Unit *p = u->parent;
+
+        replace_child( p, u, child);
+        for ( ; isNotNullP( p); p = p->parent)
+        {
+            p->weight--;
+        }
+
+        if ( isNotNullP( u->unit_prev))
+            u->unit_prev->unit_next = u->unit_next;
+        else
+            head = u->unit_next;
+        if ( isNotNullP( u->unit_next))
+            u->unit_next->unit_prev = u->unit_prev;
+        else
+            tail = u->unit_prev;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::push_front( const T& val)
+    {
+        link_before( create_unit( val), head);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::push_front( T&& val)
+    {
+        link_before( create_unit( std::move( val)), head);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    void ODList<T, AllocPolicy>::emplace_front( Args&&... args)
+    {
+        link_before( create_unit( std::forward<Args>( args)...), head);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::pop_front()
+    {
+        if ( isNotNullP( head))
+            erase( head);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::push_back( const T& val)
+    {
+        link_before( create_unit( val), NULL);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::push_back( T&& val)
+    {
+        link_before( create_unit( std::move( val)), NULL);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    void ODList<T, AllocPolicy>::emplace_back( Args&&... args)
+    {
+        link_before( create_unit( std::forward<Args>( args)...), NULL);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::pop_back()
+    {
+        if ( isNotNullP( tail))
+            erase( tail);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::insert( Unit* u, const T& val)
+    {
+        Unit *new_unit = create_unit( val);
+        link_before( new_unit, u);
+        return new_unit;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::insert( Unit* u, T&& val)
+    {
+        Unit *new_unit = create_unit( std::move( val));
+        link_before( new_unit, u);
+        return new_unit;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    template <class... Args>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::emplace( Unit* u, Args&&... args)
+    {
+        Unit *new_unit = create_unit( std::forward<Args>( args)...);
+        link_before( new_unit, u);
+        return new_unit;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::first()
+    {
+        return head;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::last()
+    {
+        return tail;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::erase( Unit* u)
+    {
+        DLIST_ASSERTXD( isNotNullP( u), "Erasing null unit");
+        Unit *next = u->unit_next;
+
+        unlink( u);
+        destroy_unit( u);
+        return next;
+    }
+
+    // Same bulk teardown as in DList::clear()
+    template <class T, template <class U> class AllocPolicy>
+    void ODList<T, AllocPolicy>::clear()
+    {
+        if ( isNotNullP( head) && alloc.exclusive())
+        {
+            if ( !std::is_trivially_destructible<T>::value)
+            {
+                for ( Unit *u = head; isNotNullP( u); )
+                {
+                    Unit *next = u->unit_next;
+                    u->~Unit();
+                    u = next;
+                }
+            }
+            alloc.deallocate_all();
+        } else
+        {
+            for ( Unit *u = head; isNotNullP( u); )
+            {
+                Unit *next = u->unit_next;
+                destroy_unit( u);
+                u = next;
+            }
+        }
+        head = NULL;
+        tail = NULL;
+        root = NULL;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    bool ODList<T, AllocPolicy>::empty()
+    {
+        return isNullP( root);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    unsigned ODList<T, AllocPolicy>::size()
+    {
+        return weight_of( root);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::at( unsigned k)
+    {
+        Unit *u = root;
+
+        while ( isNotNullP( u))
+        {
+            UInt32 num_left = weight_of( u->left);
+
+            if ( k < num_left)
+            {
+                u = u->left;
+            } else if ( k == num_left)
+            {
+                return u;
+            } else
+            {
+                k -= num_left + 1;
+                u = u->right;
+            }
+        }
+        return NULL;
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::insert_at( unsigned k, const T& val)
+    {
+        DLIST_ASSERTXD( k <= size(), "Insert position is out of the list");
+        return insert( at( k), val);
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    typename ODList<T, AllocPolicy>::Unit *
+    ODList<T, AllocPolicy>::insert_at( unsigned k, T&& val)
+    {
+        DLIST_ASSERTXD( k <= size(), "Insert position is out of the list");
+        return insert( at( k), std::move( val));
+    }
+
+    template <class T, template <class U> class AllocPolicy>
+    unsigned ODList<T, AllocPolicy>::index_of( Unit* u)
+    {
+        DLIST_ASSERTXD( isNotNullP( u), "Index of null unit");
+        unsigned k = weight_of( u->left);
+
+        for ( ; isNotNullP( u->parent); u = u->parent)
+        {
+            if ( areEqP( u->parent->right, u))
+                k += weight_of( u->parent->left) + 1;
+        }
+        return k;
+    }
+};
+
+#endif /* TASK_OLIST_H */
@@ -0,0 +1,571 @@
+/**
+ * @file: task/perf.cpp
+ * Performance measurements of the task 1 lists
+ */
+#include "iface.h"
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+#include <thread>
+
+namespace Task
+{
+    // Number of elements in the measured lists
+#ifdef _DEBUG
+    static const UInt32 PERF_LIST_SIZE = 100000;
+#else
+    static const UInt32 PERF_LIST_SIZE = 1000000;
+#endif
+
+    // Largest list in sort measurements, define TASK_PERF_LARGE to measure 10x bigger lists
+#ifdef TASK_PERF_LARGE
+    static const UInt32 PERF_SORT_MAX_SIZE = PERF_LIST_SIZE * 10;
+#else
+    static const UInt32 PERF_SORT_MAX_SIZE = PERF_LIST_SIZE;
+#endif
+
+    // Timings of one list type
+    struct PerfTimes
+    {
+        UInt32 push;
+        UInt32 erase;
+        UInt32 teardown;
+    };
+
+    // Print timings of one list type
+    static void printTimes( UnitTest *utest_p, const char *name, const PerfTimes& t)
+    {
+        utest_p->out() << endl << "    " << std::left << std::setw( 16) << std::setfill( ' ') << name
+                       << " push " << std::right << std::setw( 8) << t.push << " uSec,"
+                       << " erase " << std::setw( 8) << t.erase << " uSec,"
+                       << " teardown " << std::setw( 8) << t.teardown << " uSec";
+    }
+
+    // Push, erase every other element and teardown for DList with the given allocation policy
+    template <template <class U> class AllocPolicy>
+    static PerfTimes measureDList( UnitTest *utest_p)
+    {
+        typedef DList<UInt32, AllocPolicy> L;
+        PerfTimes t;
+        Timer timer;
+        L *list = new L;
+
+        timer.start();
+        for ( UInt32 i = 0; i < PERF_LIST_SIZE; i++)
+        {
+            list->push_back( i);
+        }
+        t.push = timer.elapsedUSec();
+
+        timer.start();
+        for ( typename L::Unit *u = list->first(); isNotNullP( u); )
+        {
+            u = list->erase( u);
+            if ( isNotNullP( u))
+                u = u->next();
+        }
+        t.erase = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, list->size() == PERF_LIST_SIZE / 2);
+
+        timer.start();
+        delete list;
+        t.teardown = timer.elapsedUSec();
+        return t;
+    }
+
+    // Same measurement for std::list as a reference
+    static PerfTimes measureStdList( UnitTest *utest_p)
+    {
+        typedef std::list<UInt32> L;
+        PerfTimes t;
+        Timer timer;
+        L *list = new L;
+
+        timer.start();
+        for ( UInt32 i = 0; i < PERF_LIST_SIZE; i++)
+        {
+            list->push_back( i);
+        }
+        t.push = timer.elapsedUSec();
+
+        timer.start();
+        for ( L::iterator it = list->begin(); it != list->end(); )
+        {
+            it = list->erase( it);
+            if ( it != list->end())
+                ++it;
+        }
+        t.erase = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, list->size() == PERF_LIST_SIZE / 2);
+
+        timer.start();
+        delete list;
+        t.teardown = timer.elapsedUSec();
+        return t;
+    }
+
+    // Sum the list values walking it with Unit::next()
+    template <class L> static UInt32 measureWalk( UnitTest *utest_p, L& list)
+    {
+        Timer timer( true);
+        UInt32 sum = 0;
+
+        for ( typename L::Unit *u = list.first(); isNotNullP( u); u = u->next())
+        {
+            sum += u->val();
+        }
+        UInt32 t = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, sum == ( UInt32)( ( UInt64)PERF_LIST_SIZE * ( PERF_LIST_SIZE - 1) / 2));
+        return t;
+    }
+
+    // Build the list by pushing at both ends, so that consecutive units are not neighbours in memory
+    template <class L> static void fillBothEnds( L& list)
+    {
+        for ( UInt32 i = 0; i < PERF_LIST_SIZE / 2; i++)
+        {
+            list.push_front( PERF_LIST_SIZE / 2 - 1 - i);
+            list.push_back( PERF_LIST_SIZE / 2 + i);
+        }
+    }
+
+    // Pseudo-random value sequence (xorshift) to keep the measurements reproducible
+    static inline UInt32 nextRandom( UInt32& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Compare DList::sort with copying the values to a vector, sorting it and rebuilding the list
+    static void measureSort( UnitTest *utest_p, UInt32 num)
+    {
+        DList<UInt32> list;
+        DList<UInt32> copy_sorted;
+        UInt32 state = 2463534242u;
+        Timer timer;
+
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            UInt32 val = nextRandom( state);
+            list.push_back( val);
+            copy_sorted.push_back( val);
+        }
+
+        timer.start();
+        list.sort();
+        UInt32 sort_time = timer.elapsedUSec();
+
+        timer.start();
+        std::vector<UInt32> vec;
+        vec.reserve( copy_sorted.size());
+        for ( DList<UInt32>::Unit *u = copy_sorted.first(); isNotNullP( u); u = u->next())
+        {
+            vec.push_back( u->val());
+        }
+        std::sort( vec.begin(), vec.end());
+        copy_sorted.clear();
+        for ( size_t i = 0; i < vec.size(); i++)
+        {
+            copy_sorted.push_back( vec[ i]);
+        }
+        UInt32 copy_time = timer.elapsedUSec();
+
+        bool same = list.size() == copy_sorted.size();
+        for ( DList<UInt32>::Unit *u = list.first(), *v = copy_sorted.first();
+              same && isNotNullP( u); u = u->next(), v = v->next())
+        {
+            same = u->val() == v->val();
+        }
+        UTEST_CHECK( utest_p, same);
+
+        utest_p->out() << endl << "    sort " << std::setw( 8) << num << " elements: in place "
+                       << std::setw( 8) << sort_time << " uSec, copy-sort-rebuild " << std::setw( 8) << copy_time << " uSec";
+    }
+
+    // Positional access in ODList against walking DList from the first unit
+    static void measureIndexed( UnitTest *utest_p, DList<UInt32>& list)
+    {
+        const UInt32 NUM_LOOKUPS = 100;
+        ODList<UInt32> olist;
+        UInt32 state = 2463534242u;
+        UInt64 sum_walk = 0;
+        UInt64 sum_at = 0;
+        Timer timer;
+
+        for ( DList<UInt32>::Unit *u = list.first(); isNotNullP( u); u = u->next())
+        {
+            olist.push_back( u->val());
+        }
+
+        timer.start();
+        for ( UInt32 i = 0; i < NUM_LOOKUPS; i++)
+        {
+            UInt32 k = nextRandom( state) % list.size();
+            DList<UInt32>::Unit *u = list.first();
+            while ( k-- > 0)
+            {
+                u = u->next();
+            }
+            sum_walk += u->val();
+        }
+        UInt32 walk_time = timer.elapsedUSec();
+
+        state = 2463534242u;
+        timer.start();
+        for ( UInt32 i = 0; i < NUM_LOOKUPS; i++)
+        {
+            sum_at += olist.at( nextRandom( state) % olist.size())->val();
+        }
+        UInt32 at_time = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, sum_walk == sum_at);
+        utest_p->out() << endl << "    " << NUM_LOOKUPS << " x at(k): ODList " << at_time << " uSec,"
+                       << " DList walk " << walk_time << " uSec";
+    }
+
+    // Remove every value but each fourth one with remove_if against single erases
+    static void measureFilter( UnitTest *utest_p)
+    {
+        DList<UInt32> filtered;
+        DList<UInt32> erased;
+        Timer timer;
+
+        for ( UInt32 i = 0; i < PERF_LIST_SIZE; i++)
+        {
+            filtered.push_back( i);
+            erased.push_back( i);
+        }
+
+        timer.start();
+        unsigned num = filtered.remove_if( []( UInt32 v){ return v % 4 != 0; });
+        UInt32 remove_time = timer.elapsedUSec();
+
+        timer.start();
+        for ( DList<UInt32>::Unit *u = erased.first(); isNotNullP( u); )
+        {
+            u = ( u->val() % 4 != 0) ? erased.erase( u) : u->next();
+        }
+        UInt32 erase_time = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, num == PERF_LIST_SIZE - PERF_LIST_SIZE / 4);
+        UTEST_CHECK( utest_p, std::equal( filtered.begin(), filtered.end(), erased.begin()));
+        utest_p->out() << endl << "    filter 3/4 of " << PERF_LIST_SIZE << " elements: remove_if "
+                       << remove_time << " uSec, erase loop " << erase_time << " uSec";
+    }
+
+    // Save the list and load it back with DList::load against reading it value by value with push_back
+    static void measureSnapshot( UnitTest *utest_p, DList<UInt32>& list)
+    {
+        const char *path = "dlist_perf.bin";
+        Timer timer( true);
+
+        UTEST_CHECK( utest_p, list.save( path));
+        UInt32 save_time = timer.elapsedUSec();
+
+        DList<UInt32> loaded;
+        timer.start();
+        UTEST_CHECK( utest_p, loaded.load( path));
+        UInt32 load_time = timer.elapsedUSec();
+
+        DList<UInt32> read;
+        timer.start();
+        {
+            std::ifstream is( path, std::ios::in | std::ios::binary);
+            ListFileHeader header;
+            UInt32 val;
+
+            is.read( reinterpret_cast<char *>( &header), sizeof( header));
+            while ( is.read( reinterpret_cast<char *>( &val), sizeof( val)))
+            {
+                read.push_back( val);
+            }
+        }
+        UInt32 read_time = timer.elapsedUSec();
+        std::remove( path);
+
+        UTEST_CHECK( utest_p, loaded.size() == list.size() && read.size() == list.size());
+        UTEST_CHECK( utest_p, std::equal( loaded.begin(), loaded.end(), list.begin()));
+        utest_p->out() << endl << "    snapshot " << list.size() << " elements: save " << save_time << " uSec,"
+                       << " mapped load " << load_time << " uSec, stream read + push_back " << read_time << " uSec";
+    }
+
+    // Fill the list with num copies of val and measure its destruction
+    template <class L, class V> static UInt32 measureTeardown( L *list, UInt32 num, const V& val)
+    {
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            list->push_back( val);
+        }
+        Timer timer( true);
+        delete list;
+        return timer.elapsedUSec();
+    }
+
+    // Teardown of pool-backed DList (whole chunks released), DList sharing its pool with
+    // another list (units freed one by one), heap DList and std::list
+    template <class V> static void measureTeardowns( UnitTest *utest_p, const char *name, const V& val)
+    {
+        DList<V> peer;
+        peer.push_back( val);
+
+        UInt32 t_pool = measureTeardown( new DList<V>, PERF_LIST_SIZE, val);
+        UInt32 t_shared = measureTeardown( new DList<V>( peer.allocator()), PERF_LIST_SIZE, val);
+        UInt32 t_heap = measureTeardown( new DList<V, UnitHeap>, PERF_LIST_SIZE, val);
+        UInt32 t_std = measureTeardown( new std::list<V>, PERF_LIST_SIZE, val);
+
+        UTEST_CHECK( utest_p, peer.size() == 1 && peer.first()->val() == val);
+        utest_p->out() << endl << "    teardown " << std::left << std::setw( 8) << name << std::right
+                       << " DList(pool) " << std::setw( 7) << t_pool << " uSec,"
+                       << " DList(shared pool) " << std::setw( 7) << t_shared << " uSec,"
+                       << " DList(heap) " << std::setw( 7) << t_heap << " uSec,"
+                       << " std::list " << std::setw( 7) << t_std << " uSec";
+    }
+
+    bool uTestPerf( UnitTest *utest_p)
+    {
+        // Warm up the heap so that the first measured list doesn't pay for page faults
+        measureStdList( utest_p);
+
+        utest_p->out() << endl << "    " << PERF_LIST_SIZE << " elements:";
+
+        printTimes( utest_p, "DList(pool)", measureDList<UnitPool>( utest_p));
+        printTimes( utest_p, "DList(heap)", measureDList<UnitHeap>( utest_p));
+        printTimes( utest_p, "std::list", measureStdList( utest_p));
+
+        measureTeardowns( utest_p, "UInt32", ( UInt32)1);
+        measureTeardowns( utest_p, "string", std::string( "a string that doesn't fit in place"));
+
+        DList<UInt32> list;
+        UDList<UInt32> ulist;
+        IDList<UInt32> ilist;
+        fillBothEnds( list);
+        fillBothEnds( ulist);
+        fillBothEnds( ilist);
+
+        utest_p->out() << endl << "    walk DList " << measureWalk( utest_p, list) << " uSec,"
+                       << " UDList " << measureWalk( utest_p, ulist) << " uSec,"
+                       << " IDList " << measureWalk( utest_p, ilist) << " uSec";
+        UInt32 sum = 0;
+        Timer timer( true);
+        list.for_each( [&sum]( UInt32 v){ sum += v; });
+        UInt32 for_each_time = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, sum == ( UInt32)( ( UInt64)PERF_LIST_SIZE * ( PERF_LIST_SIZE - 1) / 2));
+        utest_p->out() << endl << "    walk DList with for_each " << for_each_time << " uSec";
+        utest_p->out() << endl << "    bytes per unit DList " << sizeof( DList<UInt32>::Unit)
+                       << ", IDList " << sizeof( IDList<UInt32>::Unit);
+
+        measureIndexed( utest_p, list);
+
+        // reverse() only flips the direction, the units are relinked once by the next first()
+        timer.start();
+        for ( UInt32 i = 0; i < 1001; i++)
+        {
+            list.reverse();
+        }
+        UInt32 reverse_time = timer.elapsedUSec();
+
+        timer.start();
+        UTEST_CHECK( utest_p, list.first()->val() == PERF_LIST_SIZE - 1);
+        UInt32 relink_time = timer.elapsedUSec();
+
+        utest_p->out() << endl << "    reverse DList x1001 " << reverse_time << " uSec,"
+                       << " relink on first() " << relink_time << " uSec";
+
+        measureSnapshot( utest_p, list);
+        measureFilter( utest_p);
+
+        for ( UInt32 num = PERF_LIST_SIZE / 10; num <= PERF_SORT_MAX_SIZE; num *= 10)
+        {
+            measureSort( utest_p, num);
+        }
+
+        utest_p->out() << endl;
+        return utest_p->result();
+    }
+
+    // Reference LRU cache made of std::list and std::unordered_map
+    class StdLruCache
+    {
+    public:
+        explicit StdLruCache( size_t max_num): max_entries( max_num){}
+
+        UInt32 *get( UInt32 key)
+        {
+            std::unordered_map<UInt32, std::list<std::pair<UInt32, UInt32> >::iterator>::iterator it = index.find( key);
+            if ( it == index.end())
+                return NULL;
+            entries.splice( entries.begin(), entries, it->second);
+            return &it->second->second;
+        }
+        void put( UInt32 key, UInt32 val)
+        {
+            entries.push_front( std::make_pair( key, val));
+            index[ key] = entries.begin();
+            if ( entries.size() > max_entries)
+            {
+                index.erase( entries.back().first);
+                entries.pop_back();
+            }
+        }
+    private:
+        size_t max_entries;
+        std::list<std::pair<UInt32, UInt32> > entries;
+        std::unordered_map<UInt32, std::list<std::pair<UInt32, UInt32> >::iterator> index;
+    };
+
+    // Keys from 0 to num - 1 where key k has probability proportional to 1 / (k + 1)^s
+    class ZipfKeys
+    {
+    public:
+        ZipfKeys( UInt32 num, double s): cdf( num), state( 2463534242u)
+        {
+            double sum = 0;
+            for ( UInt32 k = 0; k < num; k++)
+            {
+                sum += 1.0 / pow( k + 1.0, s);
+                cdf[ k] = sum;
+            }
+            for ( UInt32 k = 0; k < num; k++)
+            {
+                cdf[ k] /= sum;
+            }
+        }
+        UInt32 next()
+        {
+            double u = nextRandom( state) / 4294967296.0;
+            return ( UInt32)( std::lower_bound( cdf.begin(), cdf.end(), u) - cdf.begin());
+        }
+    private:
+        std::vector<double> cdf;
+        UInt32 state;
+    };
+
+    // Look up every key of the stream and put it on a miss, returns the time
+    template <class Cache> static UInt32 measureCache( Cache& cache, const std::vector<UInt32>& keys)
+    {
+        Timer timer( true);
+        for ( size_t i = 0; i < keys.size(); i++)
+        {
+            if ( isNullP( cache.get( keys[ i])))
+                cache.put( keys[ i], keys[ i]);
+        }
+        return timer.elapsedUSec();
+    }
+
+    bool uTestLruPerf( UnitTest *utest_p)
+    {
+        const UInt32 NUM_KEYS = PERF_LIST_SIZE / 10;
+        ZipfKeys zipf( NUM_KEYS, 0.99);
+        std::vector<UInt32> keys( PERF_LIST_SIZE);
+
+        for ( UInt32 i = 0; i < PERF_LIST_SIZE; i++)
+        {
+            keys[ i] = zipf.next();
+        }
+        utest_p->out() << endl << "    " << PERF_LIST_SIZE << " Zipf(0.99) lookups over " << NUM_KEYS << " keys:";
+
+        for ( UInt32 capacity = NUM_KEYS / 100; capacity <= NUM_KEYS / 10; capacity *= 10)
+        {
+            LruCache<UInt32, UInt32> cache( capacity);
+            StdLruCache std_cache( capacity);
+            UInt32 t_cache = measureCache( cache, keys);
+            UInt32 t_std = measureCache( std_cache, keys);
+
+            UTEST_CHECK( utest_p, cache.hits() + cache.misses() == PERF_LIST_SIZE);
+            utest_p->out() << endl << "    capacity " << std::setw( 6) << capacity
+                           << " hit rate " << std::setw( 3) << ( UInt32)( 100 * cache.hits() / PERF_LIST_SIZE) << "%,"
+                           << " LruCache " << std::setw( 7) << t_cache << " uSec,"
+                           << " std::list + unordered_map " << std::setw( 7) << t_std << " uSec";
+        }
+        utest_p->out() << endl;
+        return utest_p->result();
+    }
+
+    // DList guarded by a mutex, the reference for the concurrent queue
+    class LockedList
+    {
+    public:
+        void push_back( UInt32 val)
+        {
+            std::lock_guard<std::mutex> guard( lock);
+            list.push_back( val);
+        }
+        bool pop_front( UInt32& val)
+        {
+            std::lock_guard<std::mutex> guard( lock);
+            if ( list.empty())
+                return false;
+            val = list.first()->val();
+            list.pop_front();
+            return true;
+        }
+    private:
+        std::mutex lock;
+        DList<UInt32> list;
+    };
+
+    // Push PERF_LIST_SIZE values from the given number of producer threads and pop them in this thread.
+    // Returns wall clock time in microseconds, Utils::Timer measures process CPU time which sums all threads
+    template <class Q> static UInt32 measureQueue( UnitTest *utest_p, UInt32 num_producers)
+    {
+        Q queue;
+        UInt32 per_producer = PERF_LIST_SIZE / num_producers;
+        UInt32 num = per_producer * num_producers;
+        UInt64 sum = 0;
+        UInt32 val = 0;
+        std::vector<std::thread> threads;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for ( UInt32 i = 0; i < num_producers; i++)
+        {
+            threads.push_back( std::thread( [&queue, per_producer]()
+            {
+                for ( UInt32 k = 0; k < per_producer; k++)
+                {
+                    queue.push_back( k);
+                }
+            }));
+        }
+        for ( UInt32 popped = 0; popped < num; )
+        {
+            if ( queue.pop_front( val))
+            {
+                sum += val;
+                popped++;
+            }
+        }
+        for ( size_t i = 0; i < threads.size(); i++)
+        {
+            threads[ i].join();
+        }
+        std::chrono::steady_clock::duration t = std::chrono::steady_clock::now() - start;
+
+        UTEST_CHECK( utest_p, sum == ( UInt64)num_producers * per_producer * ( per_producer - 1) / 2);
+        return ( UInt32)std::chrono::duration_cast<std::chrono::microseconds>( t).count();
+    }
+
+    bool uTestQueuePerf( UnitTest *utest_p)
+    {
+        utest_p->out() << endl << "    " << PERF_LIST_SIZE << " values, one consumer:";
+
+        for ( UInt32 num_producers = 1; num_producers <= 8; num_producers *= 2)
+        {
+            UInt32 t_queue = measureQueue<CQueue<UInt32> >( utest_p, num_producers);
+            UInt32 t_mpmc = measureQueue<CQueue<UInt32, QUEUE_MPMC> >( utest_p, num_producers);
+            UInt32 t_locked = measureQueue<LockedList>( utest_p, num_producers);
+
+            utest_p->out() << endl << "    " << num_producers << " producers:"
+                           << " CQueue(MPSC) " << std::setw( 8) << t_queue << " uSec,"
+                           << " CQueue(MPMC) " << std::setw( 8) << t_mpmc << " uSec,"
+                           << " locked DList " << std::setw( 8) << t_locked << " uSec";
+        }
+        utest_p->out() << endl;
+        return utest_p->result();
+    }
+};
@@ -0,0 +1,492 @@
+/**
+ * @file: task/ulist.h
+ * Unrolled doubly connected list: every node keeps a small array of values
+ */
+#pragma once
+
+#ifndef TASK_ULIST_H
+#define TASK_ULIST_H
+
+namespace Task
+{
+    //
+    // Unrolled doubly connected list
+    // @param T type of the stored values
+    // @param node_bytes size of one node in bytes, must be a power of 2
+    //
+    // The interface mirrors DList: units are walked with first()/next() and the
+    // value is accessed by val(). A unit is a slot inside a node, so walking the
+    // list mostly touches consecutive memory. Nodes are aligned on their size,
+    // which lets a unit find its node from its own address.
+    //
+    // Note: as the values are kept in arrays, insert() and erase() may move the
+    // other values of the same node. Unit pointers into that node should not be
+    // kept across these operations, only the returned ones are valid.
+    //
+    template <class T, UInt32 node_bytes = 256> class UDList
+    {
+    public:
+        //
+        // List unit, a slot in the node's array
+        //
+        class Unit
+        {
+            friend class UDList;
+
+        public:
+            Unit *next(); // Get the next unit in list
+            Unit *prev(); // Get the previous unit in list
+            T& val();     // Get the reference to the unit's value
+        private:
+            template <class... Args> Unit( Args&&... args);//constructor, builds the value from args in place
+
+            T unit_value;
+        };
+
+        // ---- Public interface of UDList ----
+        UDList(); //< Constructor
+        ~UDList();//< Destructor
+
+        void push_front (const T& val);// Insert one unit with given value at front
+        void push_front (T&& val);     // Insert one unit at front moving the value into it
+        void pop_front();// Remove one unit at front of the list
+        void push_back (const T& val);        // Insert one unit with given value to back
+        void push_back (T&& val);             // Insert one unit to back moving the value into it
+        void pop_back();                      // Remove one unit from the back of the list
+        Unit* insert (Unit* u, const T& val); // Insert one unit before the given one
+        Unit* insert (Unit* u, T&& val);      // Insert one unit before the given one moving the value into it
+
+        // Construct the value in place from the given constructor arguments
+        template <class... Args> void emplace_front (Args&&... args); // Insert at front
+        template <class... Args> void emplace_back (Args&&... args);  // Insert to back
+        template <class... Args> Unit* emplace (Unit* u, Args&&... args); // Insert before the given unit
+
+        Unit* first(); // Get first unit
+        Unit* last();  // Get last unit
+
+        Unit* erase (Unit* u); // Remove given unit from list, return next unit or null
+        void clear();          // Remove all units
+        bool empty();          // Check if list is empty. Returns true if empty, false otherwise
+        unsigned size();       // Get the number of units in the list
+        void reverse();        // Reverse the order of units in the list
+    private:
+        //
+        // Node header, the units array follows it in the same memory block.
+        // Units occupy [lo, hi) range of the array
+        //
+        struct Node
+        {
+            Node *prev;
+            Node *next;
+            UInt32 lo;
+            UInt32 hi;
+        };
+
+        // Offset of the units array from the node start
+        static const size_t UNITS_OFFSET = ( sizeof( Node) + alignof( Unit) - 1) / alignof( Unit) * alignof( Unit);
+    public:
+        // Number of units in one node
+        static const UInt32 NODE_CAPACITY = ( UInt32)( ( node_bytes - UNITS_OFFSET) / sizeof( Unit));
+    private:
+        static_assert( ( node_bytes & ( node_bytes - 1)) == 0, "Node size must be a power of 2");
+        static_assert( NODE_CAPACITY >= 2, "Node size is too small for the value type");
+
+        // ---- The internal implementation routines ----
+        static inline Node *node_of( Unit *u);            // Get the node that holds the unit
+        static inline Unit *unit_at( Node *n, UInt32 i);  // Get the unit slot by its index
+        static inline UInt32 index_of( Node *n, Unit *u); // Get the index of the unit in node
+        static inline void relocate( Unit *to, Unit *from); // Move the value to an empty slot
+
+        Node *create_node( Node *after, UInt32 pos);   // Allocate empty node and link it after the given one
+        void destroy_node( Node *n);                   // Unlink node and release its memory
+        Node *split( Node *n);                         // Move upper half of a full node to a new node
+
+        // ---- Default copy constructor and assignment turned off ----
+        UDList( const UDList& list);
+        UDList& operator = ( const UDList& list);
+
+        // ---- The data involved in the implementation ----
+        Node *head;
+        Node *tail;
+        unsigned size_of_list;
+    };
+
+// ---- UDList::Unit implementation ----
+
+    template <class T, UInt32 node_bytes>
+    template <class... Args>
+    UDList<T, node_bytes>::Unit::Unit( Args&&... args): unit_value( std::forward<Args>( args)...)
+    {
+    }
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::Unit::next()
+    {
+        Node *n = node_of( this);
+
+        if ( index_of( n, this) + 1 < n->hi)
+            return this + 1;
+
+        return isNotNullP( n->next) ? unit_at( n->next, n->next->lo) : NULL;
+    }
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::Unit::prev()
+    {
+        Node *n = node_of( this);
+
+        if ( index_of( n, this) > n->lo)
+            return this - 1;
+
+        return isNotNullP( n->prev) ? unit_at( n->prev, n->prev->hi - 1) : NULL;
+    }
+
+    template <class T, UInt32 node_bytes>
+    T& UDList<T, node_bytes>::Unit::val()
+    {
+        return unit_value;
+    }
+
+// ---- UDList implementation ----
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Node *
+    UDList<T, node_bytes>::node_of( Unit *u)
+    {
+        return reinterpret_cast<Node *>( reinterpret_cast<size_t>( u) & ~( size_t)( node_bytes - 1));
+    }
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::unit_at( Node *n, UInt32 i)
+    {
+        return reinterpret_cast<Unit *>( reinterpret_cast<UInt8 *>( n) + UNITS_OFFSET) + i;
+    }
+
+    template <class T, UInt32 node_bytes>
+    UInt32 UDList<T, node_bytes>::index_of( Node *n, Unit *u)
+    {
+        return ( UInt32)( u - unit_at( n, 0));
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::relocate( Unit *to, Unit *from)
+    {
+        new ( to) Unit( std::move( from->unit_value));
+        from->~Unit();
+    }
+
+    template <class T, UInt32 node_bytes>
+    UDList<T, node_bytes>::UDList():
+        head( NULL),
+        tail( NULL),
+        size_of_list( 0)
+    {
+    }
+
+    template <class T, UInt32 node_bytes>
+    UDList<T, node_bytes>::~UDList()
+    {
+        clear();
+    }
+
+    // Allocate node aligned on its size and link it after the given node (at front if null)
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Node *
+    UDList<T, node_bytes>::create_node( Node *after, UInt32 pos)
+    {
+        void *mem = NULL;
+#ifdef OS_WIN
+        mem = _aligned_malloc( node_bytes, node_bytes);
+#else
+        if ( posix_memalign( &mem, node_bytes, node_bytes) != 0)
+            mem = NULL;
+#endif
+        if ( isNullP( mem))
+            throw std::bad_alloc();
+
+        Node *n = static_cast<Node *>( mem);
+        n->lo = pos;
+        n->hi = pos;
+        n->prev = after;
+        n->next = isNotNullP( after) ? after->next : head;
+
+        if ( isNotNullP( n->prev))
+            n->prev->next = n;
+        else
+            head = n;
+
+        if ( isNotNullP( n->next))
+            n->next->prev = n;
+        else
+            tail = n;
+
+        return n;
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::destroy_node( Node *n)
+    {
+        if ( isNotNullP( n->prev))
+            n->prev->next = n->next;
+        else
+            head = n->next;
+
+        if ( isNotNullP( n->next))
+            n->next->prev = n->prev;
+        else
+            tail = n->prev;
+#ifdef OS_WIN
+        _aligned_free( n);
+#else
+        free( n);
+#endif
+    }
+
+    // Move the upper half of a full node to a new node, return the new node
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Node *
+    UDList<T, node_bytes>::split( Node *n)
+    {
+        Node *m = create_node( n, 0);
+        UInt32 mid = n->lo + ( n->hi - n->lo) / 2;
+
+        for ( UInt32 i = mid; i < n->hi; i++)
+        {
+            relocate( unit_at( m, m->hi++), unit_at( n, i));
+        }
+        n->hi = mid;
+        return m;
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::push_front( const T& val)
+    {
+        emplace_front( val);
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::push_front( T&& val)
+    {
+        emplace_front( std::move( val));
+    }
+
+    template <class T, UInt32 node_bytes>
+    template <class... Args>
+    void UDList<T, node_bytes>::emplace_front( Args&&... args)
+    {
+        if ( isNullP( head) || head->lo == 0)
+            create_node( NULL, NODE_CAPACITY);
+
+        new ( unit_at( head, head->lo - 1)) Unit( std::forward<Args>( args)...);
+        head->lo--;
+        size_of_list++;
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::pop_front()
+    {
+        if ( isNotNullP( head))
+            erase( first());
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::push_back( const T& val)
+    {
+        emplace_back( val);
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::push_back( T&& val)
+    {
+        emplace_back( std::move( val));
+    }
+
+    template <class T, UInt32 node_bytes>
+    template <class... Args>
+    void UDList<T, node_bytes>::emplace_back( Args&&... args)
+    {
+        if ( isNullP( tail) || tail->hi == NODE_CAPACITY)
+            create_node( tail, 0);
+
+        new ( unit_at( tail, tail->hi)) Unit( std::forward<Args>( args)...);
+        tail->hi++;
+        size_of_list++;
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::pop_back()
+    {
+        if ( isNotNullP( tail))
+            erase( last());
+    }
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::insert( Unit* u, const T& val)
+    {
+        return emplace( u, val);
+    }
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::insert( Unit* u, T&& val)
+    {
+        return emplace( u, std::move( val));
+    }
+
+    template <class T, UInt32 node_bytes>
+    template <class... Args>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::emplace( Unit* u, Args&&... args)
+    {
+        if ( isNullP( u))
+        {
+            emplace_back( std::forward<Args>( args)...);
+            return last();
+        }
+
+        Node *n = node_of( u);
+        UInt32 i = index_of( n, u);
+
+        if ( n->hi - n->lo == NODE_CAPACITY)
+        {
+            Node *m = split( n);
+
+            if ( i >= n->hi)
+            {
+                i -= n->hi;
+                n = m;
+            }
+        }
+
+        // Shift the shorter side of the node that has room
+        if ( n->hi < NODE_CAPACITY && ( n->lo == 0 || n->hi - i <= i - n->lo))
+        {
+            for ( UInt32 k = n->hi; k > i; k--)
+            {
+                relocate( unit_at( n, k), unit_at( n, k - 1));
+            }
+            n->hi++;
+        } else
+        {
+            for ( UInt32 k = n->lo; k < i; k++)
+            {
+                relocate( unit_at( n, k - 1), unit_at( n, k));
+            }
+            n->lo--;
+            i--;
+        }
+        new ( unit_at( n, i)) Unit( std::forward<Args>( args)...);
+        size_of_list++;
+        return unit_at( n, i);
+    }
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::first()
+    {
+        return isNotNullP( head) ? unit_at( head, head->lo) : NULL;
+    }
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::last()
+    {
+        return isNotNullP( tail) ? unit_at( tail, tail->hi - 1) : NULL;
+    }
+
+    template <class T, UInt32 node_bytes>
+    typename UDList<T, node_bytes>::Unit *
+    UDList<T, node_bytes>::erase( Unit* u)
+    {
+        DLIST_ASSERTXD( isNotNullP( u), "Erasing null unit");
+
+        Node *n = node_of( u);
+        UInt32 i = index_of( n, u);
+        Unit *next = NULL;
+
+        u->~Unit();
+        size_of_list--;
+
+        // Close the gap from the shorter side
+        if ( i - n->lo < n->hi - 1 - i)
+        {
+            for ( UInt32 k = i; k > n->lo; k--)
+            {
+                relocate( unit_at( n, k), unit_at( n, k - 1));
+            }
+            n->lo++;
+            next = unit_at( n, i + 1);
+        } else
+        {
+            for ( UInt32 k = i + 1; k < n->hi; k++)
+            {
+                relocate( unit_at( n, k - 1), unit_at( n, k));
+            }
+            n->hi--;
+            if ( i < n->hi)
+            {
+                next = unit_at( n, i);
+            } else
+            {
+                next = isNotNullP( n->next) ? unit_at( n->next, n->next->lo) : NULL;
+            }
+        }
+
+        if ( n->lo == n->hi)
+            destroy_node( n);
+
+        return next;
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::clear()
+    {
+        while ( isNotNullP( head))
+        {
+            for ( UInt32 i = head->lo; i < head->hi; i++)
+            {
+                unit_at( head, i)->~Unit();
+            }
+            destroy_node( head);
+        }
+        size_of_list = 0;
+    }
+
+    template <class T, UInt32 node_bytes>
+    bool UDList<T, node_bytes>::empty()
+    {
+        return size_of_list == 0;
+    }
+
+    template <class T, UInt32 node_bytes>
+    unsigned UDList<T, node_bytes>::size()
+    {
+        return size_of_list;
+    }
+
+    template <class T, UInt32 node_bytes>
+    void UDList<T, node_bytes>::reverse()
+    {
+        Node *n = head;
+
+        while ( isNotNullP( n))
+        {
+            Node *next = n->next;
+
+            for ( UInt32 i = n->lo, j = n->hi - 1; i < j; i++, j--)
+            {
+                std::swap( unit_at( n, i)->unit_value, unit_at( n, j)->unit_value);
+            }
+            n->next = n->prev; // swap prev and next
+            n->prev = next;
+            n = next;
+        }
+        std::swap( head, tail);
+    }
+};
+
+#endif /* TASK_ULIST_H */
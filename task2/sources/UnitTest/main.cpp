@@ -14,8 +14,29 @@
  */
 int main(int argc, char **argv)
 {
+    // Algorithms write to the logs, they are registered and disabled by default
+    Utils::Log::init();
+
     // Run the example testing
+    RUN_TEST( Utils::uTestBitVector);
     RUN_TEST( Task::uTest);
+    RUN_TEST( Task::uTestTraversal);
+    RUN_TEST( Task::uTestDom);
+    RUN_TEST( Task::uTestDf);
+    RUN_TEST( Task::uTestScc);
+    RUN_TEST( Task::uTestDataflow);
+    RUN_TEST( Task::uTestColor);
+    RUN_TEST( Utils::uTestBitVectorPerf);
+    RUN_TEST( Task::uTestPerf);
+    RUN_TEST( Task::uTestCsrPerf);
+    RUN_TEST( Task::uTestTraversalPerf);
+    RUN_TEST( Task::uTestDomPerf);
+    RUN_TEST( Task::uTestDfPerf);
+    RUN_TEST( Task::uTestSccPerf);
+    RUN_TEST( Task::uTestDataflowPerf);
+    RUN_TEST( Task::uTestColorPerf);
+
+    Utils::Log::deinit();
 
     cout.flush();
     cerr.flush();
@@ -0,0 +1,199 @@
+/**
+ * @file: bit_vector.cpp
+ * Implementation of dense bit vector and sparse set
+ */
+/*
+ * Utils library in compiler prototype project
+ */
+#include "utils_iface.h"
+
+namespace Utils
+{
+    const UInt32 BitVector::WORD_BITS;
+    const UInt32 BitVector::NONE;
+
+    BitVector::BitVector( UInt32 size):
+        num_bits( size),
+        words( ( size + WORD_BITS - 1) / WORD_BITS, 0)
+    {
+    }
+
+    void BitVector::resize( UInt32 size)
+    {
+        words.resize( ( size + WORD_BITS - 1) / WORD_BITS, 0);
+        num_bits = size;
+        clearTail();
+    }
+
+    void BitVector::clearTail()
+    {
+        if ( num_bits % WORD_BITS != 0)
+            words.back() &= ~( ~( Word)0 << ( num_bits % WORD_BITS));
+    }
+
+    void BitVector::clear()
+    {
+        std::fill( words.begin(), words.end(), 0);
+    }
+
+    void BitVector::setAll()
+    {
+        std::fill( words.begin(), words.end(), ~( Word)0);
+        clearTail();
+    }
+
+    bool BitVector::none() const
+    {
+        for ( UInt32 i = 0; i < numWords(); i++)
+        {
+            if ( words[ i] != 0)
+                return false;
+        }
+        return true;
+    }
+
+    UInt32 BitVector::count() const
+    {
+        return countWords( data(), numWords());
+    }
+
+    UInt32 BitVector::next( UInt32 bit) const
+    {
+        if ( bit >= num_bits)
+            return NONE;
+
+        UInt32 i = bit / WORD_BITS;
+        Word w = words[ i] & ( ~( Word)0 << ( bit % WORD_BITS));
+
+        while ( w == 0)
+        {
+            if ( ++i == numWords())
+                return NONE;
+            w = words[ i];
+        }
+        return i * WORD_BITS + lowestBit( w);
+    }
+
+    bool BitVector::operator == ( const BitVector& v) const
+    {
+        return num_bits == v.num_bits && equalWords( data(), v.data(), numWords());
+    }
+
+#ifdef UTILS_BITS_SSE2
+    /* Two words at a time, 'diff' collects the changed bits */
+#   define BITS_SSE2_LOOP( op)                                              \
+        __m128i diff = _mm_setzero_si128();                                  \
+        UInt32 i = 0;                                                        \
+        for ( ; i + 2 <= n; i += 2)                                          \
+        {                                                                    \
+            __m128i a = _mm_loadu_si128( ( const __m128i *)( to + i));       \
+            __m128i b = _mm_loadu_si128( ( const __m128i *)( from + i));     \
+            __m128i r = op;                                                  \
+                                                                             \
+            diff = _mm_or_si128( diff, _mm_xor_si128( a, r));                \
+            _mm_storeu_si128( ( __m128i *)( to + i), r);                     \
+        }                                                                    \
+        bool changed = _mm_movemask_epi8( _mm_cmpeq_epi8( diff, _mm_setzero_si128())) != 0xffff;
+#else
+#   define BITS_SSE2_LOOP( op) \
+        UInt32 i = 0;          \
+        bool changed = false;
+#endif
+
+    bool BitVector::orWords( Word *to, const Word *from, UInt32 n)
+    {
+        BITS_SSE2_LOOP( _mm_or_si128( a, b))
+        Word rest = 0;
+
+        for ( ; i < n; i++)
+        {
+            Word r = to[ i] | from[ i];
+
+            rest |= r ^ to[ i];
+            to[ i] = r;
+        }
+        return changed || rest != 0;
+    }
+
+    bool BitVector::andWords( Word *to, const Word *from, UInt32 n)
+    {
+        BITS_SSE2_LOOP( _mm_and_si128( a, b))
+        Word rest = 0;
+
+        for ( ; i < n; i++)
+        {
+            Word r = to[ i] & from[ i];
+
+            rest |= r ^ to[ i];
+            to[ i] = r;
+        }
+        return changed || rest != 0;
+    }
+
+    bool BitVector::andNotWords( Word *to, const Word *from, UInt32 n)
+    {
+        BITS_SSE2_LOOP( _mm_andnot_si128( b, a))
+        Word rest = 0;
+
+        for ( ; i < n; i++)
+        {
+            Word r = to[ i] & ~from[ i];
+
+            rest |= r ^ to[ i];
+            to[ i] = r;
+        }
+        return changed || rest != 0;
+    }
+
+#undef BITS_SSE2_LOOP
+
+    bool BitVector::equalWords( const Word *a, const Word *b, UInt32 n)
+    {
+        UInt32 i = 0;
+#ifdef UTILS_BITS_SSE2
+        for ( ; i + 2 <= n; i += 2)
+        {
+            __m128i eq = _mm_cmpeq_epi8( _mm_loadu_si128( ( const __m128i *)( a + i)),
+                                         _mm_loadu_si128( ( const __m128i *)( b + i)));
+            if ( _mm_movemask_epi8( eq) != 0xffff)
+                return false;
+        }
+#endif
+        for ( ; i < n; i++)
+        {
+            if ( a[ i] != b[ i])
+                return false;
+        }
+        return true;
+    }
+
+    UInt32 BitVector::countWords( const Word *a, UInt32 n)
+    {
+        // Independent sums let the additions of neighbour words overlap
+        UInt32 sum0 = 0;
+        UInt32 sum1 = 0;
+        UInt32 i = 0;
+
+        for ( ; i + 2 <= n; i += 2)
+        {
+            sum0 += popCount( a[ i]);
+            sum1 += popCount( a[ i + 1]);
+        }
+        if ( i < n)
+            sum0 += popCount( a[ i]);
+        return sum0 + sum1;
+    }
+
+    SparseSet::SparseSet( UInt32 universe):
+        num_members( 0),
+        dense( universe + 1, 0),
+        sparse( universe, 0)
+    {
+    }
+
+    void SparseSet::resize( UInt32 universe)
+    {
+        dense.resize( universe + 1, 0);
+        sparse.resize( universe, 0);
+    }
+};
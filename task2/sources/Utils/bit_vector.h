@@ -0,0 +1,279 @@
+/**
+ * @file: bit_vector.h
+ * Dense bit vector and sparse set
+ * @defgroup Bits Bit sets
+ * @brief Sets of small integers such as node ids
+ *
+ * BitVector keeps a bit per possible member in 64-bit words, set operations work on
+ * whole words. SparseSet keeps the members in an array and finds them by an index
+ * array, so it is cleared and iterated in time proportional to the number of members.
+ * Both are indexed by numbers below a fixed size, so sets of graph nodes are created
+ * with the node id limit of the graph as the size.
+ * @ingroup Utils
+ */
+/*
+ * Utils library in compiler prototype project
+ */
+#pragma once
+#ifndef UTILS_BIT_VECTOR_H
+#define UTILS_BIT_VECTOR_H
+
+#if defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define UTILS_BITS_SSE2
+#endif
+
+namespace Utils
+{
+    /**
+     * @brief Dense set of numbers below the size
+     * @ingroup Bits
+     *
+     * Unused bits of the last word are always zero, so whole-word operations like
+     * count() and equality need no masking.
+     */
+    class BitVector
+    {
+    public:
+        typedef UInt64 Word;
+        static const UInt32 WORD_BITS = 64;
+        static const UInt32 NONE = (UInt32)-1;
+
+        class const_iterator;
+
+        BitVector(): num_bits( 0){}                    /**< Empty vector */
+        explicit BitVector( UInt32 size);              /**< Vector of zeros */
+
+        UInt32 size() const { return num_bits; }       /**< Number of bits */
+        void resize( UInt32 size);                     /**< Change the size, new bits are zero */
+
+        inline bool test( UInt32 bit) const;           /**< Check if the bit is set */
+        inline void set( UInt32 bit);                  /**< Set the bit */
+        inline void reset( UInt32 bit);                /**< Clear the bit */
+        inline bool testAndSet( UInt32 bit);           /**< Set the bit, return true if it was clear */
+
+        void clear();                                  /**< Clear all bits */
+        void setAll();                                 /**< Set all bits */
+        bool none() const;                             /**< Check that no bit is set */
+        UInt32 count() const;                          /**< Number of set bits */
+
+        UInt32 first() const { return next( 0); }      /**< First set bit, NONE if there is none */
+        UInt32 next( UInt32 bit) const;                /**< First set bit not less than the given one */
+        inline const_iterator begin() const;           /**< Iteration over set bits */
+        inline const_iterator end() const;
+
+        /** Set operations, the vectors must be of the same size. Return true if this vector changed */
+        bool operator |= ( const BitVector& v) { return orWords( data(), v.data(), numWords()); }
+        bool operator &= ( const BitVector& v) { return andWords( data(), v.data(), numWords()); }
+        bool andNot( const BitVector& v)       { return andNotWords( data(), v.data(), numWords()); }
+
+        bool operator == ( const BitVector& v) const;
+        bool operator != ( const BitVector& v) const { return !( *this == v); }
+
+        UInt32 numWords() const { return ( UInt32)words.size(); }
+        Word *data() { return words.empty() ? NULL : &words[ 0]; }
+        const Word *data() const { return words.empty() ? NULL : &words[ 0]; }
+
+        /**
+         * Operations on word arrays of n words, for sets kept in rows of a bigger array.
+         * They use SSE2 when the target has it and return true if 'to' changed
+         */
+        static bool orWords( Word *to, const Word *from, UInt32 n);
+        static bool andWords( Word *to, const Word *from, UInt32 n);
+        static bool andNotWords( Word *to, const Word *from, UInt32 n);
+        static bool equalWords( const Word *a, const Word *b, UInt32 n);
+        static UInt32 countWords( const Word *a, UInt32 n);
+        static inline UInt32 popCount( Word w);
+        static inline UInt32 lowestBit( Word w);       /**< Index of the lowest set bit, w must not be zero */
+    private:
+        void clearTail(); /**< Zero the bits after the size in the last word */
+
+        UInt32 num_bits;
+        std::vector< Word> words;
+    };
+
+    /**
+     * @brief Iterator over the set bits of a BitVector, in increasing order
+     * @ingroup Bits
+     */
+    class BitVector::const_iterator
+    {
+    public:
+        UInt32 operator*() const { return bit; }
+        const_iterator& operator++();
+        bool operator == ( const const_iterator& i) const { return bit == i.bit; }
+        bool operator != ( const const_iterator& i) const { return bit != i.bit; }
+    private:
+        const_iterator( const BitVector *v, UInt32 b);
+
+        friend class BitVector;
+
+        const BitVector *vector;
+        UInt32 bit;       /**< Current bit, NONE at the end */
+        Word rest;        /**< Bits of the current word after the current one */
+    };
+
+    /**
+     * @brief Set of numbers below the universe size with O(1) insert, remove and clear
+     * @ingroup Bits
+     *
+     * The Briggs-Torczon representation: members are kept densely in insertion order
+     * (changed by removals) and the sparse array gives the position of a member in the
+     * dense one. A number is a member if its position is in range and points back to it,
+     * so stale positions left by clear() do no harm.
+     */
+    class SparseSet
+    {
+    public:
+        typedef const UInt32 *const_iterator;
+
+        SparseSet(): num_members( 0), dense( 1, 0){}   /**< Empty set over an empty universe */
+        explicit SparseSet( UInt32 universe);          /**< Empty set */
+
+        UInt32 universe() const { return ( UInt32)sparse.size(); }
+        void resize( UInt32 universe);                 /**< Change the universe, members must be below it */
+
+        inline bool contains( UInt32 key) const;
+        inline bool insert( UInt32 key);               /**< Add the key, return true if it was not there */
+        inline bool erase( UInt32 key);                /**< Remove the key, return true if it was there */
+        void clear() { num_members = 0; }
+        inline UInt32 pop();                           /**< Remove and return the last member, the set must not be empty */
+
+        UInt32 size() const { return num_members; }
+        bool empty() const { return num_members == 0; }
+        const_iterator begin() const { return &dense[ 0]; } /**< Iteration over members */
+        const_iterator end() const { return &dense[ 0] + num_members; }
+    private:
+        UInt32 num_members;
+        std::vector< UInt32> dense;   /**< Members, one more entry keeps &dense[ 0] valid */
+        std::vector< UInt32> sparse;  /**< Position of a member in dense */
+    };
+
+    /* ---- BitVector inline routines ---- */
+
+    inline bool BitVector::test( UInt32 bit) const
+    {
+        UTILS_ASSERTXD( bit < num_bits, "Bit index is out of range");
+        return ( words[ bit / WORD_BITS] >> ( bit % WORD_BITS)) & 1;
+    }
+
+    inline void BitVector::set( UInt32 bit)
+    {
+        UTILS_ASSERTXD( bit < num_bits, "Bit index is out of range");
+        words[ bit / WORD_BITS] |= ( Word)1 << ( bit % WORD_BITS);
+    }
+
+    inline void BitVector::reset( UInt32 bit)
+    {
+        UTILS_ASSERTXD( bit < num_bits, "Bit index is out of range");
+        words[ bit / WORD_BITS] &= ~( ( Word)1 << ( bit % WORD_BITS));
+    }
+
+    inline bool BitVector::testAndSet( UInt32 bit)
+    {
+        UTILS_ASSERTXD( bit < num_bits, "Bit index is out of range");
+        Word& w = words[ bit / WORD_BITS];
+        Word mask = ( Word)1 << ( bit % WORD_BITS);
+
+        if ( w & mask)
+            return false;
+        w |= mask;
+        return true;
+    }
+
+    inline UInt32 BitVector::popCount( Word w)
+    {
+#if defined(CC_GNU) && defined(__POPCNT__)
+        return ( UInt32)__builtin_popcountll( w);
+#else
+        // Sums of bits in pairs, nibbles and bytes, then all bytes added by the multiplication
+        w = w - ( ( w >> 1) & 0x5555555555555555ull);
+        w = ( w & 0x3333333333333333ull) + ( ( w >> 2) & 0x3333333333333333ull);
+        w = ( w + ( w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return ( UInt32)( ( w * 0x0101010101010101ull) >> 56);
+#endif
+    }
+
+    inline UInt32 BitVector::lowestBit( Word w)
+    {
+#if defined(CC_GNU)
+        return ( UInt32)__builtin_ctzll( w);
+#else
+        return popCount( ( w & ( 0 - w)) - 1);
+#endif
+    }
+
+    inline BitVector::const_iterator BitVector::begin() const
+    {
+        return const_iterator( this, first());
+    }
+
+    inline BitVector::const_iterator BitVector::end() const
+    {
+        return const_iterator( this, NONE);
+    }
+
+    inline BitVector::const_iterator::const_iterator( const BitVector *v, UInt32 b):
+        vector( v),
+        bit( b),
+        rest( 0)
+    {
+        if ( bit != NONE && bit % WORD_BITS != WORD_BITS - 1)
+            rest = v->words[ bit / WORD_BITS] & ( ~( Word)0 << ( bit % WORD_BITS + 1));
+    }
+
+    inline BitVector::const_iterator& BitVector::const_iterator::operator++()
+    {
+        if ( rest != 0)
+        {
+            // Next bit in the same word
+            bit = ( bit / WORD_BITS) * WORD_BITS + lowestBit( rest);
+            rest &= rest - 1;
+        } else
+        {
+            *this = const_iterator( vector, vector->next( ( bit / WORD_BITS + 1) * WORD_BITS));
+        }
+        return *this;
+    }
+
+    /* ---- SparseSet inline routines ---- */
+
+    inline bool SparseSet::contains( UInt32 key) const
+    {
+        UTILS_ASSERTXD( key < universe(), "Key is out of the universe");
+        UInt32 pos = sparse[ key];
+
+        return pos < num_members && dense[ pos] == key;
+    }
+
+    inline bool SparseSet::insert( UInt32 key)
+    {
+        if ( contains( key))
+            return false;
+        sparse[ key] = num_members;
+        dense[ num_members++] = key;
+        return true;
+    }
+
+    inline bool SparseSet::erase( UInt32 key)
+    {
+        if ( !contains( key))
+            return false;
+
+        // The last member takes the place of the removed one
+        UInt32 pos = sparse[ key];
+        UInt32 last = dense[ --num_members];
+
+        dense[ pos] = last;
+        sparse[ last] = pos;
+        return true;
+    }
+
+    inline UInt32 SparseSet::pop()
+    {
+        UTILS_ASSERTXD( num_members > 0, "Pop from an empty set");
+        return dense[ --num_members];
+    }
+};
+
+#endif /* UTILS_BIT_VECTOR_H */
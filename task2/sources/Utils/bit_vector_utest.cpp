@@ -0,0 +1,268 @@
+/**
+ * @file: bit_vector_utest.cpp
+ * Implementation of testing for bit vector and sparse set
+ */
+#include "utils_iface.h"
+#include <set>
+
+using namespace Utils;
+
+namespace Utils
+{
+    /** Simple xorshift generator to get the same numbers in every run */
+    static UInt32 bitsRandom( UInt32& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    bool uTestBitVector( UnitTest *utest_p)
+    {
+        /* Sizes around word boundaries and the SSE2 pairs of words */
+        static const UInt32 sizes[] = { 1, 63, 64, 65, 127, 128, 129, 1000};
+        UInt32 state = 2463534242u;
+        bool same = true;
+
+        for ( UInt32 k = 0; k < sizeof( sizes) / sizeof( sizes[ 0]); k++)
+        {
+            UInt32 size = sizes[ k];
+            BitVector a( size);
+            BitVector b( size);
+            std::vector< bool> ref_a( size, false);
+            std::vector< bool> ref_b( size, false);
+
+            for ( UInt32 i = 0; i < size / 3 + 1; i++)
+            {
+                UInt32 x = bitsRandom( state) % size;
+                UInt32 y = bitsRandom( state) % size;
+
+                a.set( x);
+                ref_a[ x] = true;
+                b.set( y);
+                ref_b[ y] = true;
+            }
+
+            /* Iteration gives the set bits in order */
+            std::vector< UInt32> bits;
+            std::vector< UInt32> ref_bits;
+            for ( BitVector::const_iterator it = a.begin(); it != a.end(); ++it)
+            {
+                bits.push_back( *it);
+            }
+            for ( UInt32 i = 0; i < size; i++)
+            {
+                if ( ref_a[ i])
+                    ref_bits.push_back( i);
+            }
+            same = same && bits == ref_bits && a.count() == ref_bits.size();
+
+            /* Set operations */
+            BitVector or_v( a);
+            BitVector and_v( a);
+            BitVector and_not_v( a);
+            or_v |= b;
+            and_v &= b;
+            and_not_v.andNot( b);
+            for ( UInt32 i = 0; i < size; i++)
+            {
+                same = same && or_v.test( i) == ( ref_a[ i] || ref_b[ i])
+                            && and_v.test( i) == ( ref_a[ i] && ref_b[ i])
+                            && and_not_v.test( i) == ( ref_a[ i] && !ref_b[ i]);
+            }
+            same = same && !( or_v |= a) && ( or_v == ( BitVector( or_v))) && ( or_v != and_v || a == b);
+
+            /* setAll keeps the bits after the size clear */
+            BitVector all( size);
+            all.setAll();
+            same = same && all.count() == size && all.next( size - 1) == size - 1;
+            all.clear();
+            same = same && all.none() && all.first() == BitVector::NONE;
+        }
+        UTEST_CHECK( utest_p, same);
+
+        BitVector v( 200);
+        UTEST_CHECK( utest_p, v.testAndSet( 130) && !v.testAndSet( 130) && v.test( 130) && v.first() == 130);
+        v.reset( 130);
+        v.set( 63);
+        v.set( 64);
+        UTEST_CHECK( utest_p, v.first() == 63 && v.next( 64) == 64 && v.next( 65) == BitVector::NONE && v.count() == 2);
+        v.resize( 64);
+        UTEST_CHECK( utest_p, v.size() == 64 && v.count() == 1);
+        v.resize( 300);
+        UTEST_CHECK( utest_p, v.count() == 1 && !v.test( 64) && !v.test( 299));
+
+        /* Sparse set */
+        SparseSet s( 100);
+        UTEST_CHECK( utest_p, s.empty() && s.insert( 5) && s.insert( 99) && !s.insert( 5) && s.size() == 2);
+        UTEST_CHECK( utest_p, s.contains( 5) && s.contains( 99) && !s.contains( 6));
+        UTEST_CHECK( utest_p, s.erase( 5) && !s.erase( 5) && !s.contains( 5) && s.contains( 99) && *s.begin() == 99);
+        s.insert( 7);
+        s.clear();
+        UTEST_CHECK( utest_p, s.empty() && !s.contains( 7) && !s.contains( 99) && s.begin() == s.end());
+        s.insert( 1);
+        s.insert( 2);
+        UTEST_CHECK( utest_p, s.pop() == 2 && s.pop() == 1 && s.empty());
+
+        std::set< UInt32> ref;
+        bool same_set = true;
+        for ( UInt32 i = 0; i < 10000; i++)
+        {
+            UInt32 key = bitsRandom( state) % 100;
+
+            if ( bitsRandom( state) % 3 == 0)
+            {
+                same_set = same_set && s.erase( key) == ( ref.erase( key) == 1);
+            } else
+            {
+                same_set = same_set && s.insert( key) == ref.insert( key).second;
+            }
+        }
+        std::set< UInt32> members( s.begin(), s.end());
+        UTEST_CHECK( utest_p, same_set && members == ref && s.size() == ref.size());
+
+        return utest_p->result();
+    }
+
+    bool uTestBitVectorPerf( UnitTest *utest_p)
+    {
+#ifdef _DEBUG
+        static const UInt32 NUM_BITS = 100000;
+#else
+        static const UInt32 NUM_BITS = 1000000;
+#endif
+        static const UInt32 NUM_REPEATS = 100;
+
+        UInt32 state = 2463534242u;
+        BitVector a( NUM_BITS);
+        BitVector b( NUM_BITS);
+        std::vector< bool> ref_a( NUM_BITS, false);
+        std::vector< bool> ref_b( NUM_BITS, false);
+
+        for ( UInt32 i = 0; i < NUM_BITS / 8; i++)
+        {
+            UInt32 x = bitsRandom( state) % NUM_BITS;
+            UInt32 y = bitsRandom( state) % NUM_BITS;
+
+            a.set( x);
+            ref_a[ x] = true;
+            b.set( y);
+            ref_b[ y] = true;
+        }
+
+        /* Union, intersection and counting */
+        Timer timer( true);
+        UInt64 sum = 0;
+        for ( UInt32 r = 0; r < NUM_REPEATS; r++)
+        {
+            BitVector c( a);
+
+            c |= b;
+            c.andNot( a);
+            sum += c.count();
+        }
+        UInt32 t_bits = timer.elapsedUSec();
+
+        timer.start();
+        UInt64 ref_sum = 0;
+        for ( UInt32 r = 0; r < NUM_REPEATS; r++)
+        {
+            std::vector< bool> c( ref_a);
+
+            for ( UInt32 i = 0; i < NUM_BITS; i++)
+            {
+                c[ i] = ( c[ i] || ref_b[ i]) && !ref_a[ i];
+            }
+            ref_sum += std::count( c.begin(), c.end(), true);
+        }
+        UInt32 t_ref = timer.elapsedUSec();
+
+        /* Walking the set bits */
+        timer.start();
+        UInt64 bit_sum = 0;
+        for ( UInt32 r = 0; r < NUM_REPEATS; r++)
+        {
+            for ( BitVector::const_iterator it = a.begin(), end = a.end(); it != end; ++it)
+            {
+                bit_sum += *it;
+            }
+        }
+        UInt32 t_iter = timer.elapsedUSec();
+
+        timer.start();
+        UInt64 ref_bit_sum = 0;
+        for ( UInt32 r = 0; r < NUM_REPEATS; r++)
+        {
+            for ( UInt32 i = 0; i < NUM_BITS; i++)
+            {
+                if ( ref_a[ i])
+                    ref_bit_sum += i;
+            }
+        }
+        UInt32 t_ref_iter = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, sum == ref_sum && bit_sum == ref_bit_sum);
+
+        /* Worklist use: random inserts, pops and clears */
+        timer.start();
+        UInt64 pop_sum = 0;
+        {
+            SparseSet worklist( NUM_BITS);
+            UInt32 s = 12345;
+
+            for ( UInt32 r = 0; r < NUM_REPEATS; r++)
+            {
+                for ( UInt32 i = 0; i < NUM_BITS / 100; i++)
+                {
+                    worklist.insert( bitsRandom( s) % NUM_BITS);
+                }
+                for ( UInt32 i = 0; i < NUM_BITS / 200 && !worklist.empty(); i++)
+                {
+                    pop_sum += worklist.pop();
+                }
+                worklist.clear();
+            }
+        }
+        UInt32 t_sparse = timer.elapsedUSec();
+
+        timer.start();
+        UInt64 ref_pop_sum = 0;
+        {
+            std::set< UInt32> worklist;
+            std::vector< UInt32> order; // std::set has no insertion order, so it is kept aside
+            UInt32 s = 12345;
+
+            for ( UInt32 r = 0; r < NUM_REPEATS; r++)
+            {
+                for ( UInt32 i = 0; i < NUM_BITS / 100; i++)
+                {
+                    UInt32 key = bitsRandom( s) % NUM_BITS;
+
+                    if ( worklist.insert( key).second)
+                        order.push_back( key);
+                }
+                for ( UInt32 i = 0; i < NUM_BITS / 200 && !order.empty(); i++)
+                {
+                    ref_pop_sum += order.back();
+                    worklist.erase( order.back());
+                    order.pop_back();
+                }
+                worklist.clear();
+                order.clear();
+            }
+        }
+        UInt32 t_ref_sparse = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, pop_sum == ref_pop_sum);
+
+        utest_p->out() << endl << "    " << NUM_BITS << " bits, " << NUM_REPEATS << " times:"
+                       << endl << "    or, andNot, count: BitVector " << std::setw( 8) << t_bits << " uSec,"
+                       << " vector<bool> " << std::setw( 8) << t_ref << " uSec"
+                       << endl << "    set bits walk:     BitVector " << std::setw( 8) << t_iter << " uSec,"
+                       << " vector<bool> " << std::setw( 8) << t_ref_iter << " uSec"
+                       << endl << "    worklist:          SparseSet " << std::setw( 8) << t_sparse << " uSec,"
+                       << " std::set     " << std::setw( 8) << t_ref_sparse << " uSec" << endl;
+        return utest_p->result();
+    }
+};
@@ -42,7 +42,9 @@
 
 #include "list.h"
 #include "singleton.h"
-
+#include "log.h"
+#include "conf.h"
+#include "bit_vector.h"
 
 
 namespace Utils
@@ -54,6 +56,16 @@ namespace Utils
      */
     bool uTestList( UnitTest *utest_p);
     
+    /**
+     * Test bit vector and sparse set
+     */
+    bool uTestBitVector( UnitTest *utest_p);
+
+    /**
+     * Measure bit vector and sparse set against std containers
+     */
+    bool uTestBitVectorPerf( UnitTest *utest_p);
+
     /**
      * Test Utils package
      */
@@ -18,7 +18,7 @@ namespace TestSingle
         /** private constructors, assignment and destructor */
         A(){};
         A( const A&){};
-        A& operator =( const A&){};
+        A& operator =( const A&){ return *this; };
         ~A(){};
         /** Needed for singleton creation */
         friend class Single< A>;
@@ -95,7 +95,11 @@ bool Utils::uTest()
     RUN_TEST( TestSingle::uTestSingle);
     /** Tets list classes */
     RUN_TEST( uTestList);
+    /** Test bit sets */
+    RUN_TEST( uTestBitVector);
 
+    /** Test logs */
+    RUN_TEST_OUT_FILE_CHECK( uTestLogs, "log_utest.txt");
     return true;
 }
 
@@ -0,0 +1,161 @@
+/**
+ * @file: task/graph_alloc.h
+ * Allocation policies for the nodes and edges of Task::Graph
+ */
+#pragma once
+
+#ifndef TASK_GRAPH_ALLOC_H
+#define TASK_GRAPH_ALLOC_H
+
+namespace Task
+{
+    //
+    // Object allocation policy that takes memory from slabs owned by one graph.
+    //
+    // A new object is cut from the current slab by bumping a pointer, so creation
+    // costs a compare and an add, and a new slab is taken from the heap once per
+    // SLAB_BYTES of objects. Memory of removed objects is linked through their first
+    // words and given out again before the slab is touched. The slabs are released
+    // at once by deallocate_all(), the objects are not returned one by one.
+    //
+    template < class Obj> class GraphPool
+    {
+    public:
+        GraphPool();  // Create policy, the first slab is allocated lazily
+        ~GraphPool(); // Release the slabs
+
+        inline void *allocate();            // Get memory for one object
+        inline void deallocate( void *ptr); // Put memory of one object to the free list
+        bool exclusive() const;             // The slabs hold only the objects of the owner
+        void deallocate_all();              // Release all slabs, the objects must be destroyed
+    private:
+        static const size_t SLAB_BYTES = 64 * 1024;
+
+        void *allocate_slab(); // Take a new slab and return its first object
+
+        void *slabs;      // Allocated slabs linked through their first words
+        void *free_objs;  // Memory of removed objects linked through their first words
+        char *bump;       // Next free byte of the current slab
+        char *bump_end;   // End of the current slab
+
+        // ---- Copy constructor and assignment turned off ----
+        GraphPool( const GraphPool& p);
+        GraphPool& operator = ( const GraphPool& p);
+    };
+
+    //
+    // Object allocation policy that uses plain operator new/delete for every object
+    //
+    template < class Obj> class GraphHeap
+    {
+    public:
+        inline void *allocate();            // Get memory for one object
+        inline void deallocate( void *ptr); // Free memory of one object
+        bool exclusive() const;             // Heap objects are always freed one by one
+        void deallocate_all();              // Never called, as the heap is never exclusive
+    };
+
+// ---- GraphPool implementation ----
+
+    template < class Obj> GraphPool< Obj>::GraphPool():
+        slabs( NULL),
+        free_objs( NULL),
+        bump( NULL),
+        bump_end( NULL)
+    {
+    }
+
+    template < class Obj> GraphPool< Obj>::~GraphPool()
+    {
+        deallocate_all();
+    }
+
+    template < class Obj> void *
+    GraphPool< Obj>::allocate()
+    {
+        void *ptr = free_objs;
+
+        if ( isNotNullP( ptr))
+        {
+            free_objs = *static_cast< void **>( ptr);
+            return ptr;
+        }
+        if ( bump_end - bump < (std::ptrdiff_t)sizeof( Obj))
+            return allocate_slab();
+
+        ptr = bump;
+        bump += sizeof( Obj);
+        return ptr;
+    }
+
+    // Objects start after the slab link at the alignment of Obj
+    template < class Obj> void *
+    GraphPool< Obj>::allocate_slab()
+    {
+        const size_t header = ( sizeof( void *) + alignof( Obj) - 1) / alignof( Obj) * alignof( Obj);
+        const size_t bytes = ( header + sizeof( Obj) > SLAB_BYTES) ? header + sizeof( Obj) : SLAB_BYTES;
+        char *slab = static_cast< char *>( ::operator new( bytes));
+
+        *reinterpret_cast< void **>( slab) = slabs;
+        slabs = slab;
+        bump = slab + header + sizeof( Obj);
+        bump_end = slab + bytes;
+        return slab + header;
+    }
+
+    template < class Obj> void
+    GraphPool< Obj>::deallocate( void *ptr)
+    {
+        *static_cast< void **>( ptr) = free_objs;
+        free_objs = ptr;
+    }
+
+    template < class Obj> bool
+    GraphPool< Obj>::exclusive() const
+    {
+        return true;
+    }
+
+    template < class Obj> void
+    GraphPool< Obj>::deallocate_all()
+    {
+        while ( isNotNullP( slabs))
+        {
+            void *next = *static_cast< void **>( slabs);
+
+            ::operator delete( slabs);
+            slabs = next;
+        }
+        free_objs = NULL;
+        bump = NULL;
+        bump_end = NULL;
+    }
+
+// ---- GraphHeap implementation ----
+
+    template < class Obj> void *
+    GraphHeap< Obj>::allocate()
+    {
+        return ::operator new( sizeof( Obj));
+    }
+
+    template < class Obj> void
+    GraphHeap< Obj>::deallocate( void *ptr)
+    {
+        ::operator delete( ptr);
+    }
+
+    template < class Obj> bool
+    GraphHeap< Obj>::exclusive() const
+    {
+        return false;
+    }
+
+    template < class Obj> void
+    GraphHeap< Obj>::deallocate_all()
+    {
+        GRAPH_ASSERTXD( 0, "Bulk release of heap objects");
+    }
+};
+
+#endif /* TASK_GRAPH_ALLOC_H */
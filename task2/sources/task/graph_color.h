@@ -0,0 +1,373 @@
+/**
+ * @file: task/graph_color.h
+ * Coloring of interference graphs for register allocation
+ */
+#pragma once
+
+#ifndef TASK_GRAPH_COLOR_H
+#define TASK_GRAPH_COLOR_H
+
+// Register allocator log
+#define RA_LOG( message) LOGS( Utils::LOG_BE_RA, message)
+#define RA_LOGV( verbosity, message) LOGVS( Utils::LOG_BE_RA, verbosity, message)
+
+namespace Task
+{
+    //
+    // Chaitin-Briggs coloring of an interference graph
+    // @param G graph type
+    //
+    // Every edge of the graph is an undirected interference between its nodes, repeated
+    // edges and edges from a node to itself are ignored. The constructor numbers the
+    // nodes densely and keeps the neighbours of every node as a sorted row of a
+    // compressed sparse row array. Graphs of up to MATRIX_MAX_NODES nodes also get a
+    // triangular bit matrix, so interferes() is a single bit test; bigger graphs would
+    // need n * n / 2 bits for it and are answered by a binary search in the shorter row.
+    //
+    // color() simplifies the graph by removing nodes with less than k neighbours left,
+    // when there are none the node with the least spill cost per neighbour is removed as
+    // a spill candidate. Nodes are then colored in the reverse order of the removal with
+    // the lowest color their neighbours don't have. Candidates are colored optimistically
+    // (Briggs) and only the ones that find no free color are spilled.
+    // The result is valid until the graph is changed
+    //
+    template < class G> class GraphColoring
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+
+        static const UInt32 NO_COLOR = (UInt32)-1;
+        static const UInt32 MATRIX_MAX_NODES = 8192; // Matrix takes 4M bytes at most
+
+        GraphColoring( G& g, UInt32 k); //< Constructor, builds the interference structures for k colors
+
+        bool valid() const; // Check that the graph was not changed after the construction
+
+        bool interferes( const NodeT& a, const NodeT& b) const; // Check if the nodes are neighbours
+        UInt32 degree( const NodeT& n) const { return offsets[ number( n) + 1] - offsets[ number( n)]; }
+        bool has_matrix() const { return matrix.size() != 0; }
+
+        void set_spill_cost( const NodeT& n, float cost); // Cost must not be negative, default is 1
+
+        UInt32 color(); // Color the nodes, return the number of spilled ones
+
+        // ---- Results of color() ----
+        UInt32 color_of( const NodeT& n) const { return colors[ number( n)]; } // NO_COLOR for spilled nodes
+        bool is_spilled( const NodeT& n) const { return colors[ number( n)] == NO_COLOR; }
+        UInt32 num_colors() const { return num_k; }
+        UInt32 num_spilled() const { return spilled; }
+        UInt32 num_spill_candidates() const { return candidates; } // Candidates including the colored ones
+
+        size_t memory_size() const; // Bytes taken by the interference structures and the result
+    private:
+        // Spill candidates are kept in a heap of ( key << 32) | node, where the key is the bits of
+        // the spill cost per neighbour when the entry was pushed. Bits of non-negative floats
+        // are ordered the same way as the floats
+        typedef std::vector< UInt64> SpillHeap;
+
+        UInt32 number( const NodeT& n) const { return index[ n.uid()]; }
+        UInt64 matrixBit( UInt32 i, UInt32 j) const; // Bit of the pair in the lower triangle, i != j
+        UInt64 spillEntry( UInt32 i) const;
+        UInt32 pickSpill( SpillHeap& heap, const SparseSet& spill_list); // Cheapest node of the spill list
+        void selectColors( const std::vector< UInt32>& stack);
+
+        // ---- Copy constructor and assignment turned off ----
+        GraphColoring( const GraphColoring& c);
+        GraphColoring& operator = ( const GraphColoring& c);
+
+        G *graph_p;
+        UInt64 version;          // Graph version the structures were built for
+        UInt32 num_nodes;
+        UInt32 num_k;
+        UInt32 spilled;
+        UInt32 candidates;
+        std::vector< UInt32> index;     // Dense number, indexed by node id
+        std::vector< UInt32> offsets;   // Neighbours in compressed sparse row form,
+        std::vector< UInt32> neighbours; // every row is sorted and has no repeats
+        BitVector matrix;               // Lower triangle, empty for big graphs
+        std::vector< float> costs;      // All arrays by node are indexed by dense numbers
+        std::vector< UInt32> degrees;   // Neighbours left while simplifying
+        std::vector< UInt32> colors;
+    };
+
+    template < class G> const UInt32 GraphColoring< G>::NO_COLOR;
+    template < class G> const UInt32 GraphColoring< G>::MATRIX_MAX_NODES;
+
+    template < class G>
+    GraphColoring< G>::GraphColoring( G& g, UInt32 k):
+        graph_p( &g),
+        version( g.version()),
+        num_nodes( 0),
+        num_k( k),
+        spilled( 0),
+        candidates( 0),
+        index( g.node_uid_limit(), NO_COLOR)
+    {
+        GRAPH_ASSERTXD( k > 0, "Coloring needs at least one color");
+
+        for ( typename G::node_iterator n = g.nodes_begin(), end = g.nodes_end(); n != end; ++n)
+        {
+            index[ n->uid()] = num_nodes++;
+        }
+
+        // The edge lists are walked once, both ends of an edge get a neighbour
+        std::vector< std::pair< UInt32, UInt32> > pairs;
+        pairs.reserve( g.num_edges());
+        offsets.assign( num_nodes + 1, 0);
+        for ( typename G::edge_iterator e = g.edges_begin(), end = g.edges_end(); e != end; ++e)
+        {
+            UInt32 p = index[ e->pred().uid()];
+            UInt32 s = index[ e->succ().uid()];
+
+            if ( p == s)
+                continue;
+            pairs.push_back( std::make_pair( p, s));
+            offsets[ p + 1]++;
+            offsets[ s + 1]++;
+        }
+        for ( UInt32 i = 0; i < num_nodes; i++)
+        {
+            offsets[ i + 1] += offsets[ i];
+        }
+        neighbours.resize( offsets[ num_nodes] + 1); // one more entry keeps &neighbours[ 0] valid
+        std::vector< UInt32> fill( offsets.begin(), offsets.end() - 1);
+        for ( size_t k = 0; k < pairs.size(); k++)
+        {
+            neighbours[ fill[ pairs[ k].first]++] = pairs[ k].second;
+            neighbours[ fill[ pairs[ k].second]++] = pairs[ k].first;
+        }
+        std::vector< std::pair< UInt32, UInt32> >().swap( pairs);
+
+        // Sort the rows and drop the repeats, packing the rows to the front
+        UInt32 packed = 0;
+        for ( UInt32 i = 0; i < num_nodes; i++)
+        {
+            UInt32 *row = &neighbours[ 0] + offsets[ i];
+            UInt32 *row_end = &neighbours[ 0] + offsets[ i + 1];
+
+            std::sort( row, row_end);
+            offsets[ i] = packed;
+            for ( UInt32 *m = row; m != row_end; ++m)
+            {
+                if ( m == row || *m != m[ -1])
+                    neighbours[ packed++] = *m;
+            }
+        }
+        offsets[ num_nodes] = packed;
+        neighbours.resize( packed + 1);
+
+        if ( num_nodes >= 2 && num_nodes <= MATRIX_MAX_NODES)
+        {
+            matrix.resize( (UInt32)( ( UInt64)num_nodes * ( num_nodes - 1) / 2));
+            for ( UInt32 i = 0; i < num_nodes; i++)
+            {
+                // Every pair once, from the node with the bigger number
+                for ( UInt32 e = offsets[ i]; e < offsets[ i + 1] && neighbours[ e] < i; e++)
+                {
+                    matrix.set( (UInt32)matrixBit( i, neighbours[ e]));
+                }
+            }
+        }
+        costs.assign( num_nodes, 1.0f);
+        colors.assign( num_nodes, NO_COLOR);
+
+        RA_LOG( "Interference graph: " << num_nodes << " nodes, " << packed / 2 << " interferences, "
+                << ( has_matrix() ? "with" : "without") << " bit matrix\n");
+    }
+
+    template < class G>
+    bool GraphColoring< G>::valid() const
+    {
+        return version == graph_p->version();
+    }
+
+    template < class G>
+    UInt64 GraphColoring< G>::matrixBit( UInt32 i, UInt32 j) const
+    {
+        if ( i < j)
+            std::swap( i, j);
+        return ( UInt64)i * ( i - 1) / 2 + j;
+    }
+
+    template < class G>
+    bool GraphColoring< G>::interferes( const NodeT& a, const NodeT& b) const
+    {
+        UInt32 i = number( a);
+        UInt32 j = number( b);
+
+        if ( i == j)
+            return false;
+        if ( matrix.size() != 0)
+            return matrix.test( (UInt32)matrixBit( i, j));
+
+        if ( offsets[ i + 1] - offsets[ i] > offsets[ j + 1] - offsets[ j])
+            std::swap( i, j);
+        return std::binary_search( &neighbours[ 0] + offsets[ i], &neighbours[ 0] + offsets[ i + 1], j);
+    }
+
+    template < class G>
+    void GraphColoring< G>::set_spill_cost( const NodeT& n, float cost)
+    {
+        GRAPH_ASSERTXD( cost >= 0, "Spill cost is negative");
+        costs[ number( n)] = cost;
+    }
+
+    template < class G>
+    UInt64 GraphColoring< G>::spillEntry( UInt32 i) const
+    {
+        float key = costs[ i] / degrees[ i];
+        UInt32 bits;
+
+        std::memcpy( &bits, &key, sizeof( bits));
+        return ( ( UInt64)bits << 32) | i;
+    }
+
+    template < class G>
+    UInt32 GraphColoring< G>::pickSpill( SpillHeap& heap, const SparseSet& spill_list)
+    {
+        // The heap is made when the first candidate is needed, so the nodes simplified
+        // before that never get to it
+        if ( heap.empty())
+        {
+            for ( SparseSet::const_iterator it = spill_list.begin(); it != spill_list.end(); ++it)
+            {
+                heap.push_back( spillEntry( *it));
+            }
+            std::make_heap( heap.begin(), heap.end(), std::greater< UInt64>());
+        }
+
+        // Keys only grow as neighbours are removed, so an entry with an old key is pushed
+        // again with the current one and the entries of simplified nodes are dropped
+        while ( true)
+        {
+            GRAPH_ASSERTXD( !heap.empty(), "Spill list node is missing in the heap");
+            UInt64 top = heap.front();
+            UInt32 i = (UInt32)top;
+
+            std::pop_heap( heap.begin(), heap.end(), std::greater< UInt64>());
+            heap.pop_back();
+            if ( !spill_list.contains( i))
+                continue;
+            if ( top != spillEntry( i))
+            {
+                heap.push_back( spillEntry( i));
+                std::push_heap( heap.begin(), heap.end(), std::greater< UInt64>());
+                continue;
+            }
+            return i;
+        }
+    }
+
+    template < class G>
+    UInt32 GraphColoring< G>::color()
+    {
+        GRAPH_ASSERTXD( valid(), "Graph was changed after the interference structures were built");
+
+        SparseSet simplify_list( num_nodes);
+        SparseSet spill_list( num_nodes);
+        SpillHeap heap;
+        BitVector removed( num_nodes);
+        std::vector< UInt32> stack;
+
+        stack.reserve( num_nodes);
+        degrees.resize( num_nodes);
+        for ( UInt32 i = 0; i < num_nodes; i++)
+        {
+            degrees[ i] = offsets[ i + 1] - offsets[ i];
+            if ( degrees[ i] < num_k)
+            {
+                simplify_list.insert( i);
+            } else
+            {
+                spill_list.insert( i);
+            }
+        }
+
+        candidates = 0;
+        while ( !simplify_list.empty() || !spill_list.empty())
+        {
+            UInt32 i;
+
+            if ( !simplify_list.empty())
+            {
+                i = simplify_list.pop();
+            } else
+            {
+                i = pickSpill( heap, spill_list);
+                spill_list.erase( i);
+                candidates++;
+                RA_LOGV( 2, "Spill candidate " << i << " with " << degrees[ i] << " neighbours left\n");
+            }
+            removed.set( i);
+            stack.push_back( i);
+
+            // A neighbour going down to k - 1 neighbours can be colored whatever they get
+            for ( UInt32 e = offsets[ i]; e < offsets[ i + 1]; e++)
+            {
+                UInt32 m = neighbours[ e];
+
+                if ( !removed.test( m) && degrees[ m]-- == num_k)
+                {
+                    spill_list.erase( m);
+                    simplify_list.insert( m);
+                }
+            }
+        }
+        selectColors( stack);
+
+        RA_LOG( "Colored " << num_nodes << " nodes with " << num_k << " colors: "
+                << candidates << " spill candidates, " << spilled << " spilled\n");
+        return spilled;
+    }
+
+    template < class G>
+    void GraphColoring< G>::selectColors( const std::vector< UInt32>& stack)
+    {
+        // A color is taken by a neighbour if its stamp is the number of the current step
+        std::vector< UInt32> taken( num_k, NO_COLOR);
+
+        colors.assign( num_nodes, NO_COLOR);
+        spilled = 0;
+        for ( UInt32 step = 0; step < stack.size(); step++)
+        {
+            UInt32 i = stack[ stack.size() - 1 - step];
+
+            for ( UInt32 e = offsets[ i]; e < offsets[ i + 1]; e++)
+            {
+                UInt32 c = colors[ neighbours[ e]];
+
+                if ( c != NO_COLOR)
+                    taken[ c] = step;
+            }
+
+            UInt32 c = 0;
+            while ( c < num_k && taken[ c] == step)
+            {
+                c++;
+            }
+            if ( c < num_k)
+            {
+                colors[ i] = c;
+            } else
+            {
+                spilled++;
+                RA_LOGV( 1, "Spilled " << i << "\n");
+            }
+        }
+    }
+
+    template < class G>
+    size_t GraphColoring< G>::memory_size() const
+    {
+        return sizeof( *this)
+               + index.capacity() * sizeof( UInt32)
+               + offsets.capacity() * sizeof( UInt32)
+               + neighbours.capacity() * sizeof( UInt32)
+               + matrix.numWords() * sizeof( BitVector::Word)
+               + costs.capacity() * sizeof( float)
+               + degrees.capacity() * sizeof( UInt32)
+               + colors.capacity() * sizeof( UInt32);
+    }
+};
+
+#endif /* TASK_GRAPH_COLOR_H */
@@ -0,0 +1,128 @@
+/**
+ * @file: task/graph_csr.h
+ * Compressed sparse row snapshot of a graph for read-only passes
+ */
+#pragma once
+
+#ifndef TASK_GRAPH_CSR_H
+#define TASK_GRAPH_CSR_H
+
+namespace Task
+{
+    //
+    // Immutable snapshot of graph adjacency in compressed sparse row form
+    // @param G graph type
+    //
+    // Successors and predecessors of every node are kept as ranges of node ids in two
+    // contiguous arrays, with offsets indexed by node id, so a traversal reads memory
+    // sequentially instead of following edge lists. The edge ids go in parallel arrays.
+    // Ids of removed nodes get empty ranges. The view is obtained by Graph::freeze()
+    // and is valid until the graph is changed
+    //
+    template < class G> class CsrView
+    {
+    public:
+        typedef typename G::UId UId;
+        typedef const UId *iterator; // Iterator over the ids of adjacent nodes or edges
+
+        UId node_uid_limit() const { return num_ids; } // Get the number all node ids are less than
+        UInt32 num_edges() const { return num_edge_entries; } // Get the number of edges
+        bool valid() const; // Check that the graph was not changed after the snapshot
+
+        typename G::NodeType *node( UId uid) const { return nodes[ uid]; } // Node with the id, null if there is none
+
+        iterator succs_begin( UId uid) const { return &succ_ids[ succ_offsets[ uid]]; }     // Successor node ids
+        iterator succs_end( UId uid) const { return &succ_ids[ 0] + succ_offsets[ uid + 1]; }
+        iterator preds_begin( UId uid) const { return &pred_ids[ pred_offsets[ uid]]; }     // Predecessor node ids
+        iterator preds_end( UId uid) const { return &pred_ids[ 0] + pred_offsets[ uid + 1]; }
+        iterator succ_edges_begin( UId uid) const { return &succ_edge_ids[ succ_offsets[ uid]]; } // Edge ids in the order
+        iterator pred_edges_begin( UId uid) const { return &pred_edge_ids[ pred_offsets[ uid]]; } // of the node ids
+
+        UInt32 num_succs( UId uid) const { return succ_offsets[ uid + 1] - succ_offsets[ uid]; }
+        UInt32 num_preds( UId uid) const { return pred_offsets[ uid + 1] - pred_offsets[ uid]; }
+
+    private:
+        friend G;
+
+        explicit CsrView( const G& g); // Only the graph creates views
+        void build( G& g);             // Fill the arrays from the current graph
+
+        // ---- Copy constructor and assignment turned off ----
+        CsrView( const CsrView& v);
+        CsrView& operator = ( const CsrView& v);
+
+        const G *graph_p;
+        UInt64 version;  // Graph version the view was built for
+        UId num_ids;
+        UInt32 num_edge_entries;
+        std::vector< typename G::NodeType *> nodes;
+        std::vector< UInt32> succ_offsets; // num_ids + 1 offsets, the range of node n is [offsets[n], offsets[n + 1])
+        std::vector< UInt32> pred_offsets;
+        std::vector< UId> succ_ids;
+        std::vector< UId> pred_ids;
+        std::vector< UId> succ_edge_ids;
+        std::vector< UId> pred_edge_ids;
+    };
+
+    template < class G>
+    CsrView< G>::CsrView( const G& g):
+        graph_p( &g),
+        version( 0),
+        num_ids( 0),
+        num_edge_entries( 0)
+    {
+    }
+
+    template < class G>
+    bool CsrView< G>::valid() const
+    {
+        return version == graph_p->version();
+    }
+
+    template < class G>
+    void CsrView< G>::build( G& g)
+    {
+        num_ids = g.node_uid_limit();
+        num_edge_entries = g.num_edges();
+        version = g.version();
+
+        // Degrees are known in every node, so the offsets are computed before the ids are written
+        nodes.assign( num_ids, NULL);
+        succ_offsets.assign( num_ids + 1, 0);
+        pred_offsets.assign( num_ids + 1, 0);
+        for ( typename G::node_iterator n = g.nodes_begin(), end = g.nodes_end(); n != end; ++n)
+        {
+            nodes[ n->uid()] = &*n;
+            succ_offsets[ n->uid() + 1] = n->num_succs();
+            pred_offsets[ n->uid() + 1] = n->num_preds();
+        }
+        for ( UId i = 0; i < num_ids; i++)
+        {
+            succ_offsets[ i + 1] += succ_offsets[ i];
+            pred_offsets[ i + 1] += pred_offsets[ i];
+        }
+
+        succ_ids.resize( num_edge_entries + 1); // one more entry keeps &ids[ 0] valid for empty graphs
+        pred_ids.resize( num_edge_entries + 1);
+        succ_edge_ids.resize( num_edge_entries + 1);
+        pred_edge_ids.resize( num_edge_entries + 1);
+        for ( typename G::node_iterator n = g.nodes_begin(), end = g.nodes_end(); n != end; ++n)
+        {
+            UInt32 pos = succ_offsets[ n->uid()];
+
+            for ( typename G::Node::succ_iterator e = n->succs_begin(), e_end = n->succs_end(); e != e_end; ++e, ++pos)
+            {
+                succ_ids[ pos] = e->succ().uid();
+                succ_edge_ids[ pos] = e->uid();
+            }
+            pos = pred_offsets[ n->uid()];
+            for ( typename G::Node::pred_iterator e = n->preds_begin(), e_end = n->preds_end(); e != e_end; ++e, ++pos)
+            {
+                pred_ids[ pos] = e->pred().uid();
+                pred_edge_ids[ pos] = e->uid();
+            }
+        }
+    }
+};
+
+#endif /* TASK_GRAPH_CSR_H */
@@ -0,0 +1,386 @@
+/**
+ * @file: task/graph_dataflow.h
+ * Bit-vector dataflow analysis over a graph
+ */
+#pragma once
+
+#ifndef TASK_GRAPH_DATAFLOW_H
+#define TASK_GRAPH_DATAFLOW_H
+
+namespace Task
+{
+    // Direction the facts flow in
+    enum DataflowDirection
+    {
+        DATAFLOW_FORWARD,  // from predecessors to successors, like reaching definitions
+        DATAFLOW_BACKWARD  // from successors to predecessors, like liveness
+    };
+
+    // Way the facts of several neighbours are joined
+    enum DataflowMeet
+    {
+        DATAFLOW_UNION,       // a fact holds if it holds on some path ("may" problems)
+        DATAFLOW_INTERSECTION // a fact holds if it holds on all paths ("must" problems)
+    };
+
+    //
+    // Writable view of the bits of one node
+    //
+    class DataflowBits
+    {
+    public:
+        typedef Utils::BitVector::Word Word;
+
+        DataflowBits( Word *w): words( w){}
+
+        void set( UInt32 bit) { words[ bit / 64] |= ( Word)1 << ( bit % 64); }
+        void reset( UInt32 bit) { words[ bit / 64] &= ~( ( Word)1 << ( bit % 64)); }
+        bool test( UInt32 bit) const { return ( words[ bit / 64] >> ( bit % 64)) & 1; }
+    private:
+        Word *words;
+    };
+
+    //
+    // Base of the problems solved by DataflowSolver
+    // @param G graph type
+    //
+    // A problem inherits this class and defines
+    // @code
+    //  void init( NodeT& n, DataflowBits gen, DataflowBits kill); // Set the facts the node generates and kills
+    // @endcode
+    // The transfer function of a node is out = gen | ( in & ~kill) where in is the state
+    // the node starts with in the direction of the problem. A problem may define its own
+    // transfer() with the same signature to replace it.
+    //
+    template < class G> class DataflowProblem
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+        typedef DataflowBits::Word Word;
+
+        DataflowProblem( DataflowDirection dir, DataflowMeet m, UInt32 facts):
+            problem_direction( dir), problem_meet( m), facts_num( facts){}
+
+        DataflowDirection direction() const { return problem_direction; }
+        DataflowMeet meet() const { return problem_meet; }
+        UInt32 num_facts() const { return facts_num; }
+
+        // Apply the node to the facts in 'from' and store them to 'to', return true if 'to' changed
+        bool transfer( NodeT& n, const Word *from, Word *to, const Word *gen, const Word *kill, UInt32 num_words);
+    private:
+        DataflowDirection problem_direction;
+        DataflowMeet problem_meet;
+        UInt32 facts_num;
+    };
+
+    //
+    // Solver of a bit-vector dataflow problem over the nodes reachable from the entry
+    // @param G graph type
+    // @param P problem type, inherits DataflowProblem< G>
+    //
+    // Facts of a node are rows of 64-bit words in dense arrays indexed by reverse
+    // post-order numbers, so a meet or a transfer is a loop over words that the compiler
+    // vectorizes. Nodes are processed in sweeps over reverse post-order (post-order for
+    // backward problems) and a sweep visits only the nodes whose neighbours changed: they
+    // are bits keyed by the order, so the sweep skips the others a word at a time. A change
+    // coming along a back edge defers its node to the next sweep, so a problem without loops
+    // converges in one sweep and loops add a sweep per nesting level of the changes. The meet
+    // of a node is kept only while its transfer runs and the stored one is computed once at
+    // the fixed point. A problem that keeps the default transfer stores only the words of gen
+    // and kill with bits in them, so a transfer touches the memory of the states alone.
+    // The boundary state (at the entry or at the nodes without successors) is empty. Facts
+    // of the nodes are initialized to empty for union problems and to all facts for
+    // intersection ones
+    //
+    template < class G, class P> class DataflowSolver
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+        typedef DataflowBits::Word Word;
+
+        DataflowSolver( G& g, NodeT& entry, P& p); //< Constructor, takes gen and kill sets from the problem
+
+        void solve(); // Compute the fixed point
+
+        bool is_reachable( const NodeT& n) const { return number( n) != NONE; }
+        // ---- Results of solve() ----
+        bool in( const NodeT& n, UInt32 fact) const;  // Check if the fact holds at the node entry
+        bool out( const NodeT& n, UInt32 fact) const; // Check if the fact holds at the node exit
+        const Word *in_words( const NodeT& n) const { return &ins[ 0] + ( size_t)number( n) * num_words; }
+        const Word *out_words( const NodeT& n) const { return &outs[ 0] + ( size_t)number( n) * num_words; }
+        UInt32 words_per_node() const { return num_words; }
+
+        UInt32 num_sweeps() const { return sweeps; }           // Sweeps made by the last solve()
+        UInt64 num_evaluations() const { return evaluations; } // Transfers made by the last solve()
+        size_t memory_size() const; // Bytes taken by the node states
+    private:
+        static const UInt32 NONE = (UInt32)-1;
+
+        // True if the problem keeps the default transfer
+        static const bool DEFAULT_TRANSFER = std::is_same< decltype( &P::transfer), decltype( &DataflowProblem< G>::transfer)>::value;
+
+        // Word of gen and kill at the index in the node row
+        struct MaskWord
+        {
+            UInt32 index;
+            Word gen;
+            Word kill;
+
+            MaskWord( UInt32 i, Word g, Word k): index( i), gen( g), kill( k){}
+        };
+
+        UInt32 number( const NodeT& n) const { return n.uid() < rpo_num.size() ? rpo_num[ n.uid()] : NONE; }
+        Word *row( std::vector< Word>& rows, UInt32 i) { return &rows[ 0] + ( size_t)i * num_words; }
+        void meetInto( Word *to, const std::vector< UInt32>& offsets, const std::vector< UInt32>& nodes,
+                       UInt32 i, const std::vector< Word>& rows);
+        void meetAt( Word *to, UInt32 i, bool forward, const std::vector< Word>& rows);
+        bool transferMasks( UInt32 i, Word *from, Word *to); // The default transfer, changes 'from'
+
+        // ---- Copy constructor and assignment turned off ----
+        DataflowSolver( const DataflowSolver& s);
+        DataflowSolver& operator = ( const DataflowSolver& s);
+
+        P& problem;
+        UInt32 num_nodes;
+        UInt32 num_words;
+        UInt32 sweeps;
+        UInt64 evaluations;
+        std::vector< UInt32> rpo_num;    // Reverse post-order number, indexed by node id
+        std::vector< NodeT *> rpo_nodes;
+        std::vector< UInt32> pred_offsets; // Reachable neighbours in compressed sparse row form
+        std::vector< UInt32> preds;
+        std::vector< UInt32> succ_offsets;
+        std::vector< UInt32> succs;
+        std::vector< Word> ins;            // num_words words for every node
+        std::vector< Word> outs;
+        std::vector< Word> gens;           // Dense gen and kill for a problem with its own transfer
+        std::vector< Word> kills;
+        std::vector< UInt32> mask_offsets; // Sparse gen and kill for the default transfer
+        std::vector< MaskWord> masks;
+    };
+
+    template < class G>
+    bool DataflowProblem< G>::transfer( NodeT&, const Word *from, Word *to, const Word *gen, const Word *kill, UInt32 num_words)
+    {
+        Word diff = 0;
+
+        for ( UInt32 k = 0; k < num_words; k++)
+        {
+            Word w = gen[ k] | ( from[ k] & ~kill[ k]);
+
+            diff |= w ^ to[ k];
+            to[ k] = w;
+        }
+        return diff != 0;
+    }
+
+    template < class G, class P> const UInt32 DataflowSolver< G, P>::NONE;
+
+    template < class G, class P>
+    DataflowSolver< G, P>::DataflowSolver( G& g, NodeT& entry, P& p):
+        problem( p),
+        num_words( ( p.num_facts() + 63) / 64),
+        sweeps( 0),
+        evaluations( 0),
+        rpo_num( g.node_uid_limit(), NONE)
+    {
+        for ( RpoIterator< G> it( g, entry); !it.done(); ++it)
+        {
+            rpo_num[ it->uid()] = it.index();
+            rpo_nodes.push_back( &*it);
+        }
+        num_nodes = (UInt32)rpo_nodes.size();
+
+        pred_offsets.assign( num_nodes + 1, 0);
+        succ_offsets.assign( num_nodes + 1, 0);
+        for ( UInt32 i = 0; i < num_nodes; i++)
+        {
+            NodeT *node = rpo_nodes[ i];
+
+            for ( typename G::Node::pred_iterator e = node->preds_begin(), end = node->preds_end(); e != end; ++e)
+            {
+                if ( rpo_num[ e->pred().uid()] != NONE)
+                    preds.push_back( rpo_num[ e->pred().uid()]);
+            }
+            for ( typename G::Node::succ_iterator e = node->succs_begin(), end = node->succs_end(); e != end; ++e)
+            {
+                succs.push_back( rpo_num[ e->succ().uid()]);
+            }
+            pred_offsets[ i + 1] = (UInt32)preds.size();
+            succ_offsets[ i + 1] = (UInt32)succs.size();
+        }
+
+        // One more row keeps &rows[ 0] valid for problems without facts
+        size_t size = ( size_t)num_nodes * num_words + 1;
+        if ( DEFAULT_TRANSFER)
+        {
+            std::vector< Word> gen( num_words + 1, 0);
+            std::vector< Word> kill( num_words + 1, 0);
+
+            mask_offsets.assign( num_nodes + 1, 0);
+            for ( UInt32 i = 0; i < num_nodes; i++)
+            {
+                p.init( *rpo_nodes[ i], DataflowBits( &gen[ 0]), DataflowBits( &kill[ 0]));
+                for ( UInt32 k = 0; k < num_words; k++)
+                {
+                    if ( ( gen[ k] | kill[ k]) == 0)
+                        continue;
+                    masks.push_back( MaskWord( k, gen[ k], kill[ k]));
+                    gen[ k] = kill[ k] = 0;
+                }
+                mask_offsets[ i + 1] = (UInt32)masks.size();
+            }
+        } else
+        {
+            gens.assign( size, 0);
+            kills.assign( size, 0);
+            for ( UInt32 i = 0; i < num_nodes; i++)
+            {
+                p.init( *rpo_nodes[ i], DataflowBits( row( gens, i)), DataflowBits( row( kills, i)));
+            }
+        }
+    }
+
+    template < class G, class P>
+    void DataflowSolver< G, P>::meetInto( Word *to, const std::vector< UInt32>& offsets, const std::vector< UInt32>& nodes,
+                                          UInt32 i, const std::vector< Word>& rows)
+    {
+        bool is_union = problem.meet() == DATAFLOW_UNION;
+
+        if ( offsets[ i] == offsets[ i + 1])
+            std::fill( to, to + num_words, 0); // the boundary state
+        for ( UInt32 k = offsets[ i]; k < offsets[ i + 1]; k++)
+        {
+            const Word *from = &rows[ 0] + ( size_t)nodes[ k] * num_words;
+
+            if ( k == offsets[ i])
+            {
+                std::copy( from, from + num_words, to);
+            } else if ( is_union)
+            {
+                Utils::BitVector::orWords( to, from, num_words);
+            } else
+            {
+                Utils::BitVector::andWords( to, from, num_words);
+            }
+        }
+    }
+
+    template < class G, class P>
+    bool DataflowSolver< G, P>::transferMasks( UInt32 i, Word *from, Word *to)
+    {
+        for ( UInt32 m = mask_offsets[ i]; m < mask_offsets[ i + 1]; m++)
+        {
+            Word& w = from[ masks[ m].index];
+
+            w = masks[ m].gen | ( w & ~masks[ m].kill);
+        }
+        // An unchanged row is not written, so it is not written back to memory either
+        if ( Utils::BitVector::equalWords( from, to, num_words))
+            return false;
+        std::copy( from, from + num_words, to);
+        return true;
+    }
+
+    template < class G, class P>
+    void DataflowSolver< G, P>::meetAt( Word *to, UInt32 i, bool forward, const std::vector< Word>& rows)
+    {
+        // The entry of a forward problem also has the empty boundary state coming in
+        if ( forward && i == 0 && problem.meet() == DATAFLOW_INTERSECTION)
+        {
+            std::fill( to, to + num_words, 0);
+        } else if ( forward)
+        {
+            meetInto( to, pred_offsets, preds, i, rows);
+        } else
+        {
+            meetInto( to, succ_offsets, succs, i, rows);
+        }
+    }
+
+    template < class G, class P>
+    void DataflowSolver< G, P>::solve()
+    {
+        bool forward = problem.direction() == DATAFLOW_FORWARD;
+        size_t size = ( size_t)num_nodes * num_words + 1;
+        Word init = problem.meet() == DATAFLOW_UNION ? 0 : ~( Word)0;
+
+        // The state a transfer starts from is computed by the meet, the other one is its result
+        std::vector< Word>& from_rows = forward ? ins : outs;
+        std::vector< Word>& to_rows = forward ? outs : ins;
+        const std::vector< UInt32>& dst_offsets = forward ? succ_offsets : pred_offsets;
+        const std::vector< UInt32>& dst_nodes = forward ? succs : preds;
+
+        to_rows.assign( size, init);
+
+        // Pending nodes by their position in the processing order. A change makes the nodes
+        // ahead of the current one pending in this sweep and the ones behind it, reached
+        // over back edges, pending in the next one
+        Utils::BitVector pending( num_nodes);
+        Utils::BitVector deferred( num_nodes);
+        std::vector< Word> state( num_words + 1); // Meet of the current node, stays in the cache
+
+        pending.setAll();
+        sweeps = 0;
+        evaluations = 0;
+        while ( !pending.none())
+        {
+            sweeps++;
+            for ( UInt32 k = pending.first(); k != Utils::BitVector::NONE; k = pending.next( k + 1))
+            {
+                UInt32 i = forward ? k : num_nodes - 1 - k;
+
+                evaluations++;
+                meetAt( &state[ 0], i, forward, to_rows);
+                bool changed = DEFAULT_TRANSFER
+                               ? transferMasks( i, &state[ 0], row( to_rows, i))
+                               : problem.transfer( *rpo_nodes[ i], &state[ 0], row( to_rows, i), row( gens, i), row( kills, i), num_words);
+                if ( !changed)
+                    continue;
+                for ( UInt32 d = dst_offsets[ i]; d < dst_offsets[ i + 1]; d++)
+                {
+                    UInt32 n = forward ? dst_nodes[ d] : num_nodes - 1 - dst_nodes[ d];
+
+                    if ( n > k)
+                        pending.set( n);
+                    else
+                        deferred.set( n);
+                }
+            }
+            std::swap( pending, deferred);
+            deferred.clear();
+        }
+
+        // The meets are not kept during the solve, they are computed once from the fixed point
+        from_rows.resize( size);
+        for ( UInt32 i = 0; i < num_nodes; i++)
+        {
+            meetAt( row( from_rows, i), i, forward, to_rows);
+        }
+    }
+
+    template < class G, class P>
+    bool DataflowSolver< G, P>::in( const NodeT& n, UInt32 fact) const
+    {
+        UInt32 i = number( n);
+
+        return i != NONE && ( ins[ ( size_t)i * num_words + fact / 64] >> ( fact % 64)) & 1;
+    }
+
+    template < class G, class P>
+    bool DataflowSolver< G, P>::out( const NodeT& n, UInt32 fact) const
+    {
+        UInt32 i = number( n);
+
+        return i != NONE && ( outs[ ( size_t)i * num_words + fact / 64] >> ( fact % 64)) & 1;
+    }
+
+    template < class G, class P>
+    size_t DataflowSolver< G, P>::memory_size() const
+    {
+        return ( ins.capacity() + outs.capacity() + gens.capacity() + kills.capacity()) * sizeof( Word)
+               + masks.capacity() * sizeof( MaskWord) + mask_offsets.capacity() * sizeof( UInt32);
+    }
+};
+
+#endif /* TASK_GRAPH_DATAFLOW_H */
@@ -0,0 +1,289 @@
+/**
+ * @file: task/graph_df.h
+ * Dominance frontiers and phi placement
+ */
+#pragma once
+
+#ifndef TASK_GRAPH_DF_H
+#define TASK_GRAPH_DF_H
+
+namespace Task
+{
+    //
+    // Dominance frontiers of the nodes of a dominator tree and iterated dominance
+    // frontiers of node sets
+    // @param G graph type
+    //
+    // Frontiers are computed by walking up the tree from the source of every graph
+    // edge that is not a tree one and are kept in compressed sparse row form. Iterated frontiers do not use them:
+    // they are found by the Sreedhar-Gao walk over the DJ graph (dominator tree edges
+    // plus the graph edges that are not tree ones), taking the nodes deepest in the tree
+    // first, which is linear for every set. The walk skips subtrees without J edges going
+    // up to the current level, and scratch arrays are reset by a stamp, so a batch of
+    // thousands of sets costs only what the walks touch.
+    // The tree must stay alive and valid while the object is used
+    //
+    template < class G> class DomFrontier
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+        typedef typename DomTree< G>::iterator iterator; // Iterator over nodes of a frontier
+
+        explicit DomFrontier( const DomTree< G>& t); //< Constructor, computes the frontiers
+
+        iterator frontier_begin( const NodeT& n) const; // Nodes of the frontier of the node
+        iterator frontier_end( const NodeT& n) const;
+
+        // Iterated dominance frontier of the nodes in [begin, end), that is the nodes
+        // needing phi functions for a variable defined in them. The result is appended
+        // to phis in no particular order, unreachable nodes are ignored
+        template < class Iter> void idf( Iter begin, Iter end, std::vector< NodeT *>& phis);
+
+        // Phi nodes for a batch of variables, phis[ i] gets the ones of defs[ i]
+        void place_phis( const std::vector< std::vector< NodeT *> >& defs,
+                         std::vector< std::vector< NodeT *> >& phis);
+    private:
+        static const UInt32 NONE = DomTree< G>::NONE;
+
+        // Node z is in the frontiers of the nodes from its predecessor up to idom( z), not including it.
+        // The entry is its own idom in the tree arrays, so an edge to it gets up to the entry inclusive
+        UInt32 frontierStop( UInt32 z) const { return z == 0 ? NONE : tree.idoms[ z]; }
+        UInt32 walkUp( UInt32 r) const { return r == 0 ? NONE : tree.idoms[ r]; }
+
+        void nextStamp(); // Start a new set, the scratch marks of the previous one become stale
+        void visitSubtree( UInt32 root, UInt32 cur_level, std::vector< NodeT *>& phis);
+
+        // ---- Copy constructor and assignment turned off ----
+        DomFrontier( const DomFrontier& f);
+        DomFrontier& operator = ( const DomFrontier& f);
+
+        const DomTree< G>& tree;
+        // All arrays are indexed by reverse post-order numbers of the tree
+        std::vector< UInt32> df_offsets;  // Frontiers in compressed sparse row form
+        std::vector< NodeT *> df_nodes;
+        std::vector< UInt32> j_offsets;   // Graph edges that are not dominator tree edges
+        std::vector< UInt32> j_succs;
+        std::vector< UInt32> children;    // Tree children, ranges are the ones of the tree
+        std::vector< UInt32> min_j_level; // Lowest level a J edge from the subtree goes to
+
+        // Scratch state of one iterated frontier, an entry is set if it equals stamp
+        UInt32 stamp;
+        std::vector< UInt32> defined;
+        std::vector< UInt32> visited;
+        std::vector< UInt32> in_phis;
+        std::priority_queue< UInt64> bank; // Nodes waiting for a walk, the level is in the high half
+        std::vector< UInt32> stack;
+    };
+
+    template < class G> const UInt32 DomFrontier< G>::NONE;
+
+    template < class G>
+    DomFrontier< G>::DomFrontier( const DomTree< G>& t):
+        tree( t),
+        stamp( 0)
+    {
+        UInt32 num = t.num_reachable;
+
+        // Every graph edge y -> z with y not the immediate dominator of z is a J edge,
+        // z is in the frontiers of y and of the dominators of y up to idom( z)
+        std::vector< UInt32> df_count( num, 0);
+        j_offsets.assign( num + 1, 0);
+        for ( UInt32 y = 0; y < num; y++)
+        {
+            NodeT *node = t.rpo_nodes[ y];
+
+            j_offsets[ y + 1] = j_offsets[ y];
+            for ( typename G::Node::succ_iterator e = node->succs_begin(), end = node->succs_end(); e != end; ++e)
+            {
+                UInt32 z = t.rpo_num[ e->succ().uid()];
+
+                if ( z != 0 && t.idoms[ z] == y)
+                    continue;
+                j_succs.push_back( z);
+                j_offsets[ y + 1]++;
+                for ( UInt32 r = y; r != frontierStop( z); r = walkUp( r))
+                {
+                    df_count[ r]++;
+                }
+            }
+        }
+
+        df_offsets.assign( num + 1, 0);
+        for ( UInt32 y = 0; y < num; y++)
+        {
+            df_offsets[ y + 1] = df_offsets[ y] + df_count[ y];
+        }
+        df_nodes.resize( df_offsets[ num] + 1); // one more entry keeps &df_nodes[ 0] valid
+        for ( UInt32 y = 0; y < num; y++)
+        {
+            for ( UInt32 k = j_offsets[ y]; k < j_offsets[ y + 1]; k++)
+            {
+                UInt32 z = j_succs[ k];
+
+                for ( UInt32 r = y; r != frontierStop( z); r = walkUp( r))
+                {
+                    UInt32 pos = df_offsets[ r + 1] - df_count[ r]--;
+
+                    df_nodes[ pos] = t.rpo_nodes[ z];
+                }
+            }
+        }
+        // A node reached by several J edges would appear several times
+        for ( UInt32 y = 0; y < num; y++)
+        {
+            NodeT **begin = &df_nodes[ 0] + df_offsets[ y];
+            NodeT **end = &df_nodes[ 0] + df_offsets[ y + 1];
+
+            std::sort( begin, end);
+            df_count[ y] = (UInt32)( std::unique( begin, end) - begin);
+        }
+        UInt32 pos = 0;
+        for ( UInt32 y = 0; y < num; y++)
+        {
+            UInt32 begin = df_offsets[ y];
+
+            df_offsets[ y] = pos;
+            for ( UInt32 k = 0; k < df_count[ y]; k++)
+            {
+                df_nodes[ pos++] = df_nodes[ begin + k];
+            }
+        }
+        df_offsets[ num] = pos;
+
+        // Children go after the parent in the tree pre-order, so subtrees are summed up backwards
+        children.resize( num);
+        for ( UInt32 k = 0; k + 1 < num; k++)
+        {
+            children[ k] = t.rpo_num[ t.children[ k]->uid()];
+        }
+        min_j_level.assign( num, NONE);
+        for ( UInt32 k = num; k-- > 0; )
+        {
+            UInt32 y = t.rpo_num[ t.preorder[ k]->uid()];
+
+            for ( UInt32 i = j_offsets[ y]; i < j_offsets[ y + 1]; i++)
+            {
+                min_j_level[ y] = std::min( min_j_level[ y], t.levels[ j_succs[ i]]);
+            }
+            for ( UInt32 i = t.child_offsets[ y]; i < t.child_offsets[ y + 1]; i++)
+            {
+                min_j_level[ y] = std::min( min_j_level[ y], min_j_level[ children[ i]]);
+            }
+        }
+
+        defined.assign( num, 0);
+        visited.assign( num, 0);
+        in_phis.assign( num, 0);
+    }
+
+    template < class G>
+    typename DomFrontier< G>::iterator DomFrontier< G>::frontier_begin( const NodeT& n) const
+    {
+        UInt32 i = tree.number( n);
+
+        return i == NONE ? &df_nodes[ 0] : &df_nodes[ 0] + df_offsets[ i];
+    }
+
+    template < class G>
+    typename DomFrontier< G>::iterator DomFrontier< G>::frontier_end( const NodeT& n) const
+    {
+        UInt32 i = tree.number( n);
+
+        return i == NONE ? &df_nodes[ 0] : &df_nodes[ 0] + df_offsets[ i + 1];
+    }
+
+    template < class G>
+    void DomFrontier< G>::nextStamp()
+    {
+        if ( ++stamp == 0)
+        {
+            // Stamps wrapped around, old entries could be taken for new ones
+            std::fill( defined.begin(), defined.end(), 0);
+            std::fill( visited.begin(), visited.end(), 0);
+            std::fill( in_phis.begin(), in_phis.end(), 0);
+            stamp = 1;
+        }
+    }
+
+    template < class G>
+    template < class Iter>
+    void DomFrontier< G>::idf( Iter begin, Iter end, std::vector< NodeT *>& phis)
+    {
+        nextStamp();
+        for ( Iter it = begin; it != end; ++it)
+        {
+            UInt32 x = tree.number( **it);
+
+            if ( x == NONE || defined[ x] == stamp)
+                continue;
+            defined[ x] = stamp;
+            bank.push( ( ( UInt64)tree.levels[ x] << 32) | x);
+        }
+
+        // Take the nodes deepest first, nodes added later are never deeper than the current one
+        while ( !bank.empty())
+        {
+            UInt32 x = ( UInt32)bank.top();
+            UInt32 level = ( UInt32)( bank.top() >> 32);
+
+            bank.pop();
+            if ( visited[ x] != stamp && min_j_level[ x] <= level)
+            {
+                visited[ x] = stamp;
+                visitSubtree( x, level, phis);
+            }
+        }
+    }
+
+    template < class G>
+    void DomFrontier< G>::visitSubtree( UInt32 root, UInt32 cur_level, std::vector< NodeT *>& phis)
+    {
+        const std::vector< UInt32>& levels = tree.levels;
+
+        stack.push_back( root);
+        while ( !stack.empty())
+        {
+            UInt32 y = stack.back();
+
+            stack.pop_back();
+            for ( UInt32 k = j_offsets[ y]; k < j_offsets[ y + 1]; k++)
+            {
+                UInt32 z = j_succs[ k];
+
+                if ( levels[ z] <= cur_level && in_phis[ z] != stamp)
+                {
+                    in_phis[ z] = stamp;
+                    phis.push_back( tree.rpo_nodes[ z]);
+                    if ( defined[ z] != stamp)
+                        bank.push( ( ( UInt64)levels[ z] << 32) | z);
+                }
+            }
+            // Subtrees visited before were walked at a level not lower than the current one,
+            // subtrees skipped now are skipped at all lower levels too
+            for ( UInt32 k = tree.child_offsets[ y]; k < tree.child_offsets[ y + 1]; k++)
+            {
+                UInt32 c = children[ k];
+
+                if ( visited[ c] != stamp && min_j_level[ c] <= cur_level)
+                {
+                    visited[ c] = stamp;
+                    stack.push_back( c);
+                }
+            }
+        }
+    }
+
+    template < class G>
+    void DomFrontier< G>::place_phis( const std::vector< std::vector< NodeT *> >& defs,
+                                      std::vector< std::vector< NodeT *> >& phis)
+    {
+        phis.resize( defs.size());
+        for ( size_t i = 0; i < defs.size(); i++)
+        {
+            phis[ i].clear();
+            idf( defs[ i].begin(), defs[ i].end(), phis[ i]);
+        }
+    }
+};
+
+#endif /* TASK_GRAPH_DF_H */
@@ -0,0 +1,277 @@
+/**
+ * @file: task/graph_dom.h
+ * Dominator tree of a graph
+ */
+#pragma once
+
+#ifndef TASK_GRAPH_DOM_H
+#define TASK_GRAPH_DOM_H
+
+namespace Task
+{
+    //
+    // Dominator tree of the nodes reachable from the entry node
+    // @param G graph type
+    //
+    // Immediate dominators are computed by the Cooper-Harvey-Kennedy iteration over
+    // dense arrays indexed by reverse post-order numbers. Then the tree is numbered by
+    // a depth-first walk, so dominates() compares the entry and exit numbers of two
+    // nodes in O(1). Unreachable nodes have no dominators and dominate nothing.
+    // The tree is built by the constructor and is valid until the graph is changed
+    //
+    template < class G> class DomTree
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+        typedef typename G::UId UId;
+        typedef NodeT * const *iterator; // Iterator over nodes of the tree
+
+        DomTree( G& g, NodeT& entry); //< Constructor, computes the tree
+
+        NodeT& entry() const { return *rpo_nodes[ 0]; } // Get the root of the tree
+        bool valid() const;                              // Check that the graph was not changed after the computation
+
+        bool is_reachable( const NodeT& n) const; // Check if the node is reachable from the entry
+        NodeT *idom( const NodeT& n) const;       // Immediate dominator, null for the entry and unreachable nodes
+        bool dominates( const NodeT& a, const NodeT& b) const; // Check if every path from the entry to b goes through a
+        UInt32 level( const NodeT& n) const;      // Depth of the node in the tree, the entry is at 0
+
+        iterator children_begin( const NodeT& n) const; // Nodes immediately dominated by the node
+        iterator children_end( const NodeT& n) const;
+        iterator preorder_begin() const { return &preorder[ 0]; } // All reachable nodes, a node goes
+        iterator preorder_end() const { return &preorder[ 0] + num_reachable; } // before the nodes it dominates
+
+        UInt32 num_reachable_nodes() const { return num_reachable; }
+    private:
+        template < class> friend class DomFrontier;
+        template < class> friend class LoopForest;
+
+        static const UInt32 NONE = (UInt32)-1; // Number of an unreachable node
+
+        UInt32 number( const NodeT& n) const; // Reverse post-order number of the node, NONE if unreachable
+        void computeIdoms();
+        void buildTree();
+
+        // ---- Copy constructor and assignment turned off ----
+        DomTree( const DomTree& t);
+        DomTree& operator = ( const DomTree& t);
+
+        const G *graph_p;
+        UInt64 version;        // Graph version the tree was built for
+        UInt32 num_reachable;
+        std::vector< UInt32> rpo_num;    // Reverse post-order number, indexed by node id
+        std::vector< NodeT *> rpo_nodes; // Nodes by their numbers
+        // All arrays below are indexed by reverse post-order numbers
+        std::vector< UInt32> pred_offsets; // Reachable predecessors in compressed sparse row form
+        std::vector< UInt32> preds;
+        std::vector< UInt32> idoms;        // Immediate dominator, the entry is its own one
+        std::vector< UInt32> child_offsets; // Children in the tree, in compressed sparse row form
+        std::vector< NodeT *> children;
+        std::vector< UInt32> levels;
+        std::vector< UInt32> enter;        // Depth-first numbering of the tree, a dominates b
+        std::vector< UInt32> leave;        // iff enter[ a] <= enter[ b] && leave[ b] <= leave[ a]
+        std::vector< NodeT *> preorder;    // one more entry keeps &preorder[ 0] valid
+    };
+
+    template < class G> const UInt32 DomTree< G>::NONE;
+
+    template < class G>
+    DomTree< G>::DomTree( G& g, NodeT& entry):
+        graph_p( &g),
+        version( g.version()),
+        rpo_num( g.node_uid_limit(), NONE)
+    {
+        for ( RpoIterator< G> it( g, entry); !it.done(); ++it)
+        {
+            rpo_num[ it->uid()] = it.index();
+            rpo_nodes.push_back( &*it);
+        }
+        num_reachable = (UInt32)rpo_nodes.size();
+
+        // Predecessors are looked at on every pass, so they are read from the graph only once
+        pred_offsets.assign( num_reachable + 1, 0);
+        for ( UInt32 i = 0; i < num_reachable; i++)
+        {
+            NodeT *node = rpo_nodes[ i];
+
+            pred_offsets[ i + 1] = pred_offsets[ i];
+            for ( typename G::Node::pred_iterator e = node->preds_begin(), end = node->preds_end(); e != end; ++e)
+            {
+                UInt32 p = rpo_num[ e->pred().uid()];
+
+                if ( p != NONE)
+                {
+                    preds.push_back( p);
+                    pred_offsets[ i + 1]++;
+                }
+            }
+        }
+        computeIdoms();
+        buildTree();
+    }
+
+    template < class G>
+    void DomTree< G>::computeIdoms()
+    {
+        idoms.assign( num_reachable, NONE);
+        idoms[ 0] = 0;
+
+        bool changed = true;
+        while ( changed)
+        {
+            changed = false;
+            for ( UInt32 i = 1; i < num_reachable; i++)
+            {
+                UInt32 new_idom = NONE;
+
+                for ( UInt32 k = pred_offsets[ i]; k < pred_offsets[ i + 1]; k++)
+                {
+                    UInt32 p = preds[ k];
+
+                    if ( idoms[ p] == NONE)
+                        continue; // not processed yet
+                    if ( new_idom == NONE)
+                    {
+                        new_idom = p;
+                        continue;
+                    }
+                    // Walk up from both nodes to their nearest common dominator,
+                    // dominators have smaller numbers in reverse post-order
+                    UInt32 a = p;
+                    UInt32 b = new_idom;
+                    while ( a != b)
+                    {
+                        while ( a > b)
+                            a = idoms[ a];
+                        while ( b > a)
+                            b = idoms[ b];
+                    }
+                    new_idom = a;
+                }
+                if ( idoms[ i] != new_idom)
+                {
+                    idoms[ i] = new_idom;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    template < class G>
+    void DomTree< G>::buildTree()
+    {
+        child_offsets.assign( num_reachable + 1, 0);
+        for ( UInt32 i = 1; i < num_reachable; i++)
+        {
+            child_offsets[ idoms[ i] + 1]++;
+        }
+        for ( UInt32 i = 0; i < num_reachable; i++)
+        {
+            child_offsets[ i + 1] += child_offsets[ i];
+        }
+        children.resize( num_reachable); // the entry is nobody's child, so there is a spare entry
+        std::vector< UInt32> pos( child_offsets.begin(), child_offsets.end() - 1);
+        for ( UInt32 i = 1; i < num_reachable; i++)
+        {
+            children[ pos[ idoms[ i]]++] = rpo_nodes[ i];
+        }
+
+        // Number the tree by an explicit depth-first walk, pos keeps the next child to visit
+        levels.assign( num_reachable, 0);
+        enter.assign( num_reachable, 0);
+        leave.assign( num_reachable, 0);
+        preorder.clear();
+        preorder.reserve( num_reachable + 1);
+        for ( UInt32 i = 0; i < num_reachable; i++)
+        {
+            pos[ i] = child_offsets[ i];
+        }
+
+        std::vector< UInt32> stack;
+        UInt32 counter = 0;
+
+        stack.push_back( 0);
+        enter[ 0] = counter++;
+        preorder.push_back( rpo_nodes[ 0]);
+        while ( !stack.empty())
+        {
+            UInt32 top = stack.back();
+
+            if ( pos[ top] < child_offsets[ top + 1])
+            {
+                UInt32 child = rpo_num[ children[ pos[ top]++]->uid()];
+
+                levels[ child] = levels[ top] + 1;
+                enter[ child] = counter++;
+                preorder.push_back( rpo_nodes[ child]);
+                stack.push_back( child);
+            } else
+            {
+                leave[ top] = counter++;
+                stack.pop_back();
+            }
+        }
+        preorder.push_back( NULL);
+    }
+
+    template < class G>
+    bool DomTree< G>::valid() const
+    {
+        return version == graph_p->version();
+    }
+
+    template < class G>
+    UInt32 DomTree< G>::number( const NodeT& n) const
+    {
+        return n.uid() < rpo_num.size() ? rpo_num[ n.uid()] : NONE;
+    }
+
+    template < class G>
+    bool DomTree< G>::is_reachable( const NodeT& n) const
+    {
+        return number( n) != NONE;
+    }
+
+    template < class G>
+    typename DomTree< G>::NodeT *DomTree< G>::idom( const NodeT& n) const
+    {
+        UInt32 i = number( n);
+
+        return ( i == NONE || i == 0) ? NULL : rpo_nodes[ idoms[ i]];
+    }
+
+    template < class G>
+    bool DomTree< G>::dominates( const NodeT& a, const NodeT& b) const
+    {
+        UInt32 i = number( a);
+        UInt32 k = number( b);
+
+        return i != NONE && k != NONE
+               && enter[ i] <= enter[ k] && leave[ k] <= leave[ i];
+    }
+
+    template < class G>
+    UInt32 DomTree< G>::level( const NodeT& n) const
+    {
+        GRAPH_ASSERTXD( is_reachable( n), "Unreachable node has no level");
+        return levels[ number( n)];
+    }
+
+    template < class G>
+    typename DomTree< G>::iterator DomTree< G>::children_begin( const NodeT& n) const
+    {
+        UInt32 i = number( n);
+
+        return i == NONE ? &children[ 0] : &children[ 0] + child_offsets[ i];
+    }
+
+    template < class G>
+    typename DomTree< G>::iterator DomTree< G>::children_end( const NodeT& n) const
+    {
+        UInt32 i = number( n);
+
+        return i == NONE ? &children[ 0] : &children[ 0] + child_offsets[ i + 1];
+    }
+};
+
+#endif /* TASK_GRAPH_DOM_H */
@@ -1,9 +1,663 @@
 /**
- * @file: task/graph_impl.h 
+ * @file: task/graph_impl.h
  * Solution implementation of the programming task 2
  */
 
 namespace Task {
 
+// ---- Graph::Node iterators ----
 
-}; // namespace Task
\ No newline at end of file
+    //
+    // Iterator over the predecessor edges of a node
+    //
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    class Graph< NodeT, EdgeT, AllocPolicy>::Node::pred_iterator
+    {
+    public:
+        pred_iterator(): edge( NULL){}
+
+        EdgeT& operator*() const { return *edge; }
+        EdgeT* operator->() const { return edge; }
+        pred_iterator& operator++() { edge = nextEdge( edge, EDGE_LIST_PREDS); return *this; }
+        bool operator==( const pred_iterator& i) const { return edge == i.edge; }
+        bool operator!=( const pred_iterator& i) const { return edge != i.edge; }
+    private:
+        friend class Node;
+        explicit pred_iterator( EdgeT *e): edge( e){}
+
+        EdgeT *edge;
+    };
+
+    //
+    // Iterator over the successor edges of a node
+    //
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    class Graph< NodeT, EdgeT, AllocPolicy>::Node::succ_iterator
+    {
+    public:
+        succ_iterator(): edge( NULL){}
+
+        EdgeT& operator*() const { return *edge; }
+        EdgeT* operator->() const { return edge; }
+        succ_iterator& operator++() { edge = nextEdge( edge, EDGE_LIST_SUCCS); return *this; }
+        bool operator==( const succ_iterator& i) const { return edge == i.edge; }
+        bool operator!=( const succ_iterator& i) const { return edge != i.edge; }
+    private:
+        friend class Node;
+        explicit succ_iterator( EdgeT *e): edge( e){}
+
+        EdgeT *edge;
+    };
+
+// ---- Graph iterators ----
+
+    //
+    // Iterator over the nodes of a graph in the order of creation
+    //
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    class Graph< NodeT, EdgeT, AllocPolicy>::node_iterator
+    {
+    public:
+        node_iterator(): node( NULL){}
+
+        NodeT& operator*() const { return *node; }
+        NodeT* operator->() const { return node; }
+        node_iterator& operator++() { node = node->next_node; return *this; }
+        bool operator==( const node_iterator& i) const { return node == i.node; }
+        bool operator!=( const node_iterator& i) const { return node != i.node; }
+    private:
+        friend class Graph;
+        explicit node_iterator( NodeT *n): node( n){}
+
+        NodeT *node;
+    };
+
+    //
+    // Iterator over the edges of a graph in the order of creation
+    //
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    class Graph< NodeT, EdgeT, AllocPolicy>::edge_iterator
+    {
+    public:
+        edge_iterator(): edge( NULL){}
+
+        EdgeT& operator*() const { return *edge; }
+        EdgeT* operator->() const { return edge; }
+        edge_iterator& operator++() { edge = edge->next_edge; return *this; }
+        bool operator==( const edge_iterator& i) const { return edge == i.edge; }
+        bool operator!=( const edge_iterator& i) const { return edge != i.edge; }
+    private:
+        friend class Graph;
+        explicit edge_iterator( EdgeT *e): edge( e){}
+
+        EdgeT *edge;
+    };
+
+// ---- Graph::Node class implementation ----
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    Graph< NodeT, EdgeT, AllocPolicy>::Node::Node( Graph& g):
+        graph_p( &g),
+        node_uid( g.allocUId( g.free_node_uids, g.next_node_uid)),
+        next_node( NULL),
+        prev_node( NULL),
+        first_pred_edge( NULL),
+        first_succ_edge( NULL),
+        pred_num( 0),
+        succ_num( 0)
+    {
+        for ( UInt32 i = 0; i < MAX_MARKERS; i++)
+        {
+            marks[ i] = 0; // generations start from 1
+        }
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    Graph< NodeT, EdgeT, AllocPolicy>::Node::~Node()
+    {
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::Node::pred_iterator
+    Graph< NodeT, EdgeT, AllocPolicy>::Node::preds_begin()
+    {
+        return pred_iterator( first_pred_edge);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::Node::pred_iterator
+    Graph< NodeT, EdgeT, AllocPolicy>::Node::preds_end()
+    {
+        return pred_iterator( NULL);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::Node::succ_iterator
+    Graph< NodeT, EdgeT, AllocPolicy>::Node::succs_begin()
+    {
+        return succ_iterator( first_succ_edge);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::Node::succ_iterator
+    Graph< NodeT, EdgeT, AllocPolicy>::Node::succs_end()
+    {
+        return succ_iterator( NULL);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    Graph< NodeT, EdgeT, AllocPolicy>& Graph< NodeT, EdgeT, AllocPolicy>::Node::graph()
+    {
+        return *graph_p;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::UId Graph< NodeT, EdgeT, AllocPolicy>::Node::uid() const
+    {
+        return node_uid;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    EdgeT& Graph< NodeT, EdgeT, AllocPolicy>::Node::first_pred()
+    {
+        if ( isNullP( first_pred_edge))
+            throw Error();
+        return *first_pred_edge;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    EdgeT& Graph< NodeT, EdgeT, AllocPolicy>::Node::first_succ()
+    {
+        if ( isNullP( first_succ_edge))
+            throw Error();
+        return *first_succ_edge;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    UInt32 Graph< NodeT, EdgeT, AllocPolicy>::Node::num_preds() const
+    {
+        return pred_num;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    UInt32 Graph< NodeT, EdgeT, AllocPolicy>::Node::num_succs() const
+    {
+        return succ_num;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    bool Graph< NodeT, EdgeT, AllocPolicy>::Node::mark( const Marker& m)
+    {
+        GRAPH_ASSERTXD( m.index < MAX_MARKERS, "Invalid marker");
+        if ( marks[ m.index] == m.generation)
+            return false;
+        marks[ m.index] = m.generation;
+        return true;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    void Graph< NodeT, EdgeT, AllocPolicy>::Node::unmark( const Marker& m)
+    {
+        GRAPH_ASSERTXD( m.index < MAX_MARKERS, "Invalid marker");
+        marks[ m.index] = 0;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    bool Graph< NodeT, EdgeT, AllocPolicy>::Node::is_marked( const Marker& m) const
+    {
+        GRAPH_ASSERTXD( m.index < MAX_MARKERS, "Invalid marker");
+        return marks[ m.index] == m.generation;
+    }
+
+// ---- Graph::Edge class implementation ----
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    Graph< NodeT, EdgeT, AllocPolicy>::Edge::Edge( NodeT& p, NodeT& s):
+        pred_p( &p),
+        succ_p( &s),
+        edge_uid( p.graph().allocUId( p.graph().free_edge_uids, p.graph().next_edge_uid)),
+        next_edge( NULL),
+        prev_edge( NULL)
+    {
+        GRAPH_ASSERTXD( areEqP( &p.graph(), &s.graph()), "Edge connects nodes of different graphs");
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    Graph< NodeT, EdgeT, AllocPolicy>::Edge::~Edge()
+    {
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    NodeT& Graph< NodeT, EdgeT, AllocPolicy>::Edge::pred()
+    {
+        return *pred_p;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    NodeT& Graph< NodeT, EdgeT, AllocPolicy>::Edge::succ()
+    {
+        return *succ_p;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    Graph< NodeT, EdgeT, AllocPolicy>& Graph< NodeT, EdgeT, AllocPolicy>::Edge::graph()
+    {
+        return pred_p->graph();
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::UId Graph< NodeT, EdgeT, AllocPolicy>::Edge::uid() const
+    {
+        return edge_uid;
+    }
+
+// ---- Graph template class implementation ----
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    Graph< NodeT, EdgeT, AllocPolicy>::Graph():
+        first_node( NULL),
+        last_node( NULL),
+        first_edge( NULL),
+        last_edge( NULL),
+        node_num( 0),
+        edge_num( 0),
+        next_node_uid( 0),
+        next_edge_uid( 0),
+        graph_version( 0),
+        csr_view( NULL)
+    {
+        for ( UInt32 i = 0; i < MAX_MARKERS; i++)
+        {
+            marker_generations[ i] = 0;
+            marker_busy[ i] = false;
+        }
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    Graph< NodeT, EdgeT, AllocPolicy>::~Graph()
+    {
+        GRAPH_ASSERTXD( node_maps.empty() && edge_maps.empty(), "Side tables must be destroyed before the graph");
+        delete csr_view;
+
+        // Objects are destroyed in one pass over each list. A pool drops its slabs at once
+        // after that instead of taking every object back. The policies hold exactly NodeT
+        // and EdgeT objects, so the destructors are called non-virtually
+        bool edges_in_bulk = edge_alloc.exclusive();
+
+        for ( EdgeT *e = first_edge; isNotNullP( e); )
+        {
+            EdgeT *next = e->next_edge;
+
+            // Neighbours in the adjacency lists are destroyed too, the edge doesn't detach
+            e->zeroLinks();
+            e->EdgeT::~EdgeT();
+            if ( !edges_in_bulk)
+                edge_alloc.deallocate( e);
+            e = next;
+        }
+        if ( edges_in_bulk)
+            edge_alloc.deallocate_all();
+
+        bool nodes_in_bulk = node_alloc.exclusive();
+
+        for ( NodeT *n = first_node; isNotNullP( n); )
+        {
+            NodeT *next = n->next_node;
+            n->NodeT::~NodeT();
+            if ( !nodes_in_bulk)
+                node_alloc.deallocate( n);
+            n = next;
+        }
+        if ( nodes_in_bulk)
+            node_alloc.deallocate_all();
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::node_iterator
+    Graph< NodeT, EdgeT, AllocPolicy>::nodes_begin()
+    {
+        return node_iterator( first_node);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::node_iterator
+    Graph< NodeT, EdgeT, AllocPolicy>::nodes_end()
+    {
+        return node_iterator( NULL);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::edge_iterator
+    Graph< NodeT, EdgeT, AllocPolicy>::edges_begin()
+    {
+        return edge_iterator( first_edge);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::edge_iterator
+    Graph< NodeT, EdgeT, AllocPolicy>::edges_end()
+    {
+        return edge_iterator( NULL);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    UInt32 Graph< NodeT, EdgeT, AllocPolicy>::num_nodes() const
+    {
+        return node_num;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    UInt32 Graph< NodeT, EdgeT, AllocPolicy>::num_edges() const
+    {
+        return edge_num;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::UId Graph< NodeT, EdgeT, AllocPolicy>::node_uid_limit() const
+    {
+        return next_node_uid;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::UId Graph< NodeT, EdgeT, AllocPolicy>::edge_uid_limit() const
+    {
+        return next_edge_uid;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::Marker Graph< NodeT, EdgeT, AllocPolicy>::new_marker()
+    {
+        Marker m;
+
+        for ( UInt32 i = 0; i < MAX_MARKERS; i++)
+        {
+            if ( !marker_busy[ i])
+            {
+                marker_busy[ i] = true;
+                m.index = i;
+                clear_marker( m);
+                return m;
+            }
+        }
+        throw Error();
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    void Graph< NodeT, EdgeT, AllocPolicy>::clear_marker( Marker& m)
+    {
+        GRAPH_ASSERTXD( m.index < MAX_MARKERS && marker_busy[ m.index], "Invalid marker");
+
+        if ( ++marker_generations[ m.index] == 0)
+        {
+            // Generations wrapped around, old marks could be taken for new ones
+            for ( NodeT *n = first_node; isNotNullP( n); n = n->next_node)
+            {
+                n->marks[ m.index] = 0;
+            }
+            marker_generations[ m.index] = 1;
+        }
+        m.generation = marker_generations[ m.index];
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    void Graph< NodeT, EdgeT, AllocPolicy>::free_marker( Marker& m)
+    {
+        GRAPH_ASSERTXD( m.index < MAX_MARKERS && marker_busy[ m.index], "Invalid marker");
+        marker_busy[ m.index] = false;
+        m.index = MAX_MARKERS;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    UInt64 Graph< NodeT, EdgeT, AllocPolicy>::version() const
+    {
+        return graph_version;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    const CsrView< Graph< NodeT, EdgeT, AllocPolicy> >& Graph< NodeT, EdgeT, AllocPolicy>::freeze()
+    {
+        if ( isNullP( csr_view))
+        {
+            csr_view = new CsrView< Graph>( *this);
+            csr_view->build( *this);
+        } else if ( !csr_view->valid())
+        {
+            csr_view->build( *this); // the arrays are reused
+        }
+        return *csr_view;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    typename Graph< NodeT, EdgeT, AllocPolicy>::UId
+    Graph< NodeT, EdgeT, AllocPolicy>::allocUId( std::vector< UId>& free_uids, UId& next_uid)
+    {
+        if ( free_uids.empty())
+            return next_uid++;
+
+        UId uid = free_uids.back();
+        free_uids.pop_back();
+        return uid;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    void Graph< NodeT, EdgeT, AllocPolicy>::resetMaps( std::vector< UIdMapBase *>& map_list, UId uid)
+    {
+        for ( size_t i = 0; i < map_list.size(); i++)
+        {
+            map_list[ i]->reset( uid);
+        }
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    NodeT& Graph< NodeT, EdgeT, AllocPolicy>::create_node()
+    {
+        void *mem = node_alloc.allocate();
+        NodeT *node;
+
+        try
+        {
+            node = new ( mem) NodeT( *this);
+        } catch ( ...)
+        {
+            node_alloc.deallocate( mem);
+            throw;
+        }
+
+        node->prev_node = last_node;
+        if ( isNotNullP( last_node))
+        {
+            last_node->next_node = node;
+        } else
+        {
+            first_node = node;
+        }
+        last_node = node;
+        node_num++;
+        graph_version++;
+        return *node;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    EdgeT& Graph< NodeT, EdgeT, AllocPolicy>::create_edge( NodeT& pred, NodeT& succ)
+    {
+        GRAPH_ASSERTXD( areEqP( &pred.graph(), this), "Predecessor belongs to another graph");
+        GRAPH_ASSERTXD( areEqP( &succ.graph(), this), "Successor belongs to another graph");
+
+        void *mem = edge_alloc.allocate();
+        EdgeT *edge;
+
+        try
+        {
+            edge = new ( mem) EdgeT( pred, succ);
+        } catch ( ...)
+        {
+            edge_alloc.deallocate( mem);
+            throw;
+        }
+
+        edge->attach( EDGE_LIST_SUCCS, pred.first_succ_edge);
+        pred.first_succ_edge = edge;
+        pred.succ_num++;
+        edge->attach( EDGE_LIST_PREDS, succ.first_pred_edge);
+        succ.first_pred_edge = edge;
+        succ.pred_num++;
+
+        edge->prev_edge = last_edge;
+        if ( isNotNullP( last_edge))
+        {
+            last_edge->next_edge = edge;
+        } else
+        {
+            first_edge = edge;
+        }
+        last_edge = edge;
+        edge_num++;
+        graph_version++;
+        return *edge;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    EdgeT* Graph< NodeT, EdgeT, AllocPolicy>::nextEdge( EdgeT *edge, EdgeListId list)
+    {
+        return static_cast< EdgeT *>( edge->Edge::next( list));
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    void Graph< NodeT, EdgeT, AllocPolicy>::detachEdge( EdgeT& edge)
+    {
+        NodeT *pred = edge.pred_p;
+        NodeT *succ = edge.succ_p;
+
+        if ( areEqP( pred->first_succ_edge, &edge))
+            pred->first_succ_edge = nextEdge( &edge, EDGE_LIST_SUCCS);
+        edge.detach( EDGE_LIST_SUCCS);
+        pred->succ_num--;
+
+        if ( areEqP( succ->first_pred_edge, &edge))
+            succ->first_pred_edge = nextEdge( &edge, EDGE_LIST_PREDS);
+        edge.detach( EDGE_LIST_PREDS);
+        succ->pred_num--;
+
+        if ( isNotNullP( edge.prev_edge))
+        {
+            edge.prev_edge->next_edge = edge.next_edge;
+        } else
+        {
+            first_edge = edge.next_edge;
+        }
+        if ( isNotNullP( edge.next_edge))
+        {
+            edge.next_edge->prev_edge = edge.prev_edge;
+        } else
+        {
+            last_edge = edge.prev_edge;
+        }
+        edge_num--;
+        graph_version++;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    void Graph< NodeT, EdgeT, AllocPolicy>::remove( EdgeT& edge)
+    {
+        UId uid = edge.edge_uid;
+
+        detachEdge( edge);
+        edge.~EdgeT();
+        edge_alloc.deallocate( &edge);
+        resetMaps( edge_maps, uid);
+        free_edge_uids.push_back( uid);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    void Graph< NodeT, EdgeT, AllocPolicy>::remove( NodeT& node)
+    {
+        while ( isNotNullP( node.first_pred_edge))
+        {
+            remove( *node.first_pred_edge);
+        }
+        while ( isNotNullP( node.first_succ_edge))
+        {
+            remove( *node.first_succ_edge);
+        }
+
+        if ( isNotNullP( node.prev_node))
+        {
+            node.prev_node->next_node = node.next_node;
+        } else
+        {
+            first_node = node.next_node;
+        }
+        if ( isNotNullP( node.next_node))
+        {
+            node.next_node->prev_node = node.prev_node;
+        } else
+        {
+            last_node = node.prev_node;
+        }
+        node_num--;
+        graph_version++;
+
+        UId uid = node.node_uid;
+
+        node.~NodeT();
+        node_alloc.deallocate( &node);
+        resetMaps( node_maps, uid);
+        free_node_uids.push_back( uid);
+    }
+
+// ---- Graph::UIdMap template class implementation ----
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    template < class Obj, class T>
+    Graph< NodeT, EdgeT, AllocPolicy>::UIdMap< Obj, T>::UIdMap( Graph& g, const T& def):
+        graph( g),
+        default_value( def)
+    {
+        graph.maps( ( const Obj *)NULL).push_back( this);
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    template < class Obj, class T>
+    Graph< NodeT, EdgeT, AllocPolicy>::UIdMap< Obj, T>::~UIdMap()
+    {
+        std::vector< UIdMapBase *>& map_list = graph.maps( ( const Obj *)NULL);
+
+        map_list.erase( std::find( map_list.begin(), map_list.end(), this));
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    template < class Obj, class T>
+    T& Graph< NodeT, EdgeT, AllocPolicy>::UIdMap< Obj, T>::operator[]( const Obj& obj)
+    {
+        UId uid = obj.uid();
+
+        if ( uid >= values.size())
+            values.resize( graph.uidLimit( &obj), Slot( default_value));
+        return values[ uid].value;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    template < class Obj, class T>
+    const T& Graph< NodeT, EdgeT, AllocPolicy>::UIdMap< Obj, T>::operator[]( const Obj& obj) const
+    {
+        UId uid = obj.uid();
+
+        return ( uid < values.size()) ? values[ uid].value : default_value;
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    template < class Obj, class T>
+    void Graph< NodeT, EdgeT, AllocPolicy>::UIdMap< Obj, T>::clear()
+    {
+        std::fill( values.begin(), values.end(), Slot( default_value));
+    }
+
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy>
+    template < class Obj, class T>
+    void Graph< NodeT, EdgeT, AllocPolicy>::UIdMap< Obj, T>::reset( UId uid)
+    {
+        if ( uid < values.size())
+            values[ uid].value = default_value;
+    }
+
+}; // namespace Task
@@ -0,0 +1,484 @@
+/**
+ * @file: task/graph_scc.h
+ * Strongly connected components and loop nesting forest of a graph
+ */
+#pragma once
+
+#ifndef TASK_GRAPH_SCC_H
+#define TASK_GRAPH_SCC_H
+
+namespace Task
+{
+    //
+    // Strongly connected components of all nodes of a graph and their condensation
+    // @param G graph type
+    //
+    // Components are found by the iterative form of Pearce's algorithm, which keeps a
+    // single number per node id: the visit index while the node is open and the
+    // component number after it is done. Components are numbered in topological order
+    // of the condensation, edges between them go from smaller numbers to larger ones.
+    // The result is computed by the constructor and is valid until the graph is changed
+    //
+    template < class G> class SccInfo
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+        typedef NodeT * const *iterator;        // Iterator over nodes of a component
+        typedef const UInt32 *comp_iterator;    // Iterator over component numbers
+
+        static const UInt32 NONE = (UInt32)-1;
+
+        explicit SccInfo( G& g); //< Constructor, computes the components
+
+        UInt32 num_components() const { return num_comps; }
+        UInt32 component( const NodeT& n) const { return comps[ n.uid()]; } // Component of the node
+        bool is_cyclic( UInt32 c) const { return cyclic[ c] != 0; } // Check if the component has a cycle
+
+        iterator members_begin( UInt32 c) const { return &members[ 0] + member_offsets[ c]; } // Nodes of the component
+        iterator members_end( UInt32 c) const { return &members[ 0] + member_offsets[ c + 1]; }
+        UInt32 num_members( UInt32 c) const { return member_offsets[ c + 1] - member_offsets[ c]; }
+
+        comp_iterator succs_begin( UInt32 c) const { return &dag_succs[ 0] + dag_offsets[ c]; } // Successors in the
+        comp_iterator succs_end( UInt32 c) const { return &dag_succs[ 0] + dag_offsets[ c + 1]; } // condensation, no repeats
+
+        size_t memory_size() const; // Bytes taken by the result
+    private:
+        // ---- Copy constructor and assignment turned off ----
+        SccInfo( const SccInfo& s);
+        SccInfo& operator = ( const SccInfo& s);
+
+        // Depth-first search frame: the node and its next successor edge
+        struct Frame
+        {
+            NodeT *node;
+            typename G::Node::succ_iterator next;
+            bool root;  // No edge to an open node visited before this one was found yet
+        };
+
+        UInt32 num_comps;
+        std::vector< UInt32> comps;          // Component number, indexed by node id
+        std::vector< UInt32> member_offsets; // Members in compressed sparse row form
+        std::vector< NodeT *> members;
+        std::vector< UInt32> dag_offsets;    // Condensation edges in compressed sparse row form
+        std::vector< UInt32> dag_succs;
+        std::vector< char> cyclic;
+    };
+
+    //
+    // Nesting forest of the natural loops of a graph
+    // @param G graph type
+    //
+    // A natural loop is headed by a node that dominates some of its predecessors (the
+    // latches), its body is the header and the nodes reaching a latch without passing
+    // through the header. Loops with the same header are one loop. Loops are found from
+    // the dominator tree inner first and a node visited again is replaced by the header
+    // of its outermost known loop, so every node is visited about once. Cycles without
+    // a dominating header (irreducible ones) form no loops, SccInfo still finds them.
+    // Loops are numbered in pre-order of the forest, so a loop body including the
+    // nested loops is one range of nodes, and so are the subloops of a loop.
+    // The tree must stay alive and valid while the object is used
+    //
+    template < class G> class LoopForest
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+        typedef NodeT * const *iterator;     // Iterator over nodes of a loop
+        typedef const UInt32 *loop_iterator; // Iterator over loop numbers
+
+        static const UInt32 NONE = (UInt32)-1;
+
+        explicit LoopForest( const DomTree< G>& t); //< Constructor, finds the loops
+
+        UInt32 num_loops() const { return (UInt32)headers.size(); }
+        NodeT& header( UInt32 l) const { return *headers[ l]; }
+        UInt32 parent( UInt32 l) const { return parents[ l]; }  // Enclosing loop, NONE for the outermost ones
+        UInt32 depth( UInt32 l) const { return depths[ l]; }    // Nesting depth, the outermost loops have 1
+
+        UInt32 loop_of( const NodeT& n) const;    // Innermost loop containing the node, NONE if there is none
+        UInt32 node_depth( const NodeT& n) const; // Number of loops containing the node
+
+        iterator body_begin( UInt32 l) const { return &body[ 0] + body_offsets[ l]; } // Nodes of the loop and
+        iterator body_end( UInt32 l) const { return &body[ 0] + body_ends[ l]; }      // its subloops, header first
+        UInt32 body_size( UInt32 l) const { return body_ends[ l] - body_offsets[ l]; }
+
+        loop_iterator subloops_begin( UInt32 l) const { return &subloops[ 0] + subloop_offsets[ l]; } // Loops nested
+        loop_iterator subloops_end( UInt32 l) const { return &subloops[ 0] + subloop_offsets[ l + 1]; } // directly
+        loop_iterator top_loops_begin() const { return &subloops[ 0] + subloop_offsets[ num_loops()]; } // Outermost
+        loop_iterator top_loops_end() const { return &subloops[ 0] + subloop_offsets[ num_loops() + 1]; } // loops
+
+        size_t memory_size() const; // Bytes taken by the result
+    private:
+        UInt32 outermost( UInt32 l); // Outermost loop found so far containing the loop
+
+        // ---- Copy constructor and assignment turned off ----
+        LoopForest( const LoopForest& f);
+        LoopForest& operator = ( const LoopForest& f);
+
+        const DomTree< G>& tree;
+        std::vector< NodeT *> headers;        // All arrays by loop are indexed by loop numbers
+        std::vector< UInt32> parents;
+        std::vector< UInt32> depths;
+        std::vector< UInt32> body_offsets;
+        std::vector< UInt32> body_ends;
+        std::vector< NodeT *> body;           // one more entry keeps &body[ 0] valid
+        std::vector< UInt32> subloop_offsets; // num_loops() + 2 offsets, the last range is of the outermost loops
+        std::vector< UInt32> subloops;
+        std::vector< UInt32> inner;           // Innermost loop by reverse post-order number
+        std::vector< UInt32> top;             // Used while loops are found, links to enclosing loops
+    };
+
+// ---- SccInfo implementation ----
+
+    template < class G> const UInt32 SccInfo< G>::NONE;
+
+    template < class G>
+    SccInfo< G>::SccInfo( G& g):
+        comps( g.node_uid_limit(), 0)
+    {
+        UInt32 num_ids = g.node_uid_limit();
+        // Visit indexes grow from 1 and finished components are numbered down from num_ids - 1,
+        // the two ranges never meet, so a finished node never looks open
+        std::vector< UInt32>& rindex = comps;
+        std::vector< NodeT *> open;  // Visited nodes of the components that are not finished
+        std::vector< Frame> stack;
+        UInt32 index = 1;
+        UInt32 c = num_ids - 1;
+
+        for ( typename G::node_iterator n = g.nodes_begin(), end = g.nodes_end(); n != end; ++n)
+        {
+            if ( rindex[ n->uid()] != 0)
+                continue;
+
+            Frame start = { &*n, n->succs_begin(), true };
+            rindex[ n->uid()] = index++;
+            stack.push_back( start);
+            while ( !stack.empty())
+            {
+                Frame& top = stack.back();
+                NodeT *v = top.node;
+
+                if ( top.next != v->succs_end())
+                {
+                    NodeT *w = &top.next->succ();
+
+                    if ( rindex[ w->uid()] == 0)
+                    {
+                        Frame frame = { w, w->succs_begin(), true };
+
+                        rindex[ w->uid()] = index++;
+                        stack.push_back( frame); // top is not used after this
+                        continue;
+                    }
+                    if ( rindex[ w->uid()] < rindex[ v->uid()])
+                    {
+                        rindex[ v->uid()] = rindex[ w->uid()];
+                        top.root = false;
+                    }
+                    ++top.next;
+                    continue;
+                }
+
+                // All successors are done, either v heads a component or it stays open
+                bool root = top.root;
+                stack.pop_back();
+                if ( root)
+                {
+                    index--;
+                    while ( !open.empty() && rindex[ v->uid()] <= rindex[ open.back()->uid()])
+                    {
+                        rindex[ open.back()->uid()] = c;
+                        open.pop_back();
+                        index--;
+                    }
+                    rindex[ v->uid()] = c;
+                    c--;
+                } else
+                {
+                    open.push_back( v);
+                }
+                if ( !stack.empty())
+                {
+                    // Return to the parent as if the edge to v was just looked at
+                    Frame& parent = stack.back();
+                    NodeT *u = parent.node;
+
+                    if ( rindex[ v->uid()] < rindex[ u->uid()])
+                    {
+                        rindex[ u->uid()] = rindex[ v->uid()];
+                        parent.root = false;
+                    }
+                    ++parent.next;
+                }
+            }
+        }
+
+        // Components were finished sinks first, turn that into topological numbers
+        num_comps = num_ids - 1 - c;
+        std::vector< UInt32> counts( num_comps + 1, 0);
+        for ( typename G::node_iterator n = g.nodes_begin(), end = g.nodes_end(); n != end; ++n)
+        {
+            UInt32 comp = rindex[ n->uid()] - ( c + 1);
+
+            comps[ n->uid()] = comp;
+            counts[ comp + 1]++;
+        }
+        member_offsets.assign( num_comps + 1, 0);
+        for ( UInt32 i = 0; i < num_comps; i++)
+        {
+            member_offsets[ i + 1] = member_offsets[ i] + counts[ i + 1];
+            counts[ i + 1] = member_offsets[ i];
+        }
+        members.resize( g.num_nodes() + 1); // one more entry keeps &members[ 0] valid
+        for ( typename G::node_iterator n = g.nodes_begin(), end = g.nodes_end(); n != end; ++n)
+        {
+            members[ counts[ comps[ n->uid()] + 1]++] = &*n;
+        }
+
+        // Edges of the condensation, last_from filters repeats of an edge from the same component
+        std::vector< UInt32> last_from( num_comps, NONE);
+        cyclic.assign( num_comps, 0);
+        dag_offsets.assign( num_comps + 1, 0);
+        for ( UInt32 i = 0; i < num_comps; i++)
+        {
+            cyclic[ i] = num_members( i) > 1;
+            for ( iterator m = members_begin( i); m != members_end( i); ++m)
+            {
+                for ( typename G::Node::succ_iterator e = ( *m)->succs_begin(), end = ( *m)->succs_end(); e != end; ++e)
+                {
+                    UInt32 s = comps[ e->succ().uid()];
+
+                    if ( s == i)
+                    {
+                        cyclic[ i] = 1;
+                    } else if ( last_from[ s] != i)
+                    {
+                        last_from[ s] = i;
+                        dag_succs.push_back( s);
+                    }
+                }
+            }
+            dag_offsets[ i + 1] = (UInt32)dag_succs.size();
+        }
+        dag_succs.push_back( NONE); // keeps &dag_succs[ 0] valid
+    }
+
+    template < class G>
+    size_t SccInfo< G>::memory_size() const
+    {
+        return sizeof( *this)
+               + comps.capacity() * sizeof( UInt32)
+               + member_offsets.capacity() * sizeof( UInt32)
+               + members.capacity() * sizeof( NodeT *)
+               + dag_offsets.capacity() * sizeof( UInt32)
+               + dag_succs.capacity() * sizeof( UInt32)
+               + cyclic.capacity();
+    }
+
+// ---- LoopForest implementation ----
+
+    template < class G> const UInt32 LoopForest< G>::NONE;
+
+    template < class G>
+    LoopForest< G>::LoopForest( const DomTree< G>& t):
+        tree( t),
+        inner( t.num_reachable, NONE)
+    {
+        UInt32 num = t.num_reachable;
+        std::vector< UInt32> found_parents; // Loops in the order they are found, inner first
+        std::vector< UInt32> found_headers; // reverse post-order numbers of the headers
+        std::vector< UInt32> worklist;
+
+        // Inner loops have headers deeper in the dominator tree, so the tree is walked backwards
+        for ( UInt32 k = num; k-- > 0; )
+        {
+            UInt32 h = t.rpo_num[ t.preorder[ k]->uid()];
+            UInt32 loop = (UInt32)found_headers.size();
+
+            for ( UInt32 i = t.pred_offsets[ h]; i < t.pred_offsets[ h + 1]; i++)
+            {
+                UInt32 p = t.preds[ i];
+
+                if ( t.enter[ h] <= t.enter[ p] && t.leave[ p] <= t.leave[ h])
+                    worklist.push_back( p); // a latch
+            }
+            if ( worklist.empty())
+                continue;
+
+            found_headers.push_back( h);
+            found_parents.push_back( NONE);
+            top.push_back( loop);
+            inner[ h] = loop;
+            while ( !worklist.empty())
+            {
+                UInt32 x = worklist.back();
+
+                worklist.pop_back();
+                if ( inner[ x] == NONE)
+                {
+                    inner[ x] = loop;
+                } else
+                {
+                    // The node is in a loop found before, go on from the header of its outermost loop
+                    UInt32 sub = outermost( inner[ x]);
+
+                    if ( sub == loop)
+                        continue;
+                    found_parents[ sub] = loop;
+                    top[ sub] = loop;
+                    x = found_headers[ sub];
+                }
+                for ( UInt32 i = t.pred_offsets[ x]; i < t.pred_offsets[ x + 1]; i++)
+                {
+                    worklist.push_back( t.preds[ i]);
+                }
+            }
+        }
+        top.clear();
+
+        // Number the loops in pre-order of the forest
+        UInt32 num_found = (UInt32)found_headers.size();
+        std::vector< UInt32> child_offsets( num_found + 2, 0);
+        for ( UInt32 l = 0; l < num_found; l++)
+        {
+            child_offsets[ ( found_parents[ l] == NONE ? num_found : found_parents[ l]) + 1]++;
+        }
+        for ( UInt32 l = 0; l <= num_found; l++)
+        {
+            child_offsets[ l + 1] += child_offsets[ l];
+        }
+        std::vector< UInt32> found_children( num_found + 1);
+        std::vector< UInt32> pos( child_offsets.begin(), child_offsets.end() - 1);
+        for ( UInt32 l = num_found; l-- > 0; ) // outer loops were found later, this keeps the order of headers
+        {
+            UInt32 p = found_parents[ l] == NONE ? num_found : found_parents[ l];
+
+            found_children[ pos[ p]++] = l;
+        }
+
+        std::vector< UInt32> number( num_found, NONE);
+        std::vector< UInt32> own( num_found, 0);
+        std::vector< UInt32> order;
+        std::vector< UInt32> stack;
+
+        for ( UInt32 i = child_offsets[ num_found + 1]; i-- > child_offsets[ num_found]; )
+        {
+            stack.push_back( found_children[ i]);
+        }
+        while ( !stack.empty())
+        {
+            UInt32 l = stack.back();
+
+            stack.pop_back();
+            number[ l] = (UInt32)order.size();
+            order.push_back( l);
+            for ( UInt32 i = child_offsets[ l + 1]; i-- > child_offsets[ l]; )
+            {
+                stack.push_back( found_children[ i]);
+            }
+        }
+        for ( UInt32 x = 0; x < num; x++)
+        {
+            if ( inner[ x] != NONE)
+            {
+                inner[ x] = number[ inner[ x]];
+                own[ inner[ x]]++;
+            }
+        }
+
+        headers.resize( num_found);
+        parents.resize( num_found);
+        depths.resize( num_found);
+        body_offsets.resize( num_found);
+        body_ends.resize( num_found);
+        subloop_offsets.assign( num_found + 2, 0);
+        UInt32 body_pos = 0;
+        for ( UInt32 l = 0; l < num_found; l++)
+        {
+            UInt32 f = order[ l];
+
+            headers[ l] = t.rpo_nodes[ found_headers[ f]];
+            parents[ l] = found_parents[ f] == NONE ? NONE : number[ found_parents[ f]];
+            depths[ l] = parents[ l] == NONE ? 1 : depths[ parents[ l]] + 1;
+            body_offsets[ l] = body_pos;
+            body_pos += own[ l];
+            subloop_offsets[ l + 1] = child_offsets[ f + 1] - child_offsets[ f];
+        }
+        subloop_offsets[ num_found + 1] = child_offsets[ num_found + 1] - child_offsets[ num_found];
+        for ( UInt32 l = 0; l <= num_found; l++)
+        {
+            subloop_offsets[ l + 1] += subloop_offsets[ l];
+        }
+        subloops.resize( num_found + 1); // one more entry keeps &subloops[ 0] valid
+        pos.assign( subloop_offsets.begin(), subloop_offsets.end() - 1);
+        for ( UInt32 l = 0; l < num_found; l++)
+        {
+            subloops[ pos[ parents[ l] == NONE ? num_found : parents[ l]]++] = l;
+        }
+
+        // A loop owns the range of its own nodes followed by the ranges of its subloops
+        for ( UInt32 l = num_found; l-- > 0; )
+        {
+            body_ends[ l] = body_offsets[ l] + own[ l];
+            if ( subloop_offsets[ l + 1] > subloop_offsets[ l])
+                body_ends[ l] = body_ends[ subloops[ subloop_offsets[ l + 1] - 1]];
+        }
+        body.resize( body_pos + 1);
+        pos.assign( body_offsets.begin(), body_offsets.end());
+        for ( UInt32 l = 0; l < num_found; l++)
+        {
+            body[ pos[ l]++] = headers[ l];
+        }
+        for ( UInt32 x = 0; x < num; x++)
+        {
+            if ( inner[ x] != NONE && t.rpo_nodes[ x] != headers[ inner[ x]])
+                body[ pos[ inner[ x]]++] = t.rpo_nodes[ x];
+        }
+    }
+
+    template < class G>
+    UInt32 LoopForest< G>::outermost( UInt32 l)
+    {
+        UInt32 root = l;
+
+        while ( top[ root] != root)
+        {
+            root = top[ root];
+        }
+        while ( top[ l] != root)
+        {
+            UInt32 next = top[ l];
+
+            top[ l] = root;
+            l = next;
+        }
+        return root;
+    }
+
+    template < class G>
+    UInt32 LoopForest< G>::loop_of( const NodeT& n) const
+    {
+        UInt32 i = tree.number( n);
+
+        return i == NONE ? NONE : inner[ i];
+    }
+
+    template < class G>
+    UInt32 LoopForest< G>::node_depth( const NodeT& n) const
+    {
+        UInt32 l = loop_of( n);
+
+        return l == NONE ? 0 : depths[ l];
+    }
+
+    template < class G>
+    size_t LoopForest< G>::memory_size() const
+    {
+        return sizeof( *this)
+               + headers.capacity() * sizeof( NodeT *)
+               + ( parents.capacity() + depths.capacity() + body_offsets.capacity() + body_ends.capacity()) * sizeof( UInt32)
+               + body.capacity() * sizeof( NodeT *)
+               + ( subloop_offsets.capacity() + subloops.capacity() + inner.capacity()) * sizeof( UInt32);
+    }
+};
+
+#endif /* TASK_GRAPH_SCC_H */
@@ -0,0 +1,324 @@
+/**
+ * @file: task/graph_traversal.h
+ * Iterative traversals of a graph: breadth-first, depth-first, post-order,
+ * reverse post-order and topological order
+ */
+#pragma once
+
+#ifndef TASK_GRAPH_TRAVERSAL_H
+#define TASK_GRAPH_TRAVERSAL_H
+
+namespace Task
+{
+    //
+    // Breadth-first order of the nodes reachable from the start node
+    // @param G graph type
+    //
+    // Visited nodes are marked with a graph marker that the iterator holds until it is
+    // destroyed, so at most Graph::MAX_MARKERS traversals may run at the same time.
+    // The usage is
+    // @code
+    //  for ( BfsIterator< G> it( graph, start); !it.done(); ++it)
+    //  {
+    //      process( *it);
+    //  }
+    // @endcode
+    //
+    template < class G> class BfsIterator
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+
+        BfsIterator( G& g, NodeT& start); //< Constructor, the start node is the current one
+        ~BfsIterator();                   //< Destructor, frees the marker
+
+        bool done() const { return head == queue.size(); } // Check if all nodes are visited
+        NodeT& operator*() const { return *queue[ head]; }  // Get the current node
+        NodeT* operator->() const { return queue[ head]; }
+        BfsIterator& operator++();                          // Go to the next node
+    private:
+        // ---- Copy constructor and assignment turned off ----
+        BfsIterator( const BfsIterator& i);
+        BfsIterator& operator = ( const BfsIterator& i);
+
+        G& graph;
+        typename G::Marker marker;
+        std::vector< NodeT *> queue; // Discovered nodes, the ones before head are visited
+        size_t head;
+    };
+
+    //
+    // Base of the depth-first iterators, keeps the stack of nodes with their successor
+    // edges that remain to be tried. Nodes are marked when they are pushed
+    //
+    template < class G> class DfsStack
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+
+        bool done() const { return isNullP( current); }      // Check if all nodes are visited
+        NodeT& operator*() const { return *current; }         // Get the current node
+        NodeT* operator->() const { return current; }
+    protected:
+        DfsStack( G& g, NodeT& start); //< Constructor, pushes the start node
+        ~DfsStack();                   //< Destructor, frees the marker
+
+        NodeT *descend(); // Push the next unvisited successor of the top node, null if there is none
+
+        // Stack frame: the node and its next successor edge
+        struct Frame
+        {
+            NodeT *node;
+            typename G::Node::succ_iterator next;
+        };
+
+        G& graph;
+        typename G::Marker marker;
+        std::vector< Frame> stack;
+        NodeT *current;
+    private:
+        // ---- Copy constructor and assignment turned off ----
+        DfsStack( const DfsStack& s);
+        DfsStack& operator = ( const DfsStack& s);
+    };
+
+    //
+    // Depth-first pre-order of the nodes reachable from the start node, a node comes
+    // before all nodes discovered from it
+    //
+    template < class G> class DfsIterator: public DfsStack< G>
+    {
+    public:
+        DfsIterator( G& g, typename G::NodeType& start); //< Constructor, the start node is the current one
+        DfsIterator& operator++();                       // Go to the next node
+    };
+
+    //
+    // Depth-first post-order of the nodes reachable from the start node, a node comes
+    // after all nodes discovered from it
+    //
+    template < class G> class PostOrderIterator: public DfsStack< G>
+    {
+    public:
+        PostOrderIterator( G& g, typename G::NodeType& start); //< Constructor
+        PostOrderIterator& operator++();                       // Go to the next node
+    private:
+        void advance(); // Descend to the leftmost unfinished node and pop it
+    };
+
+    //
+    // Reverse post-order of the nodes reachable from the start node. In a graph without
+    // cycles it is a topological order, in a CFG it puts every node before its successors
+    // except along back edges. The order is computed by the constructor
+    //
+    template < class G> class RpoIterator
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+
+        RpoIterator( G& g, NodeT& start); //< Constructor, computes the order
+
+        bool done() const { return pos == 0; }                      // Check if all nodes are visited
+        NodeT& operator*() const { return *post_order[ pos - 1]; } // Get the current node
+        NodeT* operator->() const { return post_order[ pos - 1]; }
+        RpoIterator& operator++() { pos--; return *this; }          // Go to the next node
+
+        UInt32 index() const { return ( UInt32)( post_order.size() - pos); } // Number of the current node in the order
+        UInt32 size() const { return ( UInt32)post_order.size(); }         // Number of reachable nodes
+    private:
+        std::vector< NodeT *> post_order;
+        size_t pos;
+    };
+
+    //
+    // Topological order of all nodes of the graph by Kahn's algorithm: a node comes
+    // after all its predecessors. If the graph has cycles the nodes on them and the
+    // nodes reachable from them are not visited, has_cycle() tells that at the end
+    //
+    template < class G> class TopoIterator
+    {
+    public:
+        typedef typename G::NodeType NodeT;
+
+        explicit TopoIterator( G& g); //< Constructor, the first node without predecessors is the current one
+
+        bool done() const { return head == ready.size(); }  // Check if all nodes are visited
+        NodeT& operator*() const { return *ready[ head]; }  // Get the current node
+        NodeT* operator->() const { return ready[ head]; }
+        TopoIterator& operator++();                         // Go to the next node
+        bool has_cycle() const { return ready.size() < num_nodes; } // Valid when done
+    private:
+        std::vector< UInt32> num_preds_left; // Predecessors not yet visited, indexed by node id
+        std::vector< NodeT *> ready;         // Nodes with all predecessors visited, the ones before head are visited
+        size_t head;
+        UInt32 num_nodes;
+    };
+
+// ---- BfsIterator implementation ----
+
+    template < class G>
+    BfsIterator< G>::BfsIterator( G& g, NodeT& start):
+        graph( g),
+        marker( g.new_marker()),
+        head( 0)
+    {
+        start.mark( marker);
+        queue.push_back( &start);
+    }
+
+    template < class G>
+    BfsIterator< G>::~BfsIterator()
+    {
+        graph.free_marker( marker);
+    }
+
+    template < class G>
+    BfsIterator< G>& BfsIterator< G>::operator++()
+    {
+        NodeT *node = queue[ head];
+
+        for ( typename G::Node::succ_iterator e = node->succs_begin(), end = node->succs_end(); e != end; ++e)
+        {
+            if ( e->succ().mark( marker))
+                queue.push_back( &e->succ());
+        }
+        head++;
+        return *this;
+    }
+
+// ---- Depth-first iterators implementation ----
+
+    template < class G>
+    DfsStack< G>::DfsStack( G& g, NodeT& start):
+        graph( g),
+        marker( g.new_marker()),
+        current( &start)
+    {
+        Frame frame = { &start, start.succs_begin() };
+
+        start.mark( marker);
+        stack.push_back( frame);
+    }
+
+    template < class G>
+    DfsStack< G>::~DfsStack()
+    {
+        graph.free_marker( marker);
+    }
+
+    template < class G>
+    typename DfsStack< G>::NodeT* DfsStack< G>::descend()
+    {
+        Frame& top = stack.back();
+
+        for ( typename G::Node::succ_iterator end = top.node->succs_end(); top.next != end; )
+        {
+            NodeT& succ = top.next->succ();
+
+            ++top.next;
+            if ( succ.mark( marker))
+            {
+                Frame frame = { &succ, succ.succs_begin() };
+
+                stack.push_back( frame); // top is not used after this
+                return &succ;
+            }
+        }
+        return NULL;
+    }
+
+    template < class G>
+    DfsIterator< G>::DfsIterator( G& g, typename G::NodeType& start):
+        DfsStack< G>( g, start)
+    {
+    }
+
+    template < class G>
+    DfsIterator< G>& DfsIterator< G>::operator++()
+    {
+        this->current = NULL;
+        while ( !this->stack.empty())
+        {
+            this->current = this->descend();
+            if ( isNotNullP( this->current))
+                break;
+            this->stack.pop_back();
+        }
+        return *this;
+    }
+
+    template < class G>
+    PostOrderIterator< G>::PostOrderIterator( G& g, typename G::NodeType& start):
+        DfsStack< G>( g, start)
+    {
+        advance();
+    }
+
+    template < class G>
+    void PostOrderIterator< G>::advance()
+    {
+        while ( isNotNullP( this->descend()))
+        {
+        }
+        this->current = this->stack.back().node;
+        this->stack.pop_back();
+    }
+
+    template < class G>
+    PostOrderIterator< G>& PostOrderIterator< G>::operator++()
+    {
+        if ( this->stack.empty())
+        {
+            this->current = NULL;
+        } else
+        {
+            advance();
+        }
+        return *this;
+    }
+
+// ---- RpoIterator implementation ----
+
+    template < class G>
+    RpoIterator< G>::RpoIterator( G& g, NodeT& start)
+    {
+        for ( PostOrderIterator< G> it( g, start); !it.done(); ++it)
+        {
+            post_order.push_back( &*it);
+        }
+        pos = post_order.size();
+    }
+
+// ---- TopoIterator implementation ----
+
+    template < class G>
+    TopoIterator< G>::TopoIterator( G& g):
+        num_preds_left( g.node_uid_limit(), 0),
+        head( 0),
+        num_nodes( g.num_nodes())
+    {
+        ready.reserve( num_nodes);
+        for ( typename G::node_iterator n = g.nodes_begin(), end = g.nodes_end(); n != end; ++n)
+        {
+            num_preds_left[ n->uid()] = n->num_preds();
+            if ( n->num_preds() == 0)
+                ready.push_back( &*n);
+        }
+    }
+
+    template < class G>
+    TopoIterator< G>& TopoIterator< G>::operator++()
+    {
+        NodeT *node = ready[ head];
+
+        for ( typename G::Node::succ_iterator e = node->succs_begin(), end = node->succs_end(); e != end; ++e)
+        {
+            if ( --num_preds_left[ e->succ().uid()] == 0)
+                ready.push_back( &e->succ());
+        }
+        head++;
+        return *this;
+    }
+};
+
+#endif /* TASK_GRAPH_TRAVERSAL_H */
@@ -4,6 +4,11 @@
  */
 #include "../Utils/utils_iface.h"
 #include <unordered_set>
+#include <vector>
+#include <algorithm>
+#include <queue>
+#include <cstring>
+#include <type_traits>
 
 /* namespaces import */
 using namespace Utils;
@@ -18,26 +23,64 @@ using namespace Utils;
 #    define GRAPH_ASSERTD(cond) ASSERT_XD(cond, "Graph", "")
 #endif
 
+// Allocation policies for nodes and edges
+#include "graph_alloc.h"
+
 /**
  * Namespace for the programming task
  */
 namespace Task
 {
+    template < class G> class CsrView;
+
     //
     // Graph representation template
     // @param NodeT class representing nodes of graph, should be inherited from Graph::Node
     // @param EdgeT class representing edges of graph, should be inherited from Graph::Edge
+    // @param AllocPolicy policy that provides memory for the nodes and edges,
+    //        GraphPool (per-graph slabs, default) or GraphHeap (plain operator new)
+    //
+    // With GraphPool every graph owns the slabs its nodes and edges are cut from, so
+    // creating an object bumps a pointer and the destructor of the graph releases whole
+    // slabs after the objects are destroyed instead of freeing them one by one.
     //
-    template < class NodeT, class EdgeT> class Graph
+    template < class NodeT, class EdgeT, template < class U> class AllocPolicy = GraphPool> class Graph
     {
     public:
         typedef UInt32 UId; //< Unique id type for node and edge
         static const UId INVALID_UID = (UId) (-1);
+        typedef NodeT NodeType;
+        typedef EdgeT EdgeType;
+
+        // Lists every edge is linked in
+        enum EdgeListId
+        {
+            EDGE_LIST_PREDS, // Predecessor edges of the successor node
+            EDGE_LIST_SUCCS, // Successor edges of the predecessor node
+            EDGE_LISTS_NUM
+        };
 
         class Error: public std::exception
         {
         };
 
+        static const UInt32 MAX_MARKERS = 4; // Number of markers that may be used at the same time
+
+        //
+        // Marker of nodes. Every marker has a slot in the nodes and a generation number,
+        // a node is marked if its slot holds the generation of the marker. Clearing the
+        // marker takes a new generation, so it costs O(1) regardless of the graph size
+        //
+        class Marker
+        {
+        public:
+            Marker(): index( MAX_MARKERS), generation( 0){}
+        private:
+            friend class Graph;
+            UInt32 index;
+            UInt32 generation;
+        };
+
 
         //
         // Graph node representation
@@ -52,8 +95,8 @@ namespace Task
             pred_iterator preds_begin(); // Get iterator to the first predecessor edge
             pred_iterator preds_end();   // Get end iterator for the predecessors
 
-            pred_iterator succs_begin(); // Get iterator to the first successor edge
-            pred_iterator succs_end();   // Get end iterator for the successors
+            succ_iterator succs_begin(); // Get iterator to the first successor edge
+            succ_iterator succs_end();   // Get end iterator for the successors
 
             Graph& graph();  // Get the graph reference
             UId uid() const; // Get the node's unique id 
@@ -64,6 +107,10 @@ namespace Task
             UInt32 num_preds() const; // Get the number of predecessors
             UInt32 num_succs() const; // Get the number of successors
 
+            bool mark( const Marker& m);            // Mark node, returns false if it was already marked
+            void unmark( const Marker& m);          // Remove the mark from the node
+            bool is_marked( const Marker& m) const; // Check if the node is marked
+
         protected:
             Node( Graph& g); // Constructor of the node
             virtual ~Node();
@@ -72,15 +119,28 @@ namespace Task
             Node();
             Node(const Node &n);
             
+            friend class Graph;
+
             // ---- The internal implementation routines ----
 
             // ---- The data involved in the implementation ----
+            Graph *graph_p;
+            UId node_uid;
+            NodeT *next_node; // Neighbours in the list of the graph's nodes
+            NodeT *prev_node;
+            EdgeT *first_pred_edge; // Heads of the edge lists linked through the edges
+            EdgeT *first_succ_edge;
+            UInt32 pred_num;
+            UInt32 succ_num;
+            UInt32 marks[ MAX_MARKERS]; // Generations of the markers the node was marked with
         };
 
         // 
-        // Graph edge representation
+        // Graph edge representation. The edge is an item of the predecessor list of its
+        // successor node and of the successor list of its predecessor node, so adjacency
+        // needs no allocations and an edge is linked and unlinked in constant time
         //
-        class Edge
+        class Edge: public MListIface< Edge, EDGE_LISTS_NUM>
         {
         public:
             NodeT &pred(); // Get edge predecessor
@@ -95,9 +155,16 @@ namespace Task
         // ---- Default  and copy constructors turned off ---
             Edge();
             Edge( const Edge &e);
+
+            friend class Graph;
         // ---- The internal implementation routines ----
 
         // ---- The data involved in the implementation ----
+            NodeT *pred_p;
+            NodeT *succ_p;
+            UId edge_uid;
+            EdgeT *next_edge; // Neighbours in the list of the graph's edges
+            EdgeT *prev_edge;
     };
 
     public:
@@ -114,20 +181,152 @@ namespace Task
         UInt32 num_nodes() const; // Get the number of nodes
         UInt32 num_edges() const; // Get the number of edges
 
+        // Ids of removed nodes and edges are given to new ones, so the ids stay dense
+        UId node_uid_limit() const; // Get the number all node ids are less than
+        UId edge_uid_limit() const; // Get the number all edge ids are less than
+
         NodeT &create_node();                   // Create a new node and return reference to it
         EdgeT &create_edge( NodeT& pred, NodeT& succ); // Create a new edge between given nodes
     
         void remove( NodeT& node); // Remove and delete node
         void remove( EdgeT& edge); // Remove and delete edge
 
+        Marker new_marker();             // Get a marker that no node is marked with, throws Error
+                                         // if MAX_MARKERS markers are in use
+        void clear_marker( Marker& m);   // Unmark all nodes in O(1)
+        void free_marker( Marker& m);    // Return the marker to the graph
+
+        UInt64 version() const;               // Get the number of changes made to the graph
+        const CsrView< Graph>& freeze();      // Get the CSR snapshot of the graph, it is rebuilt
+                                              // if the graph has changed since the last call
+
+        Graph();          // Constructor of an empty graph
         virtual ~Graph(); // Destructor, deletes all nodes and edges
+
+        //
+        // Base of the side tables, lets the graph reset values of removed objects
+        //
+        class UIdMapBase
+        {
+        public:
+            virtual void reset( UId uid) = 0; // Set the value of the id to the default one
+        protected:
+            virtual ~UIdMapBase(){}
+        };
+
+        //
+        // Side table of values for the nodes or the edges of a graph
+        // @param Obj Node or Edge
+        // @param T value type
+        //
+        // Values are kept in an array indexed by the object id, which grows on access when
+        // the graph has got objects with bigger ids. When an object is removed its value is
+        // reset to the default one, so the object that reuses the id doesn't see it.
+        // Every value is wrapped in a slot, so NodeMap< bool> gets real bool references
+        // instead of the bit proxies of std::vector< bool>.
+        // The table must be destroyed before the graph
+        //
+        template < class Obj, class T> class UIdMap: public UIdMapBase
+        {
+        public:
+            explicit UIdMap( Graph& g, const T& def = T()); //< Constructor, registers the table in the graph
+            ~UIdMap();                                      //< Destructor
+
+            T& operator[]( const Obj& obj);             // Get value of the object, grows the table if needed
+            const T& operator[]( const Obj& obj) const; // Get value of the object, doesn't grow the table
+            void clear();                               // Set all values to the default one
+
+            virtual void reset( UId uid);
+        private:
+            // ---- Copy constructor and assignment turned off ----
+            UIdMap( const UIdMap& m);
+            UIdMap& operator = ( const UIdMap& m);
+
+            struct Slot
+            {
+                T value;
+                Slot( const T& v): value( v){}
+            };
+
+            Graph& graph;
+            std::vector< Slot> values;
+            T default_value;
+        };
+
+        template < class T> using NodeMap = UIdMap< Node, T>; // Values indexed by node ids
+        template < class T> using EdgeMap = UIdMap< Edge, T>; // Values indexed by edge ids
     private:
+        // ---- Copy constructor and assignment turned off ----
+        Graph( const Graph& g);
+        Graph& operator = ( const Graph& g);
+
         // ---- The internal implementation routines ----
+        void detachEdge( EdgeT& edge); // Remove edge from the edge lists of its nodes and the graph
+        static EdgeT *nextEdge( EdgeT *edge, EdgeListId list); // Next edge in the list
+        UId allocUId( std::vector< UId>& free_uids, UId& next_uid);  // Take a free id or a new one
+        UId uidLimit( const Node *) const { return next_node_uid; }  // Id limits selected by object type
+        UId uidLimit( const Edge *) const { return next_edge_uid; }
+        std::vector< UIdMapBase *>& maps( const Node *) { return node_maps; } // Tables selected by object type
+        std::vector< UIdMapBase *>& maps( const Edge *) { return edge_maps; }
+        void resetMaps( std::vector< UIdMapBase *>& map_list, UId uid); // Reset values of the removed object
 
         // ---- The data involved in the implementation ----
+        AllocPolicy< NodeT> node_alloc; // Memory of the nodes
+        AllocPolicy< EdgeT> edge_alloc; // Memory of the edges
+        NodeT *first_node;
+        NodeT *last_node;
+        EdgeT *first_edge;
+        EdgeT *last_edge;
+        UInt32 node_num;
+        UInt32 edge_num;
+        UId next_node_uid;
+        UId next_edge_uid;
+        std::vector< UId> free_node_uids;
+        std::vector< UId> free_edge_uids;
+        std::vector< UIdMapBase *> node_maps;
+        std::vector< UIdMapBase *> edge_maps;
+        UInt64 graph_version;
+        CsrView< Graph> *csr_view;
+        UInt32 marker_generations[ MAX_MARKERS]; // Last generation taken in each marker slot
+        bool marker_busy[ MAX_MARKERS];
     };
 
-    bool uTest( UnitTest *utest_p);
+    bool uTest( UnitTest *utest_p);     // Graph unit testing
+    bool uTestPerf( UnitTest *utest_p); // Graph build and teardown measurement
+    bool uTestCsrPerf( UnitTest *utest_p); // Traversal of the CSR snapshot against the graph
+    bool uTestTraversal( UnitTest *utest_p); // Traversal orders unit testing
+    bool uTestTraversalPerf( UnitTest *utest_p); // Traversal with markers against std::set
+    bool uTestDom( UnitTest *utest_p);       // Dominator tree unit testing
+    bool uTestDomPerf( UnitTest *utest_p);   // Dominator tree computation and queries measurement
+    bool uTestDf( UnitTest *utest_p);        // Dominance frontiers unit testing
+    bool uTestDfPerf( UnitTest *utest_p);    // Phi placement against the per-variable frontier union
+    bool uTestScc( UnitTest *utest_p);       // Strongly connected components and loops unit testing
+    bool uTestSccPerf( UnitTest *utest_p);   // Components and loops time and memory on large graphs
+    bool uTestDataflow( UnitTest *utest_p);  // Dataflow solver unit testing
+    bool uTestDataflowPerf( UnitTest *utest_p); // Dataflow solver on large graphs with wide facts
+    bool uTestColor( UnitTest *utest_p);     // Interference graph coloring unit testing
+    bool uTestColorPerf( UnitTest *utest_p); // Interference graph build and coloring on large graphs
 };
 
 #include "graph_impl.h"
+
+// Compressed sparse row snapshot of the graph
+#include "graph_csr.h"
+
+// Traversal orders of the graph
+#include "graph_traversal.h"
+
+// Dominator tree
+#include "graph_dom.h"
+
+// Dominance frontiers and phi placement
+#include "graph_df.h"
+
+// Strongly connected components and loop nesting forest
+#include "graph_scc.h"
+
+// Bit-vector dataflow analysis
+#include "graph_dataflow.h"
+
+// Interference graph coloring
+#include "graph_color.h"
@@ -1,4 +1,6 @@
 #include "iface.h"
+#include <set>
+#include <iterator>
 
 // Implementation of the task 2 unit testing
 namespace Task
@@ -90,7 +92,1057 @@ namespace Task
         }
 
         UTEST_CHECK(utest_p, sum == 33);
+
+        // Removal of a node takes its edges away
+        Edge& e4 = graph.create_edge( n3, n1);
+        UTEST_CHECK( utest_p, &e4 == &n1.first_pred() && 1 == n3.num_succs());
+        graph.remove( n2);
+        UTEST_CHECK( utest_p, 2 == graph.num_nodes() && 1 == graph.num_edges());
+        UTEST_CHECK( utest_p, n1.succs_begin() == n1.succs_end() && 0 == n3.num_preds());
+        UTEST_CHECK( utest_p, &e4 == &*graph.edges_begin());
+
+        // Edges are removed from the middle of the adjacency lists
+        Node& n4 = graph.create_node();
+        Edge& e5 = graph.create_edge( n1, n4);
+        Edge& e6 = graph.create_edge( n1, n4);
+        Edge& e7 = graph.create_edge( n1, n4);
+        UTEST_CHECK( utest_p, 3 == n1.num_succs() && 3 == n4.num_preds());
+        graph.remove( e6);
+        int num_succs = 0;
+        for ( auto s_iter = n1.succs_begin(), s_end = n1.succs_end(); s_iter != s_end; ++s_iter)
+        {
+            UTEST_CHECK( utest_p, &*s_iter == &e5 || &*s_iter == &e7);
+            num_succs++;
+        }
+        UTEST_CHECK( utest_p, 2 == num_succs && 2 == n1.num_succs() && 2 == n4.num_preds());
+        graph.remove( e7);
+        graph.remove( e5);
+        UTEST_CHECK( utest_p, n1.succs_begin() == n1.succs_end() && n4.preds_begin() == n4.preds_end());
+
+        // Ids of removed objects are reused and side tables forget their values
+        {
+            G::NodeMap< int> node_weights( graph, -1);
+            G::EdgeMap< int> edge_marks( graph);
+            UInt32 node_limit = graph.node_uid_limit();
+
+            node_weights[ n1] = 1;
+            node_weights[ n4] = 4;
+            edge_marks[ e4] = 7;
+            UTEST_CHECK( utest_p, node_weights[ n1] == 1 && node_weights[ n3] == -1);
+
+            G::UId n4_uid = n4.uid();
+            graph.remove( n4);
+            Node& n5 = graph.create_node();
+            UTEST_CHECK( utest_p, n5.uid() == n4_uid && graph.node_uid_limit() == node_limit);
+            UTEST_CHECK( utest_p, node_weights[ n5] == -1);
+
+            Node& n6 = graph.create_node(); // new id, the table grows on access
+            UTEST_CHECK( utest_p, n6.uid() == node_limit && graph.node_uid_limit() == node_limit + 1);
+            const G::NodeMap< int>& const_weights = node_weights;
+            UTEST_CHECK( utest_p, const_weights[ n6] == -1);
+            node_weights[ n6] = 6;
+            UTEST_CHECK( utest_p, node_weights[ n6] == 6 && node_weights[ n1] == 1);
+
+            G::UId e4_uid = e4.uid();
+            graph.remove( e4);
+            Edge& e8 = graph.create_edge( n5, n6);
+            UTEST_CHECK( utest_p, e8.uid() == e4_uid && edge_marks[ e8] == 0);
+
+            node_weights.clear();
+            UTEST_CHECK( utest_p, node_weights[ n1] == -1);
+
+            // Flags are plain bools that can be referenced
+            G::NodeMap< bool> marked( graph);
+            bool& n1_mark = marked[ n1];
+            n1_mark = true;
+            marked[ n6] = true;
+            const G::NodeMap< bool>& const_marked = marked;
+            UTEST_CHECK( utest_p, marked[ n1] && const_marked[ n6] && !marked[ n5] && !const_marked[ n3]);
+            graph.remove( n6);
+            Node& n7 = graph.create_node();
+            UTEST_CHECK( utest_p, !marked[ n7] && marked[ n1]);
+            marked.clear();
+            UTEST_CHECK( utest_p, !marked[ n1]);
+        }
+
+        // CSR snapshot has the same adjacency and is rebuilt after changes
+        {
+            const CsrView< G>& csr = graph.freeze();
+            bool same = csr.valid() && csr.num_edges() == graph.num_edges();
+
+            for ( auto n_iter = graph.nodes_begin(), n_end = graph.nodes_end(); n_iter != n_end; ++n_iter)
+            {
+                G::UId uid = n_iter->uid();
+                CsrView< G>::iterator succ = csr.succs_begin( uid);
+                CsrView< G>::iterator succ_edge = csr.succ_edges_begin( uid);
+
+                same = same && csr.node( uid) == &*n_iter && csr.num_succs( uid) == n_iter->num_succs()
+                       && csr.num_preds( uid) == n_iter->num_preds();
+                for ( auto e_iter = n_iter->succs_begin(); e_iter != n_iter->succs_end(); ++e_iter, ++succ, ++succ_edge)
+                {
+                    same = same && *succ == e_iter->succ().uid() && *succ_edge == e_iter->uid();
+                }
+                same = same && succ == csr.succs_end( uid);
+            }
+            UTEST_CHECK( utest_p, same);
+
+            Node& n7 = graph.create_node();
+            UTEST_CHECK( utest_p, !csr.valid());
+            graph.create_edge( n1, n7);
+            UTEST_CHECK( utest_p, &graph.freeze() == &csr && csr.valid());
+            UTEST_CHECK( utest_p, csr.num_preds( n7.uid()) == 1 && *csr.preds_begin( n7.uid()) == n1.uid());
+        }
+
+        // Nodes and edges left in the graph are released by its destructor
+        G *temp_graph = new G;
+        for ( int i = 0; i < 1000; i++)
+        {
+            Node& n = temp_graph->create_node();
+            temp_graph->create_edge( n, n);
+        }
+        UTEST_CHECK( utest_p, 1000 == temp_graph->num_edges());
+        delete temp_graph;
       
         return utest_p->result();
     }
-};
\ No newline at end of file
+
+    // Graph with a loop: 0 -> 1, 0 -> 2, 1 -> 3, 2 -> 3, 3 -> 4, 4 -> 1 and unreachable node 5
+    static void buildLoopGraph( G& graph, std::vector< Node *>& nodes)
+    {
+        for ( int i = 0; i < 6; i++)
+        {
+            nodes.push_back( &graph.create_node());
+        }
+        graph.create_edge( *nodes[ 0], *nodes[ 1]);
+        graph.create_edge( *nodes[ 0], *nodes[ 2]);
+        graph.create_edge( *nodes[ 1], *nodes[ 3]);
+        graph.create_edge( *nodes[ 2], *nodes[ 3]);
+        graph.create_edge( *nodes[ 3], *nodes[ 4]);
+        graph.create_edge( *nodes[ 4], *nodes[ 1]);
+    }
+
+    bool uTestTraversal( UnitTest *utest_p)
+    {
+        G graph;
+        std::vector< Node *> nodes;
+
+        buildLoopGraph( graph, nodes);
+
+        //--- Breadth-first: nodes come by the distance from the start
+        std::vector< int> bfs_pos( 6, -1);
+        int pos = 0;
+        for ( BfsIterator< G> it( graph, *nodes[ 0]); !it.done(); ++it)
+        {
+            bfs_pos[ it->uid()] = pos++;
+        }
+        UTEST_CHECK( utest_p, pos == 5 && bfs_pos[ 0] == 0 && bfs_pos[ 5] == -1);
+        UTEST_CHECK( utest_p, bfs_pos[ 1] <= 2 && bfs_pos[ 2] <= 2 && bfs_pos[ 3] == 3 && bfs_pos[ 4] == 4);
+
+        //--- Depth-first pre-order: every node but the start comes after some predecessor
+        std::vector< int> pre_pos( 6, -1);
+        pos = 0;
+        for ( DfsIterator< G> it( graph, *nodes[ 0]); !it.done(); ++it)
+        {
+            pre_pos[ it->uid()] = pos++;
+        }
+        bool parent_first = pre_pos[ 0] == 0;
+        for ( int i = 1; i < 5; i++)
+        {
+            bool has_parent = false;
+            for ( auto e = nodes[ i]->preds_begin(); e != nodes[ i]->preds_end(); ++e)
+            {
+                has_parent = has_parent || ( pre_pos[ e->pred().uid()] >= 0 && pre_pos[ e->pred().uid()] < pre_pos[ i]);
+            }
+            parent_first = parent_first && has_parent;
+        }
+        UTEST_CHECK( utest_p, pos == 5 && parent_first && pre_pos[ 5] == -1);
+
+        //--- Post-order and reverse post-order: successors first, except along the back edge 4 -> 1
+        std::vector< int> post_pos( 6, -1);
+        pos = 0;
+        for ( PostOrderIterator< G> it( graph, *nodes[ 0]); !it.done(); ++it)
+        {
+            post_pos[ it->uid()] = pos++;
+        }
+        UTEST_CHECK( utest_p, pos == 5 && post_pos[ 0] == 4 && post_pos[ 5] == -1);
+
+        // The cycle 1 -> 3 -> 4 -> 1 gives exactly one edge to a node that is not finished yet
+        UInt32 num_retreating = 0;
+        for ( auto e = graph.edges_begin(); e != graph.edges_end(); ++e)
+        {
+            if ( post_pos[ e->succ().uid()] > post_pos[ e->pred().uid()])
+                num_retreating++;
+        }
+        UTEST_CHECK( utest_p, num_retreating == 1);
+
+        bool reversed = true;
+        UInt32 num = 0;
+        RpoIterator< G> rpo( graph, *nodes[ 0]);
+        for ( ; !rpo.done(); ++rpo, num++)
+        {
+            reversed = reversed && rpo.index() == num && post_pos[ rpo->uid()] == ( int)( rpo.size() - 1 - num);
+        }
+        UTEST_CHECK( utest_p, reversed && num == 5);
+
+        //--- Topological order finds the cycle, then works on the graph without the back edge
+        TopoIterator< G> topo_cyclic( graph);
+        while ( !topo_cyclic.done())
+        {
+            ++topo_cyclic;
+        }
+        UTEST_CHECK( utest_p, topo_cyclic.has_cycle());
+
+        graph.remove( nodes[ 4]->first_succ());
+        std::vector< int> topo_pos( 6, -1);
+        pos = 0;
+        TopoIterator< G> topo( graph);
+        for ( ; !topo.done(); ++topo)
+        {
+            topo_pos[ topo->uid()] = pos++;
+        }
+        bool preds_first = pos == 6 && !topo.has_cycle();
+        for ( auto e = graph.edges_begin(); e != graph.edges_end(); ++e)
+        {
+            preds_first = preds_first && topo_pos[ e->pred().uid()] < topo_pos[ e->succ().uid()];
+        }
+        UTEST_CHECK( utest_p, preds_first);
+
+        //--- Markers are cleared in O(1) and there is a limited number of them
+        G::Marker m = graph.new_marker();
+        UTEST_CHECK( utest_p, nodes[ 1]->mark( m) && !nodes[ 1]->mark( m) && nodes[ 1]->is_marked( m));
+        graph.clear_marker( m);
+        UTEST_CHECK( utest_p, !nodes[ 1]->is_marked( m));
+        nodes[ 2]->mark( m);
+        nodes[ 2]->unmark( m);
+        UTEST_CHECK( utest_p, !nodes[ 2]->is_marked( m));
+
+        G::Marker m2 = graph.new_marker();
+        G::Marker m3 = graph.new_marker();
+        G::Marker m4 = graph.new_marker();
+        bool throws_correctly = false;
+        try
+        {
+            graph.new_marker();
+        } catch ( G::Error e)
+        {
+            throws_correctly = true;
+        }
+        UTEST_CHECK( utest_p, throws_correctly);
+        graph.free_marker( m4);
+        graph.free_marker( m3);
+        graph.free_marker( m2);
+        graph.free_marker( m);
+
+        //--- Long chains don't need deep native stack
+        G chain;
+        Node *prev = &chain.create_node();
+        Node& head = *prev;
+        for ( int i = 1; i < 100000; i++)
+        {
+            Node& n = chain.create_node();
+            chain.create_edge( *prev, n);
+            prev = &n;
+        }
+        UInt32 num_post = 0;
+        for ( PostOrderIterator< G> it( chain, head); !it.done(); ++it)
+        {
+            num_post++;
+        }
+        UTEST_CHECK( utest_p, num_post == 100000);
+
+        //--- Node sets keyed by node ids: a worklist search marks the same nodes as the iterator
+        Utils::BitVector reached( graph.node_uid_limit());
+        Utils::SparseSet worklist( graph.node_uid_limit());
+        reached.set( nodes[ 0]->uid());
+        worklist.insert( nodes[ 0]->uid());
+        while ( !worklist.empty())
+        {
+            Node *node = nodes[ worklist.pop()];
+
+            for ( auto e = node->succs_begin(); e != node->succs_end(); ++e)
+            {
+                if ( reached.testAndSet( e->succ().uid()))
+                    worklist.insert( e->succ().uid());
+            }
+        }
+        Utils::BitVector visited( graph.node_uid_limit());
+        for ( DfsIterator< G> it( graph, *nodes[ 0]); !it.done(); ++it)
+        {
+            visited.set( it->uid());
+        }
+        UTEST_CHECK( utest_p, reached == visited && reached.count() == 5 && !reached.test( nodes[ 5]->uid()));
+
+        return utest_p->result();
+    }
+
+    // Dominator sets by the textbook iteration over bit sets, to check the tree against
+    static std::vector< std::vector< bool> > naiveDominators( G& graph, std::vector< Node *>& nodes, Node& entry)
+    {
+        UInt32 num = graph.node_uid_limit();
+        std::vector< bool> reachable( num, false);
+
+        for ( BfsIterator< G> it( graph, entry); !it.done(); ++it)
+        {
+            reachable[ it->uid()] = true;
+        }
+
+        std::vector< std::vector< bool> > dom( num, reachable);
+        dom[ entry.uid()].assign( num, false);
+        dom[ entry.uid()][ entry.uid()] = true;
+
+        bool changed = true;
+        while ( changed)
+        {
+            changed = false;
+            for ( UInt32 i = 0; i < nodes.size(); i++)
+            {
+                Node *n = nodes[ i];
+
+                if ( n == &entry || !reachable[ n->uid()])
+                    continue;
+
+                std::vector< bool> new_dom = reachable;
+                for ( auto e = n->preds_begin(); e != n->preds_end(); ++e)
+                {
+                    if ( !reachable[ e->pred().uid()])
+                        continue;
+                    for ( UInt32 k = 0; k < num; k++)
+                    {
+                        new_dom[ k] = new_dom[ k] && dom[ e->pred().uid()][ k];
+                    }
+                }
+                new_dom[ n->uid()] = true;
+                if ( new_dom != dom[ n->uid()])
+                {
+                    dom[ n->uid()] = new_dom;
+                    changed = true;
+                }
+            }
+        }
+        return dom;
+    }
+
+    bool uTestDom( UnitTest *utest_p)
+    {
+        //--- Loop 1 -> {2, 3} -> 4 -> 1 with the exit 4 -> 5 and unreachable node 6
+        G graph;
+        std::vector< Node *> n;
+
+        for ( int i = 0; i < 7; i++)
+        {
+            n.push_back( &graph.create_node());
+        }
+        graph.create_edge( *n[ 0], *n[ 1]);
+        graph.create_edge( *n[ 1], *n[ 2]);
+        graph.create_edge( *n[ 1], *n[ 3]);
+        graph.create_edge( *n[ 2], *n[ 4]);
+        graph.create_edge( *n[ 3], *n[ 4]);
+        graph.create_edge( *n[ 4], *n[ 1]);
+        graph.create_edge( *n[ 4], *n[ 5]);
+        graph.create_edge( *n[ 6], *n[ 4]);
+
+        DomTree< G> dom( graph, *n[ 0]);
+
+        UTEST_CHECK( utest_p, &dom.entry() == n[ 0] && dom.valid() && dom.num_reachable_nodes() == 6);
+        UTEST_CHECK( utest_p, isNullP( dom.idom( *n[ 0])) && isNullP( dom.idom( *n[ 6])));
+        UTEST_CHECK( utest_p, dom.idom( *n[ 1]) == n[ 0] && dom.idom( *n[ 2]) == n[ 1] && dom.idom( *n[ 3]) == n[ 1]);
+        UTEST_CHECK( utest_p, dom.idom( *n[ 4]) == n[ 1] && dom.idom( *n[ 5]) == n[ 4]);
+        UTEST_CHECK( utest_p, dom.dominates( *n[ 0], *n[ 5]) && dom.dominates( *n[ 1], *n[ 4]) && dom.dominates( *n[ 3], *n[ 3]));
+        UTEST_CHECK( utest_p, !dom.dominates( *n[ 2], *n[ 4]) && !dom.dominates( *n[ 5], *n[ 4]));
+        UTEST_CHECK( utest_p, !dom.dominates( *n[ 0], *n[ 6]) && !dom.dominates( *n[ 6], *n[ 6]) && !dom.is_reachable( *n[ 6]));
+        UTEST_CHECK( utest_p, dom.level( *n[ 0]) == 0 && dom.level( *n[ 4]) == 2 && dom.level( *n[ 5]) == 3);
+
+        std::vector< Node *> kids( dom.children_begin( *n[ 1]), dom.children_end( *n[ 1]));
+        std::sort( kids.begin(), kids.end());
+        std::vector< Node *> expected_kids;
+        expected_kids.push_back( n[ 2]);
+        expected_kids.push_back( n[ 3]);
+        expected_kids.push_back( n[ 4]);
+        std::sort( expected_kids.begin(), expected_kids.end());
+        UTEST_CHECK( utest_p, kids == expected_kids && dom.children_begin( *n[ 5]) == dom.children_end( *n[ 5]));
+
+        // Pre-order of the tree puts dominators first
+        bool dominators_first = dom.preorder_end() - dom.preorder_begin() == 6 && *dom.preorder_begin() == n[ 0];
+        Utils::BitVector seen( graph.node_uid_limit());
+        for ( DomTree< G>::iterator it = dom.preorder_begin(); it != dom.preorder_end(); ++it)
+        {
+            Node *parent = dom.idom( **it);
+            dominators_first = dominators_first && ( isNullP( parent) || seen.test( parent->uid()));
+            seen.set( ( *it)->uid());
+        }
+        UTEST_CHECK( utest_p, dominators_first);
+
+        graph.create_edge( *n[ 0], *n[ 4]);
+        UTEST_CHECK( utest_p, !dom.valid());
+
+        //--- Random graphs against the dominator sets
+        UInt32 state = 12345;
+        bool same = true;
+        for ( int round = 0; round < 20; round++)
+        {
+            G rnd;
+            std::vector< Node *> rn;
+
+            for ( int i = 0; i < 60; i++)
+            {
+                rn.push_back( &rnd.create_node());
+            }
+            for ( int i = 0; i < 90; i++)
+            {
+                state = state * 1103515245 + 12345;
+                UInt32 p = ( state >> 8) % 60;
+                state = state * 1103515245 + 12345;
+                UInt32 s = ( state >> 8) % 60;
+                rnd.create_edge( *rn[ p], *rn[ s]);
+            }
+
+            DomTree< G> rdom( rnd, *rn[ 0]);
+            std::vector< std::vector< bool> > sets = naiveDominators( rnd, rn, *rn[ 0]);
+
+            for ( int a = 0; a < 60; a++)
+            {
+                for ( int b = 0; b < 60; b++)
+                {
+                    same = same && rdom.dominates( *rn[ a], *rn[ b]) == ( rdom.is_reachable( *rn[ b]) && sets[ rn[ b]->uid()][ rn[ a]->uid()]);
+                }
+            }
+        }
+        UTEST_CHECK( utest_p, same);
+
+        return utest_p->result();
+    }
+
+    // Iterated frontier by the worklist over the frontiers of single nodes
+    static std::set< Node *> naiveIdf( DomFrontier< G>& df, const std::vector< Node *>& defs)
+    {
+        std::set< Node *> phis;
+        std::set< Node *> defined( defs.begin(), defs.end());
+        std::vector< Node *> worklist( defs.begin(), defs.end());
+
+        while ( !worklist.empty())
+        {
+            Node *x = worklist.back();
+            worklist.pop_back();
+            for ( DomFrontier< G>::iterator it = df.frontier_begin( *x); it != df.frontier_end( *x); ++it)
+            {
+                if ( phis.insert( *it).second && defined.find( *it) == defined.end())
+                    worklist.push_back( *it);
+            }
+        }
+        return phis;
+    }
+
+    bool uTestDf( UnitTest *utest_p)
+    {
+        //--- Loop 1 -> {2, 3} -> 4 -> 1 with the exit 4 -> 5
+        G graph;
+        std::vector< Node *> n;
+
+        for ( int i = 0; i < 6; i++)
+        {
+            n.push_back( &graph.create_node());
+        }
+        graph.create_edge( *n[ 0], *n[ 1]);
+        graph.create_edge( *n[ 1], *n[ 2]);
+        graph.create_edge( *n[ 1], *n[ 3]);
+        graph.create_edge( *n[ 2], *n[ 4]);
+        graph.create_edge( *n[ 3], *n[ 4]);
+        graph.create_edge( *n[ 4], *n[ 1]);
+        graph.create_edge( *n[ 4], *n[ 5]);
+
+        DomTree< G> dom( graph, *n[ 0]);
+        DomFrontier< G> df( dom);
+
+        UTEST_CHECK( utest_p, df.frontier_begin( *n[ 0]) == df.frontier_end( *n[ 0]));
+        UTEST_CHECK( utest_p, df.frontier_end( *n[ 2]) - df.frontier_begin( *n[ 2]) == 1 && *df.frontier_begin( *n[ 2]) == n[ 4]);
+        UTEST_CHECK( utest_p, df.frontier_end( *n[ 4]) - df.frontier_begin( *n[ 4]) == 1 && *df.frontier_begin( *n[ 4]) == n[ 1]);
+        UTEST_CHECK( utest_p, df.frontier_end( *n[ 1]) - df.frontier_begin( *n[ 1]) == 1 && *df.frontier_begin( *n[ 1]) == n[ 1]);
+        UTEST_CHECK( utest_p, df.frontier_begin( *n[ 5]) == df.frontier_end( *n[ 5]));
+
+        // A variable defined in the entry and in one arm of the loop needs phis in both joins
+        std::vector< std::vector< Node *> > defs( 3);
+        std::vector< std::vector< Node *> > phis;
+        defs[ 0].push_back( n[ 0]);
+        defs[ 0].push_back( n[ 2]);
+        defs[ 1].push_back( n[ 5]);
+        df.place_phis( defs, phis);
+        std::set< Node *> phis0( phis[ 0].begin(), phis[ 0].end());
+        std::set< Node *> expected;
+        expected.insert( n[ 1]);
+        expected.insert( n[ 4]);
+        UTEST_CHECK( utest_p, phis.size() == 3 && phis0 == expected && phis[ 0].size() == 2);
+        UTEST_CHECK( utest_p, phis[ 1].empty() && phis[ 2].empty());
+
+        //--- Random graphs against the frontier definition and the worklist
+        UInt32 state = 54321;
+        bool same_df = true;
+        bool same_idf = true;
+        for ( int round = 0; round < 20; round++)
+        {
+            G rnd;
+            std::vector< Node *> rn;
+
+            for ( int i = 0; i < 60; i++)
+            {
+                rn.push_back( &rnd.create_node());
+            }
+            for ( int i = 0; i < 90; i++)
+            {
+                state = state * 1103515245 + 12345;
+                UInt32 p = ( state >> 8) % 60;
+                state = state * 1103515245 + 12345;
+                UInt32 s = ( state >> 8) % 60;
+                rnd.create_edge( *rn[ p], *rn[ s]);
+            }
+
+            DomTree< G> rdom( rnd, *rn[ 0]);
+            DomFrontier< G> rdf( rdom);
+
+            // z is in the frontier of x iff x dominates a predecessor of z but not z itself unless x == z
+            for ( int x = 0; x < 60; x++)
+            {
+                std::set< Node *> frontier;
+                for ( int z = 0; z < 60; z++)
+                {
+                    bool strictly = x != z && rdom.dominates( *rn[ x], *rn[ z]);
+                    for ( auto e = rn[ z]->preds_begin(); e != rn[ z]->preds_end(); ++e)
+                    {
+                        if ( !strictly && rdom.dominates( *rn[ x], e->pred()))
+                            frontier.insert( rn[ z]);
+                    }
+                }
+                std::set< Node *> computed( rdf.frontier_begin( *rn[ x]), rdf.frontier_end( *rn[ x]));
+                same_df = same_df && computed == frontier
+                          && ( UInt32)( rdf.frontier_end( *rn[ x]) - rdf.frontier_begin( *rn[ x])) == frontier.size();
+            }
+
+            std::vector< std::vector< Node *> > rdefs( 30);
+            std::vector< std::vector< Node *> > rphis;
+            for ( int v = 0; v < 30; v++)
+            {
+                for ( int k = 0; k <= v % 4; k++)
+                {
+                    state = state * 1103515245 + 12345;
+                    rdefs[ v].push_back( rn[ ( state >> 8) % 60]);
+                }
+            }
+            rdf.place_phis( rdefs, rphis);
+            for ( int v = 0; v < 30; v++)
+            {
+                std::set< Node *> computed( rphis[ v].begin(), rphis[ v].end());
+                same_idf = same_idf && computed.size() == rphis[ v].size() && computed == naiveIdf( rdf, rdefs[ v]);
+            }
+        }
+        UTEST_CHECK( utest_p, same_df);
+        UTEST_CHECK( utest_p, same_idf);
+
+        return utest_p->result();
+    }
+
+    bool uTestScc( UnitTest *utest_p)
+    {
+        //--- Components {0}, {1, 2}, {3, 4}, {5} with a self loop and isolated {6}
+        G graph;
+        std::vector< Node *> n;
+
+        for ( int i = 0; i < 7; i++)
+        {
+            n.push_back( &graph.create_node());
+        }
+        graph.create_edge( *n[ 0], *n[ 1]);
+        graph.create_edge( *n[ 0], *n[ 2]);
+        graph.create_edge( *n[ 1], *n[ 2]);
+        graph.create_edge( *n[ 2], *n[ 1]);
+        graph.create_edge( *n[ 2], *n[ 3]);
+        graph.create_edge( *n[ 3], *n[ 4]);
+        graph.create_edge( *n[ 4], *n[ 3]);
+        graph.create_edge( *n[ 4], *n[ 5]);
+        graph.create_edge( *n[ 5], *n[ 5]);
+
+        SccInfo< G> scc( graph);
+
+        UTEST_CHECK( utest_p, scc.num_components() == 5);
+        UTEST_CHECK( utest_p, scc.component( *n[ 1]) == scc.component( *n[ 2]) && scc.component( *n[ 3]) == scc.component( *n[ 4]));
+        UTEST_CHECK( utest_p, scc.component( *n[ 0]) < scc.component( *n[ 1]) && scc.component( *n[ 2]) < scc.component( *n[ 3])
+                              && scc.component( *n[ 4]) < scc.component( *n[ 5]));
+        UTEST_CHECK( utest_p, !scc.is_cyclic( scc.component( *n[ 0])) && scc.is_cyclic( scc.component( *n[ 1]))
+                              && scc.is_cyclic( scc.component( *n[ 5])) && !scc.is_cyclic( scc.component( *n[ 6])));
+
+        UInt32 c12 = scc.component( *n[ 1]);
+        std::set< Node *> members( scc.members_begin( c12), scc.members_end( c12));
+        UTEST_CHECK( utest_p, scc.num_members( c12) == 2 && members.count( n[ 1]) == 1 && members.count( n[ 2]) == 1);
+
+        // Both edges 0 -> 1 and 0 -> 2 give one edge of the condensation
+        UInt32 c0 = scc.component( *n[ 0]);
+        UTEST_CHECK( utest_p, scc.succs_end( c0) - scc.succs_begin( c0) == 1 && *scc.succs_begin( c0) == c12);
+        UInt32 c6 = scc.component( *n[ 6]);
+        UTEST_CHECK( utest_p, scc.succs_begin( c6) == scc.succs_end( c6));
+
+        //--- Random graphs against mutual reachability
+        UInt32 state = 777;
+        bool same = true;
+        bool topological = true;
+        for ( int round = 0; round < 20; round++)
+        {
+            G rnd;
+            std::vector< Node *> rn;
+
+            for ( int i = 0; i < 40; i++)
+            {
+                rn.push_back( &rnd.create_node());
+            }
+            for ( int i = 0; i < 50; i++)
+            {
+                state = state * 1103515245 + 12345;
+                UInt32 p = ( state >> 8) % 40;
+                state = state * 1103515245 + 12345;
+                UInt32 s = ( state >> 8) % 40;
+                rnd.create_edge( *rn[ p], *rn[ s]);
+            }
+
+            SccInfo< G> rscc( rnd);
+            std::vector< std::vector< bool> > reach( 40, std::vector< bool>( 40, false));
+            for ( int a = 0; a < 40; a++)
+            {
+                for ( BfsIterator< G> it( rnd, *rn[ a]); !it.done(); ++it)
+                {
+                    reach[ a][ it->uid()] = true;
+                }
+            }
+            for ( int a = 0; a < 40; a++)
+            {
+                for ( int b = 0; b < 40; b++)
+                {
+                    bool mutual = reach[ a][ rn[ b]->uid()] && reach[ b][ rn[ a]->uid()];
+                    same = same && mutual == ( rscc.component( *rn[ a]) == rscc.component( *rn[ b]));
+                }
+            }
+            for ( auto e = rnd.edges_begin(); e != rnd.edges_end(); ++e)
+            {
+                topological = topological && rscc.component( e->pred()) <= rscc.component( e->succ());
+            }
+        }
+        UTEST_CHECK( utest_p, same && topological);
+
+        //--- Long cycle needs no deep native stack
+        G chain;
+        Node *prev = &chain.create_node();
+        Node& head = *prev;
+        for ( int i = 1; i < 100000; i++)
+        {
+            Node& node = chain.create_node();
+            chain.create_edge( *prev, node);
+            prev = &node;
+        }
+        chain.create_edge( *prev, head);
+        SccInfo< G> chain_scc( chain);
+        UTEST_CHECK( utest_p, chain_scc.num_components() == 1 && chain_scc.num_members( 0) == 100000);
+
+        //--- Loop 1 with nested loop 2, self loop 6 and irreducible cycle 8 <-> 9
+        G cfg;
+        std::vector< Node *> b;
+
+        for ( int i = 0; i < 10; i++)
+        {
+            b.push_back( &cfg.create_node());
+        }
+        cfg.create_edge( *b[ 0], *b[ 1]);
+        cfg.create_edge( *b[ 1], *b[ 2]);
+        cfg.create_edge( *b[ 2], *b[ 3]);
+        cfg.create_edge( *b[ 3], *b[ 2]);
+        cfg.create_edge( *b[ 3], *b[ 4]);
+        cfg.create_edge( *b[ 4], *b[ 1]);
+        cfg.create_edge( *b[ 4], *b[ 5]);
+        cfg.create_edge( *b[ 5], *b[ 6]);
+        cfg.create_edge( *b[ 6], *b[ 6]);
+        cfg.create_edge( *b[ 6], *b[ 7]);
+        cfg.create_edge( *b[ 7], *b[ 8]);
+        cfg.create_edge( *b[ 7], *b[ 9]);
+        cfg.create_edge( *b[ 8], *b[ 9]);
+        cfg.create_edge( *b[ 9], *b[ 8]);
+
+        DomTree< G> dom( cfg, *b[ 0]);
+        LoopForest< G> loops( dom);
+
+        UTEST_CHECK( utest_p, loops.num_loops() == 3 && loops.top_loops_end() - loops.top_loops_begin() == 2);
+
+        UInt32 outer = loops.loop_of( *b[ 1]);
+        UInt32 inner = loops.loop_of( *b[ 3]);
+        UInt32 self = loops.loop_of( *b[ 6]);
+        UTEST_CHECK( utest_p, &loops.header( outer) == b[ 1] && &loops.header( inner) == b[ 2] && &loops.header( self) == b[ 6]);
+        UTEST_CHECK( utest_p, loops.parent( inner) == outer && loops.parent( outer) == LoopForest< G>::NONE
+                              && loops.parent( self) == LoopForest< G>::NONE);
+        UTEST_CHECK( utest_p, loops.depth( outer) == 1 && loops.depth( inner) == 2 && loops.depth( self) == 1);
+        UTEST_CHECK( utest_p, loops.node_depth( *b[ 3]) == 2 && loops.node_depth( *b[ 4]) == 1 && loops.node_depth( *b[ 0]) == 0);
+        UTEST_CHECK( utest_p, loops.loop_of( *b[ 8]) == LoopForest< G>::NONE && loops.loop_of( *b[ 9]) == LoopForest< G>::NONE);
+        UTEST_CHECK( utest_p, loops.subloops_end( outer) - loops.subloops_begin( outer) == 1 && *loops.subloops_begin( outer) == inner);
+
+        std::set< Node *> outer_body( loops.body_begin( outer), loops.body_end( outer));
+        std::set< Node *> inner_body( loops.body_begin( inner), loops.body_end( inner));
+        UTEST_CHECK( utest_p, *loops.body_begin( outer) == b[ 1] && loops.body_size( outer) == 4 && outer_body.size() == 4
+                              && outer_body.count( b[ 4]) == 1 && outer_body.count( b[ 3]) == 1);
+        UTEST_CHECK( utest_p, *loops.body_begin( inner) == b[ 2] && loops.body_size( inner) == 2 && inner_body.count( b[ 3]) == 1);
+        UTEST_CHECK( utest_p, loops.body_size( self) == 1 && *loops.body_begin( self) == b[ 6]);
+
+        SccInfo< G> cfg_scc( cfg);
+        UTEST_CHECK( utest_p, cfg_scc.component( *b[ 8]) == cfg_scc.component( *b[ 9]) && cfg_scc.num_components() == 6);
+
+        return utest_p->result();
+    }
+
+    // Gen and kill sets given by tables indexed by node id
+    struct TableProblem: public DataflowProblem< G>
+    {
+        std::vector< std::vector< UInt32> > gen_facts;
+        std::vector< std::vector< UInt32> > kill_facts;
+
+        TableProblem( DataflowDirection dir, DataflowMeet m, UInt32 facts, UInt32 num_ids):
+            DataflowProblem< G>( dir, m, facts), gen_facts( num_ids), kill_facts( num_ids){}
+
+        void init( Node& n, DataflowBits gen, DataflowBits kill)
+        {
+            for ( UInt32 i = 0; i < gen_facts[ n.uid()].size(); i++)
+            {
+                gen.set( gen_facts[ n.uid()][ i]);
+            }
+            for ( UInt32 i = 0; i < kill_facts[ n.uid()].size(); i++)
+            {
+                kill.set( kill_facts[ n.uid()][ i]);
+            }
+        }
+    };
+
+    // Same problem with its own transfer, which counts the calls to check that the solver takes it
+    struct CountingProblem: public TableProblem
+    {
+        UInt32 num_transfers;
+
+        explicit CountingProblem( const TableProblem& p): TableProblem( p), num_transfers( 0){}
+
+        bool transfer( Node& n, const Word *from, Word *to, const Word *gen, const Word *kill, UInt32 num_words)
+        {
+            num_transfers++;
+            return DataflowProblem< G>::transfer( n, from, to, gen, kill, num_words);
+        }
+    };
+
+    // Fixed point of the same equations by sweeps over all nodes with std::set
+    static std::vector< std::set< UInt32> > naiveDataflow( G& graph, Node& entry, TableProblem& p, bool want_in)
+    {
+        UInt32 num = graph.node_uid_limit();
+        std::vector< bool> reachable( num, false);
+        std::set< UInt32> all;
+
+        for ( BfsIterator< G> it( graph, entry); !it.done(); ++it)
+        {
+            reachable[ it->uid()] = true;
+        }
+        for ( UInt32 f = 0; f < p.num_facts(); f++)
+        {
+            all.insert( f);
+        }
+
+        bool forward = p.direction() == DATAFLOW_FORWARD;
+        bool is_union = p.meet() == DATAFLOW_UNION;
+        std::vector< std::set< UInt32> > from( num);
+        std::vector< std::set< UInt32> > to( num, is_union ? std::set< UInt32>() : all);
+        bool changed = true;
+
+        while ( changed)
+        {
+            changed = false;
+            for ( auto n = graph.nodes_begin(); n != graph.nodes_end(); ++n)
+            {
+                if ( !reachable[ n->uid()])
+                    continue;
+
+                std::set< UInt32> meet;
+                bool first = true;
+                if ( forward)
+                {
+                    for ( auto e = n->preds_begin(); e != n->preds_end(); ++e)
+                    {
+                        if ( !reachable[ e->pred().uid()])
+                            continue;
+                        std::set< UInt32>& s = to[ e->pred().uid()];
+                        if ( first || is_union)
+                        {
+                            meet.insert( s.begin(), s.end());
+                        } else
+                        {
+                            std::set< UInt32> both;
+                            std::set_intersection( meet.begin(), meet.end(), s.begin(), s.end(), std::inserter( both, both.begin()));
+                            meet.swap( both);
+                        }
+                        first = false;
+                    }
+                    if ( &*n == &entry && !is_union)
+                        meet.clear();
+                } else
+                {
+                    for ( auto e = n->succs_begin(); e != n->succs_end(); ++e)
+                    {
+                        std::set< UInt32>& s = to[ e->succ().uid()];
+                        if ( first || is_union)
+                        {
+                            meet.insert( s.begin(), s.end());
+                        } else
+                        {
+                            std::set< UInt32> both;
+                            std::set_intersection( meet.begin(), meet.end(), s.begin(), s.end(), std::inserter( both, both.begin()));
+                            meet.swap( both);
+                        }
+                        first = false;
+                    }
+                }
+                from[ n->uid()] = meet;
+
+                std::set< UInt32> result( p.gen_facts[ n->uid()].begin(), p.gen_facts[ n->uid()].end());
+                for ( std::set< UInt32>::iterator f = meet.begin(); f != meet.end(); ++f)
+                {
+                    if ( std::find( p.kill_facts[ n->uid()].begin(), p.kill_facts[ n->uid()].end(), *f) == p.kill_facts[ n->uid()].end())
+                        result.insert( *f);
+                }
+                if ( result != to[ n->uid()])
+                {
+                    to[ n->uid()] = result;
+                    changed = true;
+                }
+            }
+        }
+        return ( want_in == forward) ? from : to;
+    }
+
+    bool uTestDataflow( UnitTest *utest_p)
+    {
+        //--- Liveness of x (fact 0) and y (fact 1): 0 defines x, loop 1 <-> 2 uses x in 1 and defines y in 2, 3 uses y
+        G graph;
+        std::vector< Node *> n;
+
+        for ( int i = 0; i < 4; i++)
+        {
+            n.push_back( &graph.create_node());
+        }
+        graph.create_edge( *n[ 0], *n[ 1]);
+        graph.create_edge( *n[ 1], *n[ 2]);
+        graph.create_edge( *n[ 2], *n[ 1]);
+        graph.create_edge( *n[ 1], *n[ 3]);
+
+        TableProblem live( DATAFLOW_BACKWARD, DATAFLOW_UNION, 2, graph.node_uid_limit());
+        live.kill_facts[ n[ 0]->uid()].push_back( 0);
+        live.gen_facts[ n[ 1]->uid()].push_back( 0);
+        live.kill_facts[ n[ 2]->uid()].push_back( 1);
+        live.gen_facts[ n[ 3]->uid()].push_back( 1);
+
+        CountingProblem counted_live( live);
+        DataflowSolver< G, CountingProblem> live_solver( graph, *n[ 0], counted_live);
+        live_solver.solve();
+
+        UTEST_CHECK( utest_p, live_solver.in( *n[ 3], 1) && !live_solver.in( *n[ 3], 0) && !live_solver.out( *n[ 3], 1));
+        UTEST_CHECK( utest_p, live_solver.in( *n[ 1], 0) && live_solver.in( *n[ 1], 1));
+        UTEST_CHECK( utest_p, live_solver.in( *n[ 2], 0) && !live_solver.in( *n[ 2], 1) && live_solver.out( *n[ 2], 1));
+        UTEST_CHECK( utest_p, !live_solver.in( *n[ 0], 0) && live_solver.in( *n[ 0], 1) && live_solver.out( *n[ 0], 0));
+        UTEST_CHECK( utest_p, counted_live.num_transfers == live_solver.num_evaluations() && live_solver.num_sweeps() == 2);
+
+        //--- Random graphs with every direction and meet against the naive sweeps
+        UInt32 state = 2024;
+        bool same = true;
+        for ( int round = 0; round < 40; round++)
+        {
+            G rnd;
+            std::vector< Node *> rn;
+
+            for ( int i = 0; i < 40; i++)
+            {
+                rn.push_back( &rnd.create_node());
+            }
+            for ( int i = 0; i < 60; i++)
+            {
+                state = state * 1103515245 + 12345;
+                UInt32 p = ( state >> 8) % 40;
+                state = state * 1103515245 + 12345;
+                UInt32 s = ( state >> 8) % 40;
+                rnd.create_edge( *rn[ p], *rn[ s]);
+            }
+
+            TableProblem p( round % 2 ? DATAFLOW_FORWARD : DATAFLOW_BACKWARD,
+                            ( round / 2) % 2 ? DATAFLOW_UNION : DATAFLOW_INTERSECTION, 70, rnd.node_uid_limit());
+            for ( int i = 0; i < 40; i++)
+            {
+                for ( int k = 0; k < 3; k++)
+                {
+                    state = state * 1103515245 + 12345;
+                    p.gen_facts[ rn[ i]->uid()].push_back( ( state >> 8) % 70);
+                    state = state * 1103515245 + 12345;
+                    p.kill_facts[ rn[ i]->uid()].push_back( ( state >> 8) % 70);
+                }
+            }
+
+            // Sparse gen and kill with the default transfer and dense ones with the own transfer
+            CountingProblem counted( p);
+            DataflowSolver< G, TableProblem> solver( rnd, *rn[ 0], p);
+            DataflowSolver< G, CountingProblem> dense_solver( rnd, *rn[ 0], counted);
+            solver.solve();
+            dense_solver.solve();
+            std::vector< std::set< UInt32> > ins = naiveDataflow( rnd, *rn[ 0], p, true);
+            std::vector< std::set< UInt32> > outs = naiveDataflow( rnd, *rn[ 0], p, false);
+
+            for ( int i = 0; i < 40; i++)
+            {
+                if ( !solver.is_reachable( *rn[ i]))
+                    continue;
+                for ( UInt32 f = 0; f < 70; f++)
+                {
+                    same = same && solver.in( *rn[ i], f) == ( ins[ rn[ i]->uid()].count( f) == 1)
+                                && solver.out( *rn[ i], f) == ( outs[ rn[ i]->uid()].count( f) == 1)
+                                && dense_solver.in( *rn[ i], f) == solver.in( *rn[ i], f)
+                                && dense_solver.out( *rn[ i], f) == solver.out( *rn[ i], f);
+                }
+            }
+        }
+        UTEST_CHECK( utest_p, same);
+
+        return utest_p->result();
+    }
+
+    // Check that neighbours have different colors and a spilled node sees all colors around
+    static bool isProperColoring( G& graph, const GraphColoring< G>& coloring)
+    {
+        UInt32 k = coloring.num_colors();
+        std::vector< std::set< UInt32> > around( graph.node_uid_limit());
+        bool proper = true;
+
+        for ( auto e = graph.edges_begin(); e != graph.edges_end(); ++e)
+        {
+            UInt32 p = coloring.color_of( e->pred());
+            UInt32 s = coloring.color_of( e->succ());
+
+            if ( &e->pred() == &e->succ())
+                continue;
+            proper = proper && ( p == GraphColoring< G>::NO_COLOR || p != s);
+            around[ e->pred().uid()].insert( s);
+            around[ e->succ().uid()].insert( p);
+        }
+        UInt32 num_spilled = 0;
+        for ( auto n = graph.nodes_begin(); n != graph.nodes_end(); ++n)
+        {
+            around[ n->uid()].erase( GraphColoring< G>::NO_COLOR);
+            if ( coloring.is_spilled( *n))
+            {
+                num_spilled++;
+                proper = proper && around[ n->uid()].size() == k;
+            } else
+            {
+                proper = proper && coloring.color_of( *n) < k;
+            }
+        }
+        return proper && num_spilled == coloring.num_spilled();
+    }
+
+    bool uTestColor( UnitTest *utest_p)
+    {
+        //--- Cycle of 4 nodes: every node has 2 neighbours, so 2 colors need optimism
+        G cycle;
+        std::vector< Node *> c;
+        for ( int i = 0; i < 4; i++)
+        {
+            c.push_back( &cycle.create_node());
+        }
+        for ( int i = 0; i < 4; i++)
+        {
+            cycle.create_edge( *c[ i], *c[ ( i + 1) % 4]);
+        }
+        cycle.create_edge( *c[ 1], *c[ 0]); // repeated in the other direction
+        cycle.create_edge( *c[ 2], *c[ 2]); // to itself
+
+        GraphColoring< G> two( cycle, 2);
+        UTEST_CHECK( utest_p, two.has_matrix() && two.degree( *c[ 0]) == 2 && two.degree( *c[ 2]) == 2);
+        UTEST_CHECK( utest_p, two.interferes( *c[ 0], *c[ 1]) && two.interferes( *c[ 1], *c[ 0])
+                              && !two.interferes( *c[ 0], *c[ 2]) && !two.interferes( *c[ 2], *c[ 2]));
+        UTEST_CHECK( utest_p, two.color() == 0 && two.num_spill_candidates() > 0 && isProperColoring( cycle, two));
+        UTEST_CHECK( utest_p, two.color_of( *c[ 0]) == two.color_of( *c[ 2]));
+
+        //--- Clique of 5 nodes with 4 colors: one node is spilled, the cheapest one
+        G clique;
+        std::vector< Node *> q;
+        for ( int i = 0; i < 5; i++)
+        {
+            q.push_back( &clique.create_node());
+        }
+        for ( int i = 0; i < 5; i++)
+        {
+            for ( int j = i + 1; j < 5; j++)
+            {
+                clique.create_edge( *q[ i], *q[ j]);
+            }
+        }
+        GraphColoring< G> four( clique, 4);
+        for ( int i = 0; i < 5; i++)
+        {
+            four.set_spill_cost( *q[ i], i == 3 ? 0.5f : 10.0f);
+        }
+        UTEST_CHECK( utest_p, four.color() == 1 && four.is_spilled( *q[ 3]) && isProperColoring( clique, four));
+
+        clique.create_edge( *q[ 0], *q[ 1]);
+        UTEST_CHECK( utest_p, !four.valid());
+
+        //--- Random graphs with and without the bit matrix against sets of pairs
+        UInt32 state = 12345;
+        bool same = true;
+        bool proper = true;
+        for ( int round = 0; round < 6; round++)
+        {
+            G rnd;
+            std::vector< Node *> rn;
+            UInt32 num = round < 3 ? 300 : GraphColoring< G>::MATRIX_MAX_NODES + 1000;
+
+            for ( UInt32 i = 0; i < num; i++)
+            {
+                rn.push_back( &rnd.create_node());
+            }
+            std::set< std::pair< UInt32, UInt32> > pairs;
+            for ( UInt32 i = 0; i < num * 4; i++)
+            {
+                state = state * 1103515245 + 12345;
+                UInt32 a = ( state >> 8) % num;
+                state = state * 1103515245 + 12345;
+                UInt32 b = ( state >> 8) % num;
+
+                rnd.create_edge( *rn[ a], *rn[ b]);
+                if ( a != b)
+                {
+                    pairs.insert( std::make_pair( a, b));
+                    pairs.insert( std::make_pair( b, a));
+                }
+            }
+
+            GraphColoring< G> coloring( rnd, 3 + round % 3 * 2);
+            same = same && coloring.has_matrix() == ( round < 3);
+            // Random pairs and pairs with the first neighbour of a random node
+            for ( UInt32 i = 0; i < num * 8; i++)
+            {
+                state = state * 1103515245 + 12345;
+                UInt32 a = ( state >> 8) % num;
+                state = state * 1103515245 + 12345;
+                UInt32 b = ( state >> 8) % num;
+                auto first = pairs.lower_bound( std::make_pair( a, 0));
+
+                if ( i % 2 == 0 && first != pairs.end() && first->first == a)
+                    b = first->second;
+                same = same && coloring.interferes( *rn[ a], *rn[ b]) == ( pairs.count( std::make_pair( a, b)) == 1);
+            }
+            for ( UInt32 i = 0; i < num; i++)
+            {
+                auto from = pairs.lower_bound( std::make_pair( i, 0));
+                auto to = pairs.lower_bound( std::make_pair( i + 1, 0));
+                same = same && coloring.degree( *rn[ i]) == ( UInt32)std::distance( from, to);
+            }
+            coloring.color();
+            proper = proper && isProperColoring( rnd, coloring);
+        }
+        UTEST_CHECK( utest_p, same);
+        UTEST_CHECK( utest_p, proper);
+
+        return utest_p->result();
+    }
+};
@@ -0,0 +1,894 @@
+/**
+ * @file: task/perf.cpp
+ * Performance measurements of the task 2 graph
+ */
+#include "iface.h"
+#include <unordered_map>
+#include <set>
+
+namespace Task
+{
+    // Number of nodes in the measured graphs
+#ifdef _DEBUG
+    static const UInt32 PERF_GRAPH_SIZE = 100000;
+#else
+    static const UInt32 PERF_GRAPH_SIZE = 1000000;
+#endif
+
+    struct PerfNode;
+    struct PerfEdge;
+    typedef Graph< PerfNode, PerfEdge> PerfGraph;
+
+    struct PerfNode: public PerfGraph::Node
+    {
+        UInt32 weight;
+        PerfNode( PerfGraph& g): PerfGraph::Node( g), weight( 0){}
+    };
+
+    struct PerfEdge: public PerfGraph::Edge
+    {
+        UInt32 weight;
+        PerfEdge( PerfNode& p, PerfNode& s): PerfGraph::Edge( p, s), weight( 0){}
+    };
+
+    // The same graph with nodes and edges allocated one by one on the heap
+    struct HeapNode;
+    struct HeapEdge;
+    typedef Graph< HeapNode, HeapEdge, GraphHeap> HeapGraph;
+
+    struct HeapNode: public HeapGraph::Node
+    {
+        UInt32 weight;
+        HeapNode( HeapGraph& g): HeapGraph::Node( g), weight( 0){}
+    };
+
+    struct HeapEdge: public HeapGraph::Edge
+    {
+        UInt32 weight;
+        HeapEdge( HeapNode& p, HeapNode& s): HeapGraph::Edge( p, s), weight( 0){}
+    };
+
+    // Simple xorshift generator to get the same graphs in every run
+    static UInt32 nextRandom( UInt32& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    //
+    // CFG-like shape: node i falls through to node i + 1 and every other node
+    // also branches to a random node, so there are about 1.5 edges per node
+    //
+    template < class Build> static void buildCfg( UInt32 num, Build& build)
+    {
+        UInt32 state = 2463534242u;
+
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            build.node();
+        }
+        for ( UInt32 i = 0; i + 1 < num; i++)
+        {
+            build.edge( i, i + 1);
+            if ( i % 2 == 0)
+                build.edge( i, nextRandom( state) % num);
+        }
+    }
+
+    // CFG with branches going not farther than LOCAL_BRANCH nodes in both directions,
+    // which gives nested diamonds and loops like in real functions
+    static const UInt32 LOCAL_BRANCH = 32;
+
+    template < class Build> static void buildLocalCfg( UInt32 num, Build& build)
+    {
+        UInt32 state = 2463534242u;
+
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            build.node();
+        }
+        for ( UInt32 i = 0; i + 1 < num; i++)
+        {
+            build.edge( i, i + 1);
+            if ( i % 2 == 0)
+            {
+                UInt32 target = i + nextRandom( state) % ( 2 * LOCAL_BRANCH);
+                build.edge( i, ( target < LOCAL_BRANCH + 1 ? 1 : std::min( target - LOCAL_BRANCH, num - 1)));
+            }
+        }
+    }
+
+    // Region of a structured CFG: a block, an if-else, a while loop or a sequence of two regions,
+    // nested not deeper than STRUCT_DEPTH. Returns the exit node of the region
+    static const UInt32 STRUCT_DEPTH = 4;
+
+    template < class Build> static UInt32 buildRegion( Build& build, UInt32& state, UInt32 entry, UInt32 depth)
+    {
+        UInt32 kind = depth < STRUCT_DEPTH ? nextRandom( state) % 4 : 0;
+
+        if ( kind == 1)
+        {
+            UInt32 then_exit = buildRegion( build, state, entry, depth + 1);
+            UInt32 else_exit = buildRegion( build, state, entry, depth + 1);
+            UInt32 join = build.node();
+
+            build.edge( then_exit, join);
+            build.edge( else_exit, join);
+            return join;
+        } else if ( kind == 2)
+        {
+            UInt32 header = build.node();
+            build.edge( entry, header);
+
+            UInt32 body_exit = buildRegion( build, state, header, depth + 1);
+            UInt32 exit = build.node();
+
+            build.edge( body_exit, header);
+            build.edge( header, exit);
+            return exit;
+        } else if ( kind == 3)
+        {
+            return buildRegion( build, state, buildRegion( build, state, entry, depth + 1), depth + 1);
+        }
+        UInt32 block = build.node();
+        build.edge( entry, block);
+        return block;
+    }
+
+    template < class Build> static void buildStructuredCfg( UInt32 num, Build& build)
+    {
+        UInt32 state = 2463534242u;
+        UInt32 exit = build.node();
+
+        while ( build.nodes.size() < num)
+        {
+            exit = buildRegion( build, state, exit, 0);
+        }
+    }
+
+    template < class G> struct GraphBuild
+    {
+        G& graph;
+        std::vector< typename G::NodeType *> nodes;
+
+        GraphBuild( G& g): graph( g){}
+        UInt32 node() { nodes.push_back( &graph.create_node()); return (UInt32)nodes.size() - 1; }
+        void edge( UInt32 p, UInt32 s) { graph.create_edge( *nodes[ p], *nodes[ s]); }
+    };
+
+    typedef GraphBuild< PerfGraph> PerfGraphBuild;
+
+    // Build the CFG and delete it, returns the number of edges
+    template < class G> static UInt32 measureBuild( UnitTest *utest_p, UInt32& t_build, UInt32& t_teardown)
+    {
+        Timer timer( true);
+        G *graph = new G;
+        GraphBuild< G> build( *graph);
+
+        buildCfg( PERF_GRAPH_SIZE, build);
+        t_build = timer.elapsedUSec();
+        UInt32 num_edges = graph->num_edges();
+        UTEST_CHECK( utest_p, graph->num_nodes() == PERF_GRAPH_SIZE);
+
+        timer.start();
+        delete graph;
+        t_teardown = timer.elapsedUSec();
+        return num_edges;
+    }
+
+    bool uTestPerf( UnitTest *utest_p)
+    {
+        UInt32 t_build, t_teardown;
+        UInt32 t_heap_build, t_heap_teardown;
+        UInt32 num_edges = measureBuild< PerfGraph>( utest_p, t_build, t_teardown);
+
+        UTEST_CHECK( utest_p, measureBuild< HeapGraph>( utest_p, t_heap_build, t_heap_teardown) == num_edges);
+
+        // Edges of a node with a large degree removed in the order of creation, the oldest
+        // edge is the last one in the adjacency lists
+        UInt32 t_hub;
+        {
+            const UInt32 hub_degree = PERF_GRAPH_SIZE / 10;
+            PerfGraph graph;
+            PerfNode& hub = graph.create_node();
+            std::vector< PerfEdge *> edges;
+
+            for ( UInt32 i = 0; i < hub_degree; i++)
+            {
+                edges.push_back( &graph.create_edge( graph.create_node(), hub));
+            }
+            Timer timer( true);
+            for ( UInt32 i = 0; i < hub_degree; i++)
+            {
+                graph.remove( *edges[ i]);
+            }
+            t_hub = timer.elapsedUSec();
+            UTEST_CHECK( utest_p, hub.num_preds() == 0 && graph.num_edges() == 0);
+        }
+
+        // Per-node data kept in a side table against a hash map keyed by node ids
+        UInt32 t_map, t_hash;
+        {
+            PerfGraph graph;
+            PerfGraphBuild build( graph);
+
+            buildCfg( PERF_GRAPH_SIZE, build);
+
+            UInt64 sum = 0;
+            Timer timer( true);
+            {
+                PerfGraph::NodeMap< UInt32> weights( graph);
+
+                for ( PerfGraph::node_iterator n = graph.nodes_begin(), end = graph.nodes_end(); n != end; ++n)
+                {
+                    weights[ *n] = n->uid() % 7;
+                }
+                for ( PerfGraph::edge_iterator e = graph.edges_begin(), end = graph.edges_end(); e != end; ++e)
+                {
+                    sum += weights[ e->pred()] + weights[ e->succ()];
+                }
+            }
+            t_map = timer.elapsedUSec();
+
+            UInt64 hash_sum = 0;
+            timer.start();
+            {
+                std::unordered_map< PerfGraph::UId, UInt32> weights;
+
+                for ( PerfGraph::node_iterator n = graph.nodes_begin(), end = graph.nodes_end(); n != end; ++n)
+                {
+                    weights[ n->uid()] = n->uid() % 7;
+                }
+                for ( PerfGraph::edge_iterator e = graph.edges_begin(), end = graph.edges_end(); e != end; ++e)
+                {
+                    hash_sum += weights[ e->pred().uid()] + weights[ e->succ().uid()];
+                }
+            }
+            t_hash = timer.elapsedUSec();
+            UTEST_CHECK( utest_p, sum == hash_sum);
+        }
+
+        utest_p->out() << endl << "    CFG of " << PERF_GRAPH_SIZE << " nodes and " << num_edges << " edges:"
+                       << endl << "    pooled Graph   build " << std::setw( 8) << t_build << " uSec,"
+                       << " teardown " << std::setw( 8) << t_teardown << " uSec"
+                       << endl << "    heap Graph     build " << std::setw( 8) << t_heap_build << " uSec,"
+                       << " teardown " << std::setw( 8) << t_heap_teardown << " uSec"
+                       << endl << "    removal of " << PERF_GRAPH_SIZE / 10 << " edges of one node "
+                       << std::setw( 8) << t_hub << " uSec"
+                       << endl << "    node values    NodeMap " << std::setw( 8) << t_map << " uSec,"
+                       << " unordered_map " << std::setw( 8) << t_hash << " uSec" << endl;
+        return utest_p->result();
+    }
+
+    // Breadth-first walk from the node over the edge lists, returns the sum of visit positions
+    static UInt64 bfsGraph( PerfGraph& graph, PerfNode& start)
+    {
+        std::vector< char> visited( graph.node_uid_limit(), 0);
+        std::vector< PerfNode *> queue;
+        UInt64 sum = 0;
+
+        queue.reserve( graph.num_nodes());
+        queue.push_back( &start);
+        visited[ start.uid()] = 1;
+        for ( size_t head = 0; head < queue.size(); head++)
+        {
+            PerfNode *n = queue[ head];
+
+            sum += head * n->uid();
+            for ( PerfGraph::Node::succ_iterator e = n->succs_begin(), end = n->succs_end(); e != end; ++e)
+            {
+                PerfNode& succ = e->succ();
+                if ( !visited[ succ.uid()])
+                {
+                    visited[ succ.uid()] = 1;
+                    queue.push_back( &succ);
+                }
+            }
+        }
+        return sum;
+    }
+
+    // Breadth-first walk over the CSR arrays
+    static UInt64 bfsCsr( const CsrView< PerfGraph>& csr, PerfGraph::UId start)
+    {
+        std::vector< char> visited( csr.node_uid_limit(), 0);
+        std::vector< PerfGraph::UId> queue;
+        UInt64 sum = 0;
+
+        queue.reserve( csr.node_uid_limit());
+        queue.push_back( start);
+        visited[ start] = 1;
+        for ( size_t head = 0; head < queue.size(); head++)
+        {
+            PerfGraph::UId n = queue[ head];
+
+            sum += head * n;
+            for ( CsrView< PerfGraph>::iterator s = csr.succs_begin( n), end = csr.succs_end( n); s != end; ++s)
+            {
+                if ( !visited[ *s])
+                {
+                    visited[ *s] = 1;
+                    queue.push_back( *s);
+                }
+            }
+        }
+        return sum;
+    }
+
+    // Depth-first walk with an explicit stack over the edge lists, returns the sum of visit positions
+    static UInt64 dfsGraph( PerfGraph& graph, PerfNode& start)
+    {
+        std::vector< char> visited( graph.node_uid_limit(), 0);
+        std::vector< PerfNode *> stack;
+        UInt64 sum = 0;
+        UInt64 pos = 0;
+
+        stack.push_back( &start);
+        while ( !stack.empty())
+        {
+            PerfNode *n = stack.back();
+            stack.pop_back();
+            if ( visited[ n->uid()])
+                continue;
+            visited[ n->uid()] = 1;
+            sum += ( pos++) * n->uid();
+            for ( PerfGraph::Node::succ_iterator e = n->succs_begin(), end = n->succs_end(); e != end; ++e)
+            {
+                if ( !visited[ e->succ().uid()])
+                    stack.push_back( &e->succ());
+            }
+        }
+        return sum;
+    }
+
+    // Depth-first walk over the CSR arrays
+    static UInt64 dfsCsr( const CsrView< PerfGraph>& csr, PerfGraph::UId start)
+    {
+        std::vector< char> visited( csr.node_uid_limit(), 0);
+        std::vector< PerfGraph::UId> stack;
+        UInt64 sum = 0;
+        UInt64 pos = 0;
+
+        stack.push_back( start);
+        while ( !stack.empty())
+        {
+            PerfGraph::UId n = stack.back();
+            stack.pop_back();
+            if ( visited[ n])
+                continue;
+            visited[ n] = 1;
+            sum += ( pos++) * n;
+            for ( CsrView< PerfGraph>::iterator s = csr.succs_begin( n), end = csr.succs_end( n); s != end; ++s)
+            {
+                if ( !visited[ *s])
+                    stack.push_back( *s);
+            }
+        }
+        return sum;
+    }
+
+    bool uTestCsrPerf( UnitTest *utest_p)
+    {
+        PerfGraph graph;
+        PerfGraphBuild build( graph);
+
+        buildCfg( PERF_GRAPH_SIZE, build);
+
+        PerfNode& start = *build.nodes[ 0];
+        Timer timer( true);
+        const CsrView< PerfGraph>& csr = graph.freeze();
+        UInt32 t_freeze = timer.elapsedUSec();
+
+        timer.start();
+        UInt64 bfs_sum = bfsGraph( graph, start);
+        UInt32 t_bfs = timer.elapsedUSec();
+        timer.start();
+        UInt64 bfs_csr_sum = bfsCsr( csr, start.uid());
+        UInt32 t_bfs_csr = timer.elapsedUSec();
+
+        timer.start();
+        UInt64 dfs_sum = dfsGraph( graph, start);
+        UInt32 t_dfs = timer.elapsedUSec();
+        timer.start();
+        UInt64 dfs_csr_sum = dfsCsr( csr, start.uid());
+        UInt32 t_dfs_csr = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, bfs_sum == bfs_csr_sum && dfs_sum == dfs_csr_sum);
+
+        utest_p->out() << endl << "    CFG of " << PERF_GRAPH_SIZE << " nodes, freeze " << t_freeze << " uSec:"
+                       << endl << "    BFS  Graph " << std::setw( 8) << t_bfs << " uSec,"
+                       << " CsrView " << std::setw( 8) << t_bfs_csr << " uSec"
+                       << endl << "    DFS  Graph " << std::setw( 8) << t_dfs << " uSec,"
+                       << " CsrView " << std::setw( 8) << t_dfs_csr << " uSec" << endl;
+        return utest_p->result();
+    }
+
+    bool uTestTraversalPerf( UnitTest *utest_p)
+    {
+        PerfGraph graph;
+        PerfGraphBuild build( graph);
+
+        buildCfg( PERF_GRAPH_SIZE, build);
+
+        PerfNode& start = *build.nodes[ 0];
+
+        // Depth-first walk with a set of visited ids, the way passes do it without markers
+        Timer timer( true);
+        UInt32 num_set = 0;
+        {
+            std::set< PerfGraph::UId> visited;
+            std::vector< PerfNode *> stack;
+
+            stack.push_back( &start);
+            while ( !stack.empty())
+            {
+                PerfNode *n = stack.back();
+                stack.pop_back();
+                if ( !visited.insert( n->uid()).second)
+                    continue;
+                num_set++;
+                for ( PerfGraph::Node::succ_iterator e = n->succs_begin(), end = n->succs_end(); e != end; ++e)
+                {
+                    if ( visited.find( e->succ().uid()) == visited.end())
+                        stack.push_back( &e->succ());
+                }
+            }
+        }
+        UInt32 t_set = timer.elapsedUSec();
+
+        timer.start();
+        UInt32 num_dfs = 0;
+        for ( DfsIterator< PerfGraph> it( graph, start); !it.done(); ++it)
+        {
+            num_dfs++;
+        }
+        UInt32 t_dfs = timer.elapsedUSec();
+
+        timer.start();
+        UInt32 num_rpo = RpoIterator< PerfGraph>( graph, start).size();
+        UInt32 t_rpo = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, num_set == num_dfs && num_rpo == num_dfs);
+
+        // A chain is the deepest graph for a depth-first walk and has a topological order
+        PerfGraph chain;
+        PerfNode *prev = &chain.create_node();
+        PerfNode& head = *prev;
+        for ( UInt32 i = 1; i < PERF_GRAPH_SIZE; i++)
+        {
+            PerfNode& n = chain.create_node();
+            chain.create_edge( *prev, n);
+            prev = &n;
+        }
+
+        timer.start();
+        UInt32 num_post = 0;
+        for ( PostOrderIterator< PerfGraph> it( chain, head); !it.done(); ++it)
+        {
+            num_post++;
+        }
+        UInt32 t_post = timer.elapsedUSec();
+
+        timer.start();
+        UInt32 num_topo = 0;
+        TopoIterator< PerfGraph> topo( chain);
+        for ( ; !topo.done(); ++topo)
+        {
+            num_topo++;
+        }
+        UInt32 t_topo = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, num_post == PERF_GRAPH_SIZE && num_topo == PERF_GRAPH_SIZE && !topo.has_cycle());
+
+        utest_p->out() << endl << "    CFG of " << PERF_GRAPH_SIZE << " nodes, " << num_dfs << " reachable:"
+                       << endl << "    DFS with std::set " << std::setw( 8) << t_set << " uSec,"
+                       << " DfsIterator " << std::setw( 8) << t_dfs << " uSec, RPO " << std::setw( 8) << t_rpo << " uSec"
+                       << endl << "    chain of " << PERF_GRAPH_SIZE << " nodes:"
+                       << endl << "    post-order " << std::setw( 8) << t_post << " uSec,"
+                       << " topological order " << std::setw( 8) << t_topo << " uSec" << endl;
+        return utest_p->result();
+    }
+
+    bool uTestDomPerf( UnitTest *utest_p)
+    {
+        static const UInt32 NUM_QUERIES = 1000000;
+
+        for ( UInt32 size = PERF_GRAPH_SIZE / 10; size <= PERF_GRAPH_SIZE; size *= 10)
+        {
+            PerfGraph graph;
+            PerfGraphBuild build( graph);
+
+            buildCfg( size, build);
+
+            Timer timer( true);
+            DomTree< PerfGraph> dom( graph, *build.nodes[ 0]);
+            UInt32 t_build = timer.elapsedUSec();
+
+            // The same queries answered by the intervals and by walking up the immediate dominators
+            UInt32 state = 2463534242u;
+            std::vector< PerfNode *> queries;
+            queries.reserve( 2 * NUM_QUERIES);
+            for ( UInt32 i = 0; i < 2 * NUM_QUERIES; i++)
+            {
+                queries.push_back( build.nodes[ nextRandom( state) % size]);
+            }
+
+            timer.start();
+            UInt32 num_dominated = 0;
+            for ( UInt32 i = 0; i < NUM_QUERIES; i++)
+            {
+                if ( dom.dominates( *queries[ 2 * i], *queries[ 2 * i + 1]))
+                    num_dominated++;
+            }
+            UInt32 t_query = timer.elapsedUSec();
+
+            timer.start();
+            UInt32 num_walked = 0;
+            UInt64 max_level = 0;
+            for ( UInt32 i = 0; i < NUM_QUERIES; i++)
+            {
+                PerfNode *a = queries[ 2 * i];
+                PerfNode *b = queries[ 2 * i + 1];
+
+                while ( isNotNullP( b) && b != a)
+                {
+                    b = dom.idom( *b);
+                }
+                if ( isNotNullP( b))
+                    num_walked++;
+            }
+            UInt32 t_walk = timer.elapsedUSec();
+
+            for ( PerfGraph::UId i = 0; i < size; i++)
+            {
+                max_level = std::max< UInt64>( max_level, dom.level( *build.nodes[ i]));
+            }
+
+            UTEST_CHECK( utest_p, num_dominated == num_walked && dom.num_reachable_nodes() == size);
+
+            utest_p->out() << endl << "    CFG of " << size << " nodes, tree depth " << max_level << ":"
+                           << endl << "    dominator tree " << std::setw( 8) << t_build << " uSec,"
+                           << " " << NUM_QUERIES << " dominates() " << std::setw( 8) << t_query << " uSec,"
+                           << " walking idoms " << std::setw( 8) << t_walk << " uSec" << endl;
+        }
+        return utest_p->result();
+    }
+
+    bool uTestDfPerf( UnitTest *utest_p)
+    {
+        static const UInt32 NUM_VARS = 2000;
+        static const UInt32 DEFS_PER_VAR = 8;
+        static const UInt32 VAR_REGION = 1000;
+
+        PerfGraph graph;
+        PerfGraphBuild build( graph);
+
+        buildLocalCfg( PERF_GRAPH_SIZE, build);
+
+        DomTree< PerfGraph> dom( graph, *build.nodes[ 0]);
+
+        Timer timer( true);
+        DomFrontier< PerfGraph> df( dom);
+        UInt32 t_df = timer.elapsedUSec();
+
+        // Every variable is defined in a region of the function
+        UInt32 state = 2463534242u;
+        std::vector< std::vector< PerfNode *> > defs( NUM_VARS);
+        for ( UInt32 v = 0; v < NUM_VARS; v++)
+        {
+            UInt32 region = nextRandom( state) % ( PERF_GRAPH_SIZE - VAR_REGION);
+
+            for ( UInt32 k = 0; k < DEFS_PER_VAR; k++)
+            {
+                defs[ v].push_back( build.nodes[ region + nextRandom( state) % VAR_REGION]);
+            }
+        }
+
+        timer.start();
+        std::vector< std::vector< PerfNode *> > phis;
+        df.place_phis( defs, phis);
+        UInt32 t_batch = timer.elapsedUSec();
+
+        // Per-variable union of the frontiers of the definitions and of the phis found so far
+        timer.start();
+        UInt64 naive_num = 0;
+        for ( UInt32 v = 0; v < NUM_VARS; v++)
+        {
+            std::set< PerfGraph::UId> var_phis;
+            std::set< PerfGraph::UId> defined;
+            std::vector< PerfNode *> worklist( defs[ v].begin(), defs[ v].end());
+
+            for ( UInt32 k = 0; k < DEFS_PER_VAR; k++)
+            {
+                defined.insert( defs[ v][ k]->uid());
+            }
+            while ( !worklist.empty())
+            {
+                PerfNode *x = worklist.back();
+                worklist.pop_back();
+                for ( DomFrontier< PerfGraph>::iterator it = df.frontier_begin( *x), end = df.frontier_end( *x); it != end; ++it)
+                {
+                    if ( var_phis.insert( ( *it)->uid()).second && defined.find( ( *it)->uid()) == defined.end())
+                        worklist.push_back( *it);
+                }
+            }
+            naive_num += var_phis.size();
+        }
+        UInt32 t_naive = timer.elapsedUSec();
+
+        UInt64 num = 0;
+        for ( UInt32 v = 0; v < NUM_VARS; v++)
+        {
+            num += phis[ v].size();
+        }
+        UTEST_CHECK( utest_p, num == naive_num);
+
+        utest_p->out() << endl << "    local CFG of " << PERF_GRAPH_SIZE << " nodes, " << NUM_VARS << " variables with "
+                       << DEFS_PER_VAR << " definitions, " << num << " phis:"
+                       << endl << "    frontiers " << std::setw( 8) << t_df << " uSec,"
+                       << " DJ graph batch " << std::setw( 8) << t_batch << " uSec,"
+                       << " frontier union " << std::setw( 8) << t_naive << " uSec" << endl;
+        return utest_p->result();
+    }
+
+    // Components and loops of one graph
+    static void measureScc( UnitTest *utest_p, const char *name, PerfGraph& graph, PerfNode& entry)
+    {
+        Timer timer( true);
+        SccInfo< PerfGraph> scc( graph);
+        UInt32 t_scc = timer.elapsedUSec();
+
+        timer.start();
+        DomTree< PerfGraph> dom( graph, entry);
+        UInt32 t_dom = timer.elapsedUSec();
+
+        timer.start();
+        LoopForest< PerfGraph> loops( dom);
+        UInt32 t_loops = timer.elapsedUSec();
+
+        UInt32 max_comp = 0;
+        for ( UInt32 c = 0; c < scc.num_components(); c++)
+        {
+            max_comp = std::max( max_comp, scc.num_members( c));
+        }
+        UInt32 max_depth = 0;
+        for ( UInt32 l = 0; l < loops.num_loops(); l++)
+        {
+            max_depth = std::max( max_depth, loops.depth( l));
+        }
+        UTEST_CHECK( utest_p, max_comp <= graph.num_nodes());
+
+        utest_p->out() << endl << "    " << name << " of " << graph.num_nodes() << " nodes:"
+                       << endl << "    SCC    " << std::setw( 8) << t_scc << " uSec, " << std::setw( 8) << scc.memory_size() / 1024
+                       << " KB, " << scc.num_components() << " components, largest " << max_comp
+                       << endl << "    loops  " << std::setw( 8) << t_loops << " uSec, " << std::setw( 8) << loops.memory_size() / 1024
+                       << " KB, " << loops.num_loops() << " loops, depth " << max_depth
+                       << " (dominator tree " << t_dom << " uSec)" << endl;
+    }
+
+    bool uTestSccPerf( UnitTest *utest_p)
+    {
+        {
+            PerfGraph graph;
+            PerfGraphBuild build( graph);
+
+            buildCfg( PERF_GRAPH_SIZE, build);
+            measureScc( utest_p, "CFG", graph, *build.nodes[ 0]);
+        }
+        {
+            PerfGraph graph;
+            PerfGraphBuild build( graph);
+
+            buildLocalCfg( PERF_GRAPH_SIZE, build);
+            measureScc( utest_p, "local CFG", graph, *build.nodes[ 0]);
+        }
+        {
+            PerfGraph chain;
+            PerfNode *prev = &chain.create_node();
+            PerfNode& head = *prev;
+            for ( UInt32 i = 1; i < PERF_GRAPH_SIZE; i++)
+            {
+                PerfNode& n = chain.create_node();
+                chain.create_edge( *prev, n);
+                prev = &n;
+            }
+            chain.create_edge( *prev, head);
+            measureScc( utest_p, "cycle", chain, head);
+        }
+        return utest_p->result();
+    }
+
+    // Problem with a few random facts generated and killed by every node
+    struct PerfProblem: public DataflowProblem< PerfGraph>
+    {
+        static const UInt32 FACTS_PER_NODE = 4;
+
+        PerfProblem( DataflowDirection dir, DataflowMeet m, UInt32 facts):
+            DataflowProblem< PerfGraph>( dir, m, facts){}
+
+        void init( PerfNode& n, DataflowBits gen, DataflowBits kill)
+        {
+            UInt32 state = n.uid() * 2654435761u + 1;
+
+            for ( UInt32 i = 0; i < FACTS_PER_NODE; i++)
+            {
+                gen.set( nextRandom( state) % num_facts());
+                kill.set( nextRandom( state) % num_facts());
+            }
+        }
+    };
+
+    static void measureDataflow( UnitTest *utest_p, const char *name, PerfGraph& graph, PerfNode& entry, PerfProblem& problem)
+    {
+        Timer timer( true);
+        DataflowSolver< PerfGraph, PerfProblem> solver( graph, entry, problem);
+        UInt32 t_init = timer.elapsedUSec();
+
+        timer.start();
+        solver.solve();
+        UInt32 t_solve = timer.elapsedUSec();
+
+        UTEST_CHECK( utest_p, solver.num_sweeps() >= 1);
+
+        utest_p->out() << "    " << std::setw( 22) << std::left << name << std::right
+                       << " init " << std::setw( 8) << t_init << " uSec, solve " << std::setw( 8) << t_solve << " uSec, "
+                       << solver.num_sweeps() << " sweeps, " << solver.num_evaluations() << " transfers, "
+                       << solver.memory_size() / ( 1024 * 1024) << " MB" << endl;
+    }
+
+    bool uTestDataflowPerf( UnitTest *utest_p)
+    {
+        static const UInt32 NUM_FACTS = 10000;
+
+        PerfGraph graph;
+        PerfGraphBuild build( graph);
+
+        buildStructuredCfg( PERF_GRAPH_SIZE / 10, build);
+
+        utest_p->out() << endl << "    structured CFG of " << graph.num_nodes() << " nodes, " << NUM_FACTS << " facts:" << endl;
+
+        PerfProblem live( DATAFLOW_BACKWARD, DATAFLOW_UNION, NUM_FACTS);
+        measureDataflow( utest_p, "backward union", graph, *build.nodes[ 0], live);
+
+        PerfProblem avail( DATAFLOW_FORWARD, DATAFLOW_INTERSECTION, NUM_FACTS);
+        measureDataflow( utest_p, "forward intersection", graph, *build.nodes[ 0], avail);
+
+        PerfProblem reach( DATAFLOW_FORWARD, DATAFLOW_UNION, NUM_FACTS);
+        measureDataflow( utest_p, "forward union", graph, *build.nodes[ 0], reach);
+
+        // Overlapping unstructured loops need a sweep for every loop a fact goes around, a fact
+        // climbs one back edge of at most LOCAL_BRANCH nodes per sweep. The time goes to
+        // the transfers, each one streams the state rows of the node through memory
+        PerfGraph local;
+        PerfGraphBuild local_build( local);
+
+        buildLocalCfg( PERF_GRAPH_SIZE / 10, local_build);
+        utest_p->out() << "    local CFG of " << local.num_nodes() << " nodes:" << endl;
+        measureDataflow( utest_p, "backward union", local, *local_build.nodes[ 0], live);
+
+        return utest_p->result();
+    }
+
+    // Live ranges of values defined one after another, mostly short with some long ones,
+    // every two overlapping ranges interfere
+    static void buildInterference( UInt32 num, PerfGraphBuild& build)
+    {
+        UInt32 state = 12345;
+        std::vector< std::pair< UInt32, UInt32> > live; // end of the range and the node
+
+        for ( UInt32 i = 0; i < num; i++)
+        {
+            UInt32 n = build.node();
+            UInt32 len = 1 + nextRandom( state) % 32;
+
+            if ( nextRandom( state) % 100 == 0)
+                len += nextRandom( state) % 500;
+
+            UInt32 k = 0;
+            for ( UInt32 j = 0; j < live.size(); j++)
+            {
+                if ( live[ j].first <= i)
+                    continue;
+                build.edge( live[ j].second, n);
+                live[ k++] = live[ j];
+            }
+            live.resize( k);
+            live.push_back( std::make_pair( i + len, n));
+        }
+    }
+
+    typedef std::set< std::pair< UInt32, UInt32> > PairSet;
+
+    static void measureColoring( UnitTest *utest_p, PerfGraph& graph, std::vector< PerfNode *>& nodes,
+                                 const PairSet& pairs, UInt32 k)
+    {
+        Timer timer( true);
+        GraphColoring< PerfGraph> coloring( graph, k);
+        UInt32 t_build = timer.elapsedUSec();
+
+        timer.start();
+        coloring.color();
+        UInt32 t_color = timer.elapsedUSec();
+
+        bool proper = true;
+        for ( PerfGraph::edge_iterator e = graph.edges_begin(), end = graph.edges_end(); e != end; ++e)
+        {
+            UInt32 c = coloring.color_of( e->pred());
+            proper = proper && ( c == GraphColoring< PerfGraph>::NO_COLOR || c != coloring.color_of( e->succ()));
+        }
+        UTEST_CHECK( utest_p, proper);
+
+        // Queries of random pairs against the set of the pairs
+        static const UInt32 NUM_QUERIES = 250000;
+        UInt32 num = (UInt32)nodes.size();
+        UInt32 state = 777;
+        UInt32 found = 0;
+        timer.start();
+        for ( UInt32 i = 0; i < NUM_QUERIES; i++)
+        {
+            // Near pairs interfere often, far ones almost never
+            UInt32 a = nextRandom( state) % num;
+            UInt32 b = i % 2 ? nextRandom( state) % num : ( a + nextRandom( state) % 32) % num;
+
+            found += coloring.interferes( *nodes[ a], *nodes[ b]);
+        }
+        UInt32 t_query = timer.elapsedUSec();
+
+        state = 777;
+        UInt32 ref_found = 0;
+        timer.start();
+        for ( UInt32 i = 0; i < NUM_QUERIES; i++)
+        {
+            UInt32 a = nextRandom( state) % num;
+            UInt32 b = i % 2 ? nextRandom( state) % num : ( a + nextRandom( state) % 32) % num;
+
+            ref_found += (UInt32)pairs.count( std::make_pair( nodes[ a]->uid(), nodes[ b]->uid()));
+        }
+        UInt32 t_ref_query = timer.elapsedUSec();
+        UTEST_CHECK( utest_p, found == ref_found);
+
+        utest_p->out() << endl << "    " << graph.num_nodes() << " nodes, " << graph.num_edges() << " interferences, "
+                       << k << " colors, " << ( coloring.has_matrix() ? "with" : "without") << " bit matrix:"
+                       << endl << "    build  " << std::setw( 8) << t_build << " uSec, " << std::setw( 8)
+                       << coloring.memory_size() / 1024 << " KB"
+                       << endl << "    color  " << std::setw( 8) << t_color << " uSec, " << coloring.num_spill_candidates()
+                       << " spill candidates, " << coloring.num_spilled() << " spilled"
+                       << endl << "    " << NUM_QUERIES << " interferes() " << std::setw( 8) << t_query << " uSec,"
+                       << " std::set " << std::setw( 8) << t_ref_query << " uSec" << endl;
+    }
+
+    static void collectPairs( PerfGraph& graph, PairSet& pairs)
+    {
+        for ( PerfGraph::edge_iterator e = graph.edges_begin(), end = graph.edges_end(); e != end; ++e)
+        {
+            pairs.insert( std::make_pair( e->pred().uid(), e->succ().uid()));
+            pairs.insert( std::make_pair( e->succ().uid(), e->pred().uid()));
+        }
+    }
+
+    bool uTestColorPerf( UnitTest *utest_p)
+    {
+        {
+            PerfGraph graph;
+            PerfGraphBuild build( graph);
+            PairSet pairs;
+
+            buildInterference( PERF_GRAPH_SIZE / 10, build);
+            collectPairs( graph, pairs);
+            measureColoring( utest_p, graph, build.nodes, pairs, 16);
+            measureColoring( utest_p, graph, build.nodes, pairs, 32);
+        }
+        {
+            PerfGraph graph;
+            PerfGraphBuild build( graph);
+            PairSet pairs;
+
+            buildInterference( GraphColoring< PerfGraph>::MATRIX_MAX_NODES, build);
+            collectPairs( graph, pairs);
+            measureColoring( utest_p, graph, build.nodes, pairs, 16);
+        }
+        return utest_p->result();
+    }
+};